@@ -0,0 +1,68 @@
+#include <memory>
+#include <thread>
+#include "adsl/segtree/atomic_fenwick_tree.hpp"
+#include "common.hpp"
+#include "monoids.hpp"
+
+namespace adsl_bench {
+
+    namespace {
+        template <typename Values, std::size_t Stripes>
+        using tree_type = adsl::atomic_fenwick_tree<typename Values::monoid, Stripes>;
+
+        // every thread of the benchmark appends to one tree, which thread 0 builds before the timed loop starts
+        template <typename Values, std::size_t Stripes>
+        void append(benchmark::State& state, access_pattern p, std::size_t n) {
+            static std::unique_ptr<tree_type<Values, Stripes>> tree;
+            if (state.thread_index() == 0)
+                tree = std::make_unique<tree_type<Values, Stripes>>(make_values<Values>(n, n));
+
+            const auto seed = n + static_cast<u64>(state.thread_index()) * ring_size;
+            const auto idx = make_indices(p, n, seed + 1);
+            const auto val = make_values<Values>(ring_size, seed + 2);
+
+            std::size_t i = 0;
+            for (auto _ : state) {
+                tree->append_at(idx[i], val[i]);
+                i = (i + 1) & (ring_size - 1);
+            }
+
+            state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations()));
+            if (state.thread_index() == 0)
+                tree.reset();
+        }
+
+        template <typename Values, std::size_t Stripes>
+        void query(benchmark::State& state, access_pattern p, std::size_t n) {
+            const tree_type<Values, Stripes> tree(make_values<Values>(n, n));
+            const auto idx = make_indices(p, n, n + 1);
+
+            std::size_t i = 0;
+            for (auto _ : state) {
+                benchmark::DoNotOptimize(tree.accumulate(idx[i]));
+                i = (i + 1) & (ring_size - 1);
+            }
+
+            state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations()));
+        }
+
+        template <typename Values, std::size_t Stripes>
+        void register_for(const char* tree) {
+            const int max_threads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+
+            for (std::size_t n : sizes) {
+                for (access_pattern p : patterns) {
+                    add(bench_name(tree, Values::name, "append", p, n), [p, n](benchmark::State& state) { append<Values, Stripes>(state, p, n); })
+                        ->ThreadRange(1, max_threads)->UseRealTime();
+                    add(bench_name(tree, Values::name, "query", p, n), [p, n](benchmark::State& state) { query<Values, Stripes>(state, p, n); });
+                }
+            }
+        }
+    }
+
+    void register_atomic_fenwick_tree() {
+        register_for<sum_group_i64, 1>("atomic_fenwick_tree");
+        register_for<sum_group_i64, 4>("atomic_fenwick_tree_striped4");
+    }
+
+}
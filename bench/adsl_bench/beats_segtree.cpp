@@ -0,0 +1,87 @@
+#include "adsl/segtree/beats_segtree.hpp"
+#include "common.hpp"
+#include "monoids.hpp"
+
+namespace adsl_bench {
+
+    namespace {
+        using tree_type = adsl::beats_segtree<i64>;
+
+        void build(benchmark::State& state, std::size_t n) {
+            const auto src = make_values<sum_i64>(n, n);
+
+            for (auto _ : state) {
+                tree_type seg(src);
+                benchmark::DoNotOptimize(seg);
+            }
+
+            state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * n));
+        }
+
+        void chmin(benchmark::State& state, access_pattern p, std::size_t n) {
+            tree_type seg(make_values<sum_i64>(n, n));
+            const auto ranges = make_ranges(p, n, n + 1);
+            const auto val = make_values<sum_i64>(ring_size, n + 2);
+
+            std::size_t i = 0;
+            for (auto _ : state) {
+                seg.chmin(ranges[i].first, ranges[i].second, val[i]);
+                i = (i + 1) & (ring_size - 1);
+            }
+
+            state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations()));
+        }
+
+        // chmin, chmax and add in turn, so that the clamps keep finding distinct values to merge
+        void mixed(benchmark::State& state, access_pattern p, std::size_t n) {
+            tree_type seg(make_values<sum_i64>(n, n));
+            const auto ranges = make_ranges(p, n, n + 1);
+            const auto val = make_values<sum_i64>(ring_size, n + 2);
+
+            std::size_t i = 0;
+            for (auto _ : state) {
+                const auto [l, r] = ranges[i];
+                switch (i % 3) {
+                    case 0:
+                        seg.chmin(l, r, val[i]);
+                        break;
+                    case 1:
+                        seg.chmax(l, r, val[i]);
+                        break;
+                    default:
+                        seg.add(l, r, val[i] % 2001 - 1000);
+                        break;
+                }
+                i = (i + 1) & (ring_size - 1);
+            }
+
+            state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations()));
+        }
+
+        void query(benchmark::State& state, access_pattern p, std::size_t n) {
+            tree_type seg(make_values<sum_i64>(n, n));
+            const auto ranges = make_ranges(p, n, n + 1);
+
+            std::size_t i = 0;
+            for (auto _ : state) {
+                benchmark::DoNotOptimize(seg.sum(ranges[i].first, ranges[i].second));
+                i = (i + 1) & (ring_size - 1);
+            }
+
+            state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations()));
+        }
+    }
+
+    void register_beats_segtree() {
+        for (std::size_t n : sizes) {
+            add(bench_name("beats_segtree", "i64", "build", n), [n](benchmark::State& state) { build(state, n); });
+
+            for (access_pattern p : patterns) {
+                add(bench_name("beats_segtree", "i64", "chmin", p, n), [p, n](benchmark::State& state) { chmin(state, p, n); });
+                add(bench_name("beats_segtree", "i64", "mixed", p, n), [p, n](benchmark::State& state) { mixed(state, p, n); });
+                add(bench_name("beats_segtree", "i64", "query", p, n), [p, n](benchmark::State& state) { query(state, p, n); });
+            }
+        }
+    }
+
+}
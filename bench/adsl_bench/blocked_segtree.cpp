@@ -0,0 +1,71 @@
+#include "adsl/segtree/blocked_segtree.hpp"
+#include "common.hpp"
+#include "monoids.hpp"
+
+namespace adsl_bench {
+
+    namespace {
+        template <typename Values>
+        using tree_type = adsl::blocked_segtree<typename Values::monoid>;
+
+        template <typename Values>
+        void build(benchmark::State& state, std::size_t n) {
+            const auto src = make_values<Values>(n, n);
+
+            for (auto _ : state) {
+                tree_type<Values> seg(src);
+                benchmark::DoNotOptimize(seg);
+            }
+
+            state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * n));
+        }
+
+        template <typename Values>
+        void update(benchmark::State& state, access_pattern p, std::size_t n) {
+            tree_type<Values> seg(make_values<Values>(n, n));
+            const auto idx = make_indices(p, n, n + 1);
+            const auto val = make_values<Values>(ring_size, n + 2);
+
+            std::size_t i = 0;
+            for (auto _ : state) {
+                seg.set(idx[i], val[i]);
+                i = (i + 1) & (ring_size - 1);
+            }
+
+            state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations()));
+        }
+
+        template <typename Values>
+        void query(benchmark::State& state, access_pattern p, std::size_t n) {
+            const tree_type<Values> seg(make_values<Values>(n, n));
+            const auto ranges = make_ranges(p, n, n + 1);
+
+            std::size_t i = 0;
+            for (auto _ : state) {
+                benchmark::DoNotOptimize(seg.accumulate(ranges[i].first, ranges[i].second));
+                i = (i + 1) & (ring_size - 1);
+            }
+
+            state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations()));
+        }
+
+        template <typename Values>
+        void register_for() {
+            for (std::size_t n : sizes) {
+                add(bench_name("blocked_segtree", Values::name, "build", n), [n](benchmark::State& state) { build<Values>(state, n); });
+
+                for (access_pattern p : patterns) {
+                    add(bench_name("blocked_segtree", Values::name, "update", p, n), [p, n](benchmark::State& state) { update<Values>(state, p, n); });
+                    add(bench_name("blocked_segtree", Values::name, "query", p, n), [p, n](benchmark::State& state) { query<Values>(state, p, n); });
+                }
+            }
+        }
+    }
+
+    void register_blocked_segtree() {
+        // sum_group_i64 takes the patching update, min_i32 the rescanning one
+        register_for<sum_group_i64>();
+        register_for<min_i32>();
+    }
+
+}
@@ -0,0 +1,198 @@
+#ifndef ADSL_BENCH_COMMON_HPP
+#define ADSL_BENCH_COMMON_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cmath>
+#include <array>
+#include <vector>
+#include <string>
+#include <utility>
+#include <span>
+#include <tuple>
+#include <random>
+#include <algorithm>
+#include <benchmark/benchmark.h>
+
+namespace adsl_bench {
+
+    using i32 = std::int32_t;
+    using i64 = std::int64_t;
+    using u32 = std::uint32_t;
+    using u64 = std::uint64_t;
+
+    // the sizes every benchmark runs over; 2^k + 1 is the worst case of the power of two layouts
+    inline constexpr std::array<std::size_t, 5> sizes = { std::size_t{1} << 10, std::size_t{1} << 14, std::size_t{1} << 18, (std::size_t{1} << 18) + 1, std::size_t{1} << 22 };
+
+    enum class access_pattern {
+        uniform,    // every position equally likely
+        zipf,       // a few hot positions, scattered over the array, take most of the accesses
+        sequential, // positions sweep from left to right
+    };
+
+    inline constexpr std::array<access_pattern, 3> patterns = { access_pattern::uniform, access_pattern::zipf, access_pattern::sequential };
+
+    inline const char* pattern_name(access_pattern p) noexcept {
+        switch (p) {
+            case access_pattern::uniform:
+                return "uniform";
+            case access_pattern::zipf:
+                return "zipf";
+            case access_pattern::sequential:
+                return "sequential";
+        }
+
+        return "";
+    }
+
+    // ranks in [1, n] with P(k) proportional to k^-exponent
+    // rejection-inversion sampling by Hörmann and Derflinger, which needs no table
+    class zipf_distribution {
+        double exponent;
+        u64 n;
+        double h_integral_x1, h_integral_n, s;
+
+        static double helper1(double x) noexcept {
+            return (std::abs(x) > 1e-8 ? std::log1p(x) / x : 1 - x * (0.5 - x * (1.0 / 3 - 0.25 * x)));
+        }
+
+        static double helper2(double x) noexcept {
+            return (std::abs(x) > 1e-8 ? std::expm1(x) / x : 1 + x * 0.5 * (1 + x / 3 * (1 + 0.25 * x)));
+        }
+
+        double h(double x) const noexcept {
+            return std::exp(-exponent * std::log(x));
+        }
+
+        double h_integral(double x) const noexcept {
+            const double log_x = std::log(x);
+            return helper2((1 - exponent) * log_x) * log_x;
+        }
+
+        double h_integral_inverse(double x) const noexcept {
+            const double t = std::max(x * (1 - exponent), -1.0);
+            return std::exp(helper1(t) * x);
+        }
+
+    public:
+        zipf_distribution(u64 _n, double _exponent) : exponent(_exponent), n(_n) {
+            h_integral_x1 = h_integral(1.5) - 1;
+            h_integral_n = h_integral(static_cast<double>(n) + 0.5);
+            s = 2 - h_integral_inverse(h_integral(2.5) - h(2));
+        }
+
+        template <typename URBG>
+        u64 operator()(URBG& rng) {
+            std::uniform_real_distribution<double> dist(0, 1);
+
+            while (true) {
+                const double u = h_integral_n + dist(rng) * (h_integral_x1 - h_integral_n);
+                const double x = h_integral_inverse(u);
+                const u64 k = std::clamp<u64>(static_cast<u64>(x + 0.5), 1, n);
+
+                if (static_cast<double>(k) - x <= s || u >= h_integral(static_cast<double>(k) + 0.5) - h(static_cast<double>(k)))
+                    return k;
+            }
+        }
+    };
+
+    // number of precomputed operations a benchmark cycles through
+    inline constexpr std::size_t ring_size = std::size_t{1} << 16;
+
+    // number of operations handed to each call of a batched operation; divides ring_size
+    inline constexpr std::size_t batch_size = std::size_t{1} << 10;
+
+    // positions in [0, n), one per operation
+    inline std::vector<std::size_t> make_indices(access_pattern p, std::size_t n, u64 seed) {
+        std::mt19937_64 rng(seed);
+        std::vector<std::size_t> res(ring_size);
+
+        switch (p) {
+            case access_pattern::uniform:
+                for (auto&& e : res)
+                    e = static_cast<std::size_t>(rng() % n);
+                break;
+
+            case access_pattern::zipf: {
+                // scatter the ranks with a multiplication by a prime larger than n, which is a bijection on [0, n)
+                constexpr u64 scatter = 4294967311;
+
+                zipf_distribution dist(n, 0.99);
+                for (auto&& e : res)
+                    e = static_cast<std::size_t>((dist(rng) - 1) * scatter % n);
+                break;
+            }
+
+            case access_pattern::sequential:
+                for (std::size_t i = 0; i < res.size(); ++i)
+                    res[i] = i % n;
+                break;
+        }
+
+        return res;
+    }
+
+    // non-empty ranges [l, r) in [0, n), one per operation
+    // uniform and zipf draw both ends from the pattern, sequential slides a window of n / 64 by one
+    inline std::vector<std::pair<std::size_t, std::size_t>> make_ranges(access_pattern p, std::size_t n, u64 seed) {
+        std::vector<std::pair<std::size_t, std::size_t>> res(ring_size);
+
+        if (p == access_pattern::sequential) {
+            const std::size_t width = std::max<std::size_t>(1, n / 64);
+            for (std::size_t i = 0; i < res.size(); ++i) {
+                const std::size_t l = i % (n - width + 1);
+                res[i] = { l, l + width };
+            }
+
+            return res;
+        }
+
+        const auto a = make_indices(p, n, seed), b = make_indices(p, n, seed + 1);
+        for (std::size_t i = 0; i < res.size(); ++i)
+            res[i] = { std::min(a[i], b[i]), std::max(a[i], b[i]) + 1 };
+
+        return res;
+    }
+
+    template <typename Values>
+    std::vector<typename Values::value_type> make_values(std::size_t n, u64 seed) {
+        std::mt19937_64 rng(seed);
+        std::vector<typename Values::value_type> res(n);
+        for (auto&& e : res)
+            e = Values::random(rng);
+
+        return res;
+    }
+
+    // register fn as "tree/monoid/operation[/pattern]/N"
+    template <typename F>
+    benchmark::internal::Benchmark* add(const std::string& name, F&& fn) {
+        return benchmark::RegisterBenchmark(name.c_str(), std::forward<F>(fn))->Unit(benchmark::kNanosecond);
+    }
+
+    inline std::string bench_name(const char* tree, const char* monoid, const char* op, std::size_t n) {
+        return std::string(tree) + "/" + monoid + "/" + op + "/" + std::to_string(n);
+    }
+
+    inline std::string bench_name(const char* tree, const char* monoid, const char* op, access_pattern p, std::size_t n) {
+        return std::string(tree) + "/" + monoid + "/" + op + "/" + pattern_name(p) + "/" + std::to_string(n);
+    }
+
+    void register_segtree();
+    void register_lazy_segtree();
+    void register_dual_segtree();
+    void register_fenwick_tree();
+    void register_concurrent_segtree();
+    void register_atomic_fenwick_tree();
+    void register_persistent_segtree();
+    void register_sparse_segtree();
+    void register_compressor();
+    void register_tree_2d();
+    void register_range_fenwick_tree();
+    void register_beats_segtree();
+    void register_static_segtree();
+    void register_blocked_segtree();
+
+}
+
+#endif // !ADSL_BENCH_COMMON_HPP
@@ -0,0 +1,90 @@
+#include <algorithm>
+#include "adsl/utility/compressor.hpp"
+#include "adsl/segtree/segtree.hpp"
+#include "adsl/segtree/keyed_tree.hpp"
+#include "common.hpp"
+#include "monoids.hpp"
+
+namespace adsl_bench {
+
+    namespace {
+        inline std::vector<u64> make_keys(std::size_t n, u64 seed) {
+            std::mt19937_64 rng(seed);
+            std::vector<u64> res(n);
+            for (auto&& e : res)
+                e = rng();
+
+            return res;
+        }
+
+        void build(benchmark::State& state, std::size_t n) {
+            const auto keys = make_keys(n, n);
+
+            for (auto _ : state) {
+                adsl::compressor<u64> comp(keys);
+                benchmark::DoNotOptimize(comp);
+            }
+
+            state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * n));
+        }
+
+        // the keys looked up are those of the indices the pattern picks
+        void lookup(benchmark::State& state, access_pattern p, std::size_t n) {
+            const adsl::compressor<u64> comp(make_keys(n, n));
+            const auto idx = make_indices(p, comp.size(), n + 1);
+
+            std::size_t i = 0;
+            for (auto _ : state) {
+                benchmark::DoNotOptimize(comp.lower_bound(comp.key(idx[i])));
+                i = (i + 1) & (ring_size - 1);
+            }
+
+            state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations()));
+        }
+
+        // the baseline: a binary search over the sorted keys
+        void lookup_sorted(benchmark::State& state, access_pattern p, std::size_t n) {
+            const adsl::compressor<u64> comp(make_keys(n, n));
+            const auto keys = comp.keys();
+            const auto idx = make_indices(p, comp.size(), n + 1);
+
+            std::size_t i = 0;
+            for (auto _ : state) {
+                benchmark::DoNotOptimize(std::lower_bound(keys.begin(), keys.end(), keys[idx[i]]));
+                i = (i + 1) & (ring_size - 1);
+            }
+
+            state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations()));
+        }
+
+        template <typename Values>
+        void keyed_query(benchmark::State& state, access_pattern p, std::size_t n) {
+            adsl::compressor<u64> comp(make_keys(n, n));
+            const auto ranges = make_ranges(p, comp.size(), n + 1);
+
+            using tree_type = adsl::segtree<typename Values::monoid>;
+            const adsl::keyed_tree<tree_type, u64> seg(comp, tree_type(make_values<Values>(comp.size(), n)));
+
+            std::size_t i = 0;
+            for (auto _ : state) {
+                benchmark::DoNotOptimize(seg.accumulate(comp.key(ranges[i].first), comp.key(ranges[i].second - 1) + 1));
+                i = (i + 1) & (ring_size - 1);
+            }
+
+            state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations()));
+        }
+    }
+
+    void register_compressor() {
+        for (std::size_t n : sizes) {
+            add(bench_name("compressor", "u64", "build", n), [n](benchmark::State& state) { build(state, n); });
+
+            for (access_pattern p : patterns) {
+                add(bench_name("compressor", "u64", "lookup", p, n), [p, n](benchmark::State& state) { lookup(state, p, n); });
+                add(bench_name("sorted_keys", "u64", "lookup", p, n), [p, n](benchmark::State& state) { lookup_sorted(state, p, n); });
+                add(bench_name("keyed_segtree", sum_i64::name, "query", p, n), [p, n](benchmark::State& state) { keyed_query<sum_i64>(state, p, n); });
+            }
+        }
+    }
+
+}
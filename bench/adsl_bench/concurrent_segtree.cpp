@@ -0,0 +1,83 @@
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <thread>
+#include "adsl/segtree/segtree.hpp"
+#include "adsl/segtree/concurrent_segtree.hpp"
+#include "common.hpp"
+#include "monoids.hpp"
+
+namespace adsl_bench {
+
+    namespace {
+        // the baseline: a plain segtree behind a reader-writer lock
+        template <typename Values>
+        class locked_segtree {
+            adsl::segtree<typename Values::monoid> seg;
+            mutable std::shared_mutex lock;
+
+        public:
+            explicit locked_segtree(const std::vector<typename Values::value_type>& src) : seg(src) {}
+
+            void set(std::size_t idx, const typename Values::value_type& v) {
+                std::unique_lock guard(lock);
+                seg.set(idx, v);
+            }
+
+            auto accumulate(std::size_t l, std::size_t r) const {
+                std::shared_lock guard(lock);
+                return seg.accumulate(l, r);
+            }
+        };
+
+        template <typename Values>
+        using concurrent_type = adsl::concurrent_segtree<typename Values::monoid>;
+
+        // one in write_period operations is a set, the rest are queries
+        constexpr std::size_t write_period = 20;
+
+        // every thread of the benchmark shares one tree, which thread 0 builds before the timed loop starts
+        template <typename Tree, typename Values>
+        void mixed(benchmark::State& state, std::size_t n) {
+            static std::unique_ptr<Tree> tree;
+            if (state.thread_index() == 0)
+                tree = std::make_unique<Tree>(make_values<Values>(n, n));
+
+            const auto seed = n + static_cast<u64>(state.thread_index()) * ring_size;
+            const auto idx = make_indices(access_pattern::uniform, n, seed + 1);
+            const auto ranges = make_ranges(access_pattern::uniform, n, seed + 2);
+            const auto val = make_values<Values>(ring_size, seed + 3);
+
+            std::size_t i = 0;
+            for (auto _ : state) {
+                if (i % write_period == 0)
+                    tree->set(idx[i], val[i]);
+                else
+                    benchmark::DoNotOptimize(tree->accumulate(ranges[i].first, ranges[i].second));
+
+                i = (i + 1) & (ring_size - 1);
+            }
+
+            state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations()));
+            if (state.thread_index() == 0)
+                tree.reset();
+        }
+
+        template <typename Values>
+        void register_for() {
+            const int max_threads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+
+            for (std::size_t n : sizes) {
+                add(bench_name("concurrent_segtree", Values::name, "mixed95", n), [n](benchmark::State& state) { mixed<concurrent_type<Values>, Values>(state, n); })
+                    ->ThreadRange(1, max_threads)->UseRealTime();
+                add(bench_name("locked_segtree", Values::name, "mixed95", n), [n](benchmark::State& state) { mixed<locked_segtree<Values>, Values>(state, n); })
+                    ->ThreadRange(1, max_threads)->UseRealTime();
+            }
+        }
+    }
+
+    void register_concurrent_segtree() {
+        register_for<sum_i64>();
+    }
+
+}
@@ -0,0 +1,129 @@
+#include "adsl/segtree/dual_segtree.hpp"
+#include "common.hpp"
+#include "monoids.hpp"
+
+namespace adsl_bench {
+
+    namespace {
+        template <typename Values>
+        using tree_type = adsl::dual_segtree<typename Values::monoid>;
+
+        // a tree of n units with ring_size random range updates already applied
+        template <typename Values>
+        tree_type<Values> make_tree(std::size_t n) {
+            tree_type<Values> seg(n);
+
+            const auto ranges = make_ranges(access_pattern::uniform, n, n);
+            const auto val = make_values<Values>(ring_size, n + 1);
+            for (std::size_t i = 0; i < ring_size; ++i)
+                seg.append(ranges[i].first, ranges[i].second, val[i]);
+
+            return seg;
+        }
+
+        template <typename Values>
+        void apply(benchmark::State& state, access_pattern p, std::size_t n) {
+            auto seg = make_tree<Values>(n);
+            const auto ranges = make_ranges(p, n, n + 2);
+            const auto val = make_values<Values>(ring_size, n + 3);
+
+            std::size_t i = 0;
+            for (auto _ : state) {
+                seg.append(ranges[i].first, ranges[i].second, val[i]);
+                i = (i + 1) & (ring_size - 1);
+            }
+
+            state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations()));
+        }
+
+        template <typename Values>
+        void query(benchmark::State& state, access_pattern p, std::size_t n) {
+            auto seg = make_tree<Values>(n);
+            const auto idx = make_indices(p, n, n + 2);
+
+            std::size_t i = 0;
+            for (auto _ : state) {
+                benchmark::DoNotOptimize(seg.calc(idx[i]));
+                i = (i + 1) & (ring_size - 1);
+            }
+
+            state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations()));
+        }
+
+        // batches of batch_size point reads
+        template <typename Values>
+        void query_batch(benchmark::State& state, access_pattern p, std::size_t n) {
+            const auto seg = make_tree<Values>(n);
+            const auto idx = make_indices(p, n, n + 2);
+
+            std::size_t i = 0;
+            for (auto _ : state) {
+                benchmark::DoNotOptimize(seg.calc_batch(std::span(idx).subspan(i, batch_size)));
+                i = (i + batch_size) & (ring_size - 1);
+            }
+
+            state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * batch_size));
+        }
+
+        // read every value out in one sweep without writing
+        template <typename Values>
+        void calc_all(benchmark::State& state, std::size_t n) {
+            const auto seg = make_tree<Values>(n);
+
+            for (auto _ : state)
+                benchmark::DoNotOptimize(seg.calc_all());
+
+            state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * n));
+        }
+
+        // read every value out in one sweep
+        template <typename Values>
+        void materialize(benchmark::State& state, std::size_t n) {
+            auto seg = make_tree<Values>(n);
+            std::vector<typename Values::value_type> out(n);
+
+            for (auto _ : state) {
+                seg.materialize(out.begin());
+                benchmark::DoNotOptimize(out.data());
+            }
+
+            state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * n));
+        }
+
+        // read every value out with one calc each, the baseline of materialize
+        template <typename Values>
+        void calc_each(benchmark::State& state, std::size_t n) {
+            auto seg = make_tree<Values>(n);
+            std::vector<typename Values::value_type> out(n);
+
+            for (auto _ : state) {
+                for (std::size_t i = 0; i < n; ++i)
+                    out[i] = *seg.calc(i);
+                benchmark::DoNotOptimize(out.data());
+            }
+
+            state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * n));
+        }
+
+        template <typename Values>
+        void register_for() {
+            for (std::size_t n : sizes) {
+                add(bench_name("dual_segtree", Values::name, "materialize", n), [n](benchmark::State& state) { materialize<Values>(state, n); });
+                add(bench_name("dual_segtree", Values::name, "calc_each", n), [n](benchmark::State& state) { calc_each<Values>(state, n); });
+                add(bench_name("dual_segtree", Values::name, "calc_all", n), [n](benchmark::State& state) { calc_all<Values>(state, n); });
+
+                for (access_pattern p : patterns) {
+                    add(bench_name("dual_segtree", Values::name, "apply", p, n), [p, n](benchmark::State& state) { apply<Values>(state, p, n); });
+                    add(bench_name("dual_segtree", Values::name, "query", p, n), [p, n](benchmark::State& state) { query<Values>(state, p, n); });
+                    add(bench_name("dual_segtree", Values::name, "query_batch", p, n), [p, n](benchmark::State& state) { query_batch<Values>(state, p, n); });
+                }
+            }
+        }
+    }
+
+    void register_dual_segtree() {
+        register_for<sum_i64>();
+        register_for<affine_mod>();
+    }
+
+}
@@ -0,0 +1,105 @@
+#include "adsl/segtree/fenwick_tree.hpp"
+#include "common.hpp"
+#include "monoids.hpp"
+
+namespace adsl_bench {
+
+    namespace {
+        template <typename Values>
+        using tree_type = adsl::fenwick_tree<typename Values::monoid>;
+
+        template <typename Values>
+        void build(benchmark::State& state, std::size_t n) {
+            const auto src = make_values<Values>(n, n);
+
+            for (auto _ : state) {
+                tree_type<Values> fw(src);
+                benchmark::DoNotOptimize(fw);
+            }
+
+            state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * n));
+        }
+
+        template <typename Values>
+        void update(benchmark::State& state, access_pattern p, std::size_t n) {
+            tree_type<Values> fw(make_values<Values>(n, n));
+            const auto idx = make_indices(p, n, n + 1);
+            const auto val = make_values<Values>(ring_size, n + 2);
+
+            std::size_t i = 0;
+            for (auto _ : state) {
+                fw.append_at(idx[i], val[i]);
+                i = (i + 1) & (ring_size - 1);
+            }
+
+            state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations()));
+        }
+
+        template <typename Values>
+        void update_batch(benchmark::State& state, access_pattern p, std::size_t n) {
+            tree_type<Values> fw(make_values<Values>(n, n));
+            const auto idx = make_indices(p, n, n + 1);
+            const auto val = make_values<Values>(ring_size, n + 2);
+
+            std::vector<std::pair<std::size_t, typename Values::value_type>> incs(ring_size);
+            for (std::size_t i = 0; i < ring_size; ++i)
+                incs[i] = { idx[i], val[i] };
+
+            std::size_t i = 0;
+            for (auto _ : state) {
+                fw.append_at_batch(std::span(incs).subspan(i, batch_size));
+                i = (i + batch_size) & (ring_size - 1);
+            }
+
+            state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * batch_size));
+        }
+
+        template <typename Values>
+        void prefix_query(benchmark::State& state, access_pattern p, std::size_t n) {
+            const tree_type<Values> fw(make_values<Values>(n, n));
+            const auto idx = make_indices(p, n, n + 1);
+
+            std::size_t i = 0;
+            for (auto _ : state) {
+                benchmark::DoNotOptimize(fw.accumulate(idx[i]));
+                i = (i + 1) & (ring_size - 1);
+            }
+
+            state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations()));
+        }
+
+        template <typename Values>
+        void query(benchmark::State& state, access_pattern p, std::size_t n) {
+            const tree_type<Values> fw(make_values<Values>(n, n));
+            const auto ranges = make_ranges(p, n, n + 1);
+
+            std::size_t i = 0;
+            for (auto _ : state) {
+                benchmark::DoNotOptimize(fw.accumulate(ranges[i].first, ranges[i].second));
+                i = (i + 1) & (ring_size - 1);
+            }
+
+            state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations()));
+        }
+
+        template <typename Values>
+        void register_for() {
+            for (std::size_t n : sizes) {
+                add(bench_name("fenwick_tree", Values::name, "build", n), [n](benchmark::State& state) { build<Values>(state, n); });
+
+                for (access_pattern p : patterns) {
+                    add(bench_name("fenwick_tree", Values::name, "update", p, n), [p, n](benchmark::State& state) { update<Values>(state, p, n); });
+                    add(bench_name("fenwick_tree", Values::name, "update_batch", p, n), [p, n](benchmark::State& state) { update_batch<Values>(state, p, n); });
+                    add(bench_name("fenwick_tree", Values::name, "prefix_query", p, n), [p, n](benchmark::State& state) { prefix_query<Values>(state, p, n); });
+                    add(bench_name("fenwick_tree", Values::name, "query", p, n), [p, n](benchmark::State& state) { query<Values>(state, p, n); });
+                }
+            }
+        }
+    }
+
+    void register_fenwick_tree() {
+        register_for<sum_group_i64>();
+        register_for<sum_group_f64>();
+    }
+
+}
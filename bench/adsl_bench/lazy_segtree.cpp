@@ -0,0 +1,195 @@
+#include "adsl/segtree/lazy_segtree.hpp"
+#include "common.hpp"
+#include "monoids.hpp"
+
+namespace adsl_bench {
+
+    namespace {
+        template <typename Values>
+        using tree_type = adsl::lazy_segtree<typename Values::act>;
+
+        template <typename Values>
+        std::vector<typename Values::operator_type> make_operators(u64 seed) {
+            std::mt19937_64 rng(seed);
+            std::vector<typename Values::operator_type> res(ring_size);
+            for (auto&& e : res)
+                e = Values::random_operator(rng);
+
+            return res;
+        }
+
+        template <typename Values>
+        void build(benchmark::State& state, std::size_t n) {
+            const auto src = make_values<Values>(n, n);
+
+            for (auto _ : state) {
+                tree_type<Values> seg(src);
+                benchmark::DoNotOptimize(seg);
+            }
+
+            state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * n));
+        }
+
+        template <typename Values>
+        void update(benchmark::State& state, access_pattern p, std::size_t n) {
+            tree_type<Values> seg(make_values<Values>(n, n));
+            const auto idx = make_indices(p, n, n + 1);
+            const auto val = make_values<Values>(ring_size, n + 2);
+
+            std::size_t i = 0;
+            for (auto _ : state) {
+                seg.set(idx[i], val[i]);
+                i = (i + 1) & (ring_size - 1);
+            }
+
+            state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations()));
+        }
+
+        template <typename Values>
+        void query(benchmark::State& state, access_pattern p, std::size_t n) {
+            tree_type<Values> seg(make_values<Values>(n, n));
+            const auto ranges = make_ranges(p, n, n + 1);
+
+            std::size_t i = 0;
+            for (auto _ : state) {
+                benchmark::DoNotOptimize(seg.accumulate(ranges[i].first, ranges[i].second));
+                i = (i + 1) & (ring_size - 1);
+            }
+
+            state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations()));
+        }
+
+        template <typename Values>
+        void apply(benchmark::State& state, access_pattern p, std::size_t n) {
+            tree_type<Values> seg(make_values<Values>(n, n));
+            const auto ranges = make_ranges(p, n, n + 1);
+            const auto ops = make_operators<Values>(n + 2);
+
+            std::size_t i = 0;
+            for (auto _ : state) {
+                seg.append(ranges[i].first, ranges[i].second, ops[i]);
+                i = (i + 1) & (ring_size - 1);
+            }
+
+            state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations()));
+        }
+
+        // read every value out in one sweep; the tags pushed down by the previous sweep are put back by a few applies
+        template <typename Values>
+        void materialize(benchmark::State& state, std::size_t n) {
+            tree_type<Values> seg(make_values<Values>(n, n));
+            const auto ranges = make_ranges(access_pattern::uniform, n, n + 1);
+            const auto ops = make_operators<Values>(n + 2);
+            std::vector<typename Values::value_type> out(n);
+
+            std::size_t i = 0;
+            for (auto _ : state) {
+                for (std::size_t k = 0; k < 64; ++k, i = (i + 1) & (ring_size - 1))
+                    seg.append(ranges[i].first, ranges[i].second, ops[i]);
+
+                seg.materialize(out.begin());
+                benchmark::DoNotOptimize(out.data());
+            }
+
+            state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * n));
+        }
+
+        // read every value out with one query each, the baseline of materialize
+        template <typename Values>
+        void calc_each(benchmark::State& state, std::size_t n) {
+            tree_type<Values> seg(make_values<Values>(n, n));
+            const auto ranges = make_ranges(access_pattern::uniform, n, n + 1);
+            const auto ops = make_operators<Values>(n + 2);
+            std::vector<typename Values::value_type> out(n);
+
+            std::size_t i = 0;
+            for (auto _ : state) {
+                for (std::size_t k = 0; k < 64; ++k, i = (i + 1) & (ring_size - 1))
+                    seg.append(ranges[i].first, ranges[i].second, ops[i]);
+
+                for (std::size_t k = 0; k < n; ++k)
+                    out[k] = *seg.accumulate(k, k + 1);
+                benchmark::DoNotOptimize(out.data());
+            }
+
+            state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * n));
+        }
+
+        // batches of batch_size disjoint ranges in shuffled order, the ends of each batch drawn from the pattern
+        template <typename Values>
+        std::vector<std::tuple<std::size_t, std::size_t, typename Values::operator_type>> make_disjoint_batches(access_pattern p, std::size_t n, u64 seed) {
+            const auto a = make_indices(p, n, seed), b = make_indices(p, n, seed + 1);
+            const auto ops = make_operators<Values>(seed + 2);
+            std::mt19937_64 rng(seed + 3);
+
+            std::vector<std::tuple<std::size_t, std::size_t, typename Values::operator_type>> res(ring_size);
+            std::vector<std::size_t> ends(batch_size * 2);
+            for (std::size_t first = 0; first < ring_size; first += batch_size) {
+                for (std::size_t i = 0; i < batch_size; ++i) {
+                    ends[i * 2] = a[first + i];
+                    ends[i * 2 + 1] = b[first + i];
+                }
+                std::sort(ends.begin(), ends.end());
+
+                // an empty range is skipped by append_batch
+                for (std::size_t i = 0; i < batch_size; ++i)
+                    res[first + i] = { ends[i * 2], ends[i * 2 + 1], ops[first + i] };
+                std::shuffle(res.begin() + first, res.begin() + first + batch_size, rng);
+            }
+
+            return res;
+        }
+
+        template <typename Values>
+        void apply_disjoint(benchmark::State& state, access_pattern p, std::size_t n) {
+            tree_type<Values> seg(make_values<Values>(n, n));
+            const auto batches = make_disjoint_batches<Values>(p, n, n + 1);
+
+            std::size_t i = 0;
+            for (auto _ : state) {
+                for (std::size_t k = i; k < i + batch_size; ++k)
+                    seg.append(std::get<0>(batches[k]), std::get<1>(batches[k]), std::get<2>(batches[k]));
+                i = (i + batch_size) & (ring_size - 1);
+            }
+
+            state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * batch_size));
+        }
+
+        template <typename Values>
+        void apply_batch(benchmark::State& state, access_pattern p, std::size_t n) {
+            tree_type<Values> seg(make_values<Values>(n, n));
+            const auto batches = make_disjoint_batches<Values>(p, n, n + 1);
+
+            std::size_t i = 0;
+            for (auto _ : state) {
+                seg.append_batch(std::span(batches).subspan(i, batch_size));
+                i = (i + batch_size) & (ring_size - 1);
+            }
+
+            state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * batch_size));
+        }
+
+        template <typename Values>
+        void register_for() {
+            for (std::size_t n : sizes) {
+                add(bench_name("lazy_segtree", Values::name, "build", n), [n](benchmark::State& state) { build<Values>(state, n); });
+                add(bench_name("lazy_segtree", Values::name, "materialize", n), [n](benchmark::State& state) { materialize<Values>(state, n); });
+                add(bench_name("lazy_segtree", Values::name, "calc_each", n), [n](benchmark::State& state) { calc_each<Values>(state, n); });
+
+                for (access_pattern p : patterns) {
+                    add(bench_name("lazy_segtree", Values::name, "update", p, n), [p, n](benchmark::State& state) { update<Values>(state, p, n); });
+                    add(bench_name("lazy_segtree", Values::name, "query", p, n), [p, n](benchmark::State& state) { query<Values>(state, p, n); });
+                    add(bench_name("lazy_segtree", Values::name, "apply", p, n), [p, n](benchmark::State& state) { apply<Values>(state, p, n); });
+                    add(bench_name("lazy_segtree", Values::name, "apply_disjoint", p, n), [p, n](benchmark::State& state) { apply_disjoint<Values>(state, p, n); });
+                    add(bench_name("lazy_segtree", Values::name, "apply_batch", p, n), [p, n](benchmark::State& state) { apply_batch<Values>(state, p, n); });
+                }
+            }
+        }
+    }
+
+    void register_lazy_segtree() {
+        register_for<add_sum>();
+        register_for<assign_min>();
+    }
+
+}
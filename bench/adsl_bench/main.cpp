@@ -0,0 +1,31 @@
+// benchmarks of every tree over sizes, monoids and access patterns, named "tree/monoid/operation[/pattern]/N"
+// usage: ./adsl_bench [Google Benchmark flags]
+//   --benchmark_filter=<regex>       run a subset, e.g. '^segtree/sum_i64/query/'
+//   --benchmark_out=<file> --benchmark_out_format=json
+//                                    write JSON that tools/compare.py of Google Benchmark can diff across versions
+
+#include "common.hpp"
+
+int main(int argc, char** argv) {
+    adsl_bench::register_segtree();
+    adsl_bench::register_lazy_segtree();
+    adsl_bench::register_dual_segtree();
+    adsl_bench::register_fenwick_tree();
+    adsl_bench::register_concurrent_segtree();
+    adsl_bench::register_atomic_fenwick_tree();
+    adsl_bench::register_persistent_segtree();
+    adsl_bench::register_sparse_segtree();
+    adsl_bench::register_compressor();
+    adsl_bench::register_tree_2d();
+    adsl_bench::register_range_fenwick_tree();
+    adsl_bench::register_beats_segtree();
+    adsl_bench::register_static_segtree();
+    adsl_bench::register_blocked_segtree();
+
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv))
+        return 1;
+
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+}
@@ -0,0 +1,122 @@
+#ifndef ADSL_BENCH_MONOIDS_HPP
+#define ADSL_BENCH_MONOIDS_HPP
+
+#include <algorithm>
+#include <limits>
+#include <random>
+#include "adsl/algebra/type_util.hpp"
+#include "common.hpp"
+
+// the monoids and actions the benchmarks are instantiated with
+// each one names itself and draws random values so that the benchmarks stay generic
+namespace adsl_bench {
+
+    // 64-bit sum, the SIMD-friendly case
+    struct sum_i64 {
+        using monoid = adsl::default_monoid<i64>;
+        using value_type = i64;
+
+        static constexpr const char* name = "sum_i64";
+
+        static value_type random(std::mt19937_64& rng) {
+            return static_cast<value_type>(rng() % 1000000);
+        }
+    };
+
+    // 64-bit sum with inverses, for fenwick_tree
+    struct sum_group_i64 {
+        using monoid = adsl::default_group<i64>;
+        using value_type = i64;
+
+        static constexpr const char* name = "sum_i64";
+
+        static value_type random(std::mt19937_64& rng) {
+            return static_cast<value_type>(rng() % 1000000);
+        }
+    };
+
+    struct sum_group_f64 {
+        using monoid = adsl::default_group<double>;
+        using value_type = double;
+
+        static constexpr const char* name = "sum_f64";
+
+        static value_type random(std::mt19937_64& rng) {
+            return std::uniform_real_distribution<double>(0, 1)(rng);
+        }
+    };
+
+    // 32-bit minimum through a lambda
+    struct min_i32 {
+        using monoid = adsl::make_monoid<i32, std::numeric_limits<i32>::max(), [](i32 x, i32 y) { return std::min(x, y); }, true>;
+        using value_type = i32;
+
+        static constexpr const char* name = "min_i32";
+
+        static value_type random(std::mt19937_64& rng) {
+            return static_cast<value_type>(rng() % 1000000000);
+        }
+    };
+
+    // x -> ax + b modulo a prime, composed left to right: a non-commutative monoid with a costly op
+    struct affine {
+        static constexpr u64 mod = 998244353;
+
+        u64 a, b;
+    };
+
+    struct affine_mod {
+        using monoid = adsl::make_monoid<affine, affine{ 1, 0 }, [](const affine& f, const affine& g) { return affine{ f.a * g.a % affine::mod, (f.b * g.a + g.b) % affine::mod }; }>;
+        using value_type = affine;
+
+        static constexpr const char* name = "affine_mod";
+
+        static value_type random(std::mt19937_64& rng) {
+            return { rng() % affine::mod, rng() % affine::mod };
+        }
+    };
+
+    // range add, range sum: the values carry their length
+    struct sum_len {
+        i64 sum, len;
+    };
+
+    struct add_sum {
+        using space = adsl::make_monoid<sum_len, sum_len{ 0, 0 }, [](const sum_len& x, const sum_len& y) { return sum_len{ x.sum + y.sum, x.len + y.len }; }, true>;
+        using act = adsl::make_action<adsl::default_monoid<i64>, space, [](i64 c, const sum_len& x) { return sum_len{ x.sum + c * x.len, x.len }; }>;
+        using value_type = sum_len;
+        using operator_type = i64;
+
+        static constexpr const char* name = "add_sum";
+
+        static value_type random(std::mt19937_64& rng) {
+            return { static_cast<i64>(rng() % 1000000), 1 };
+        }
+
+        static operator_type random_operator(std::mt19937_64& rng) {
+            return static_cast<i64>(rng() % 1000);
+        }
+    };
+
+    // range assign, range min: -1 is no assignment and the later assignment wins
+    struct assign_min {
+        using domain = adsl::make_monoid<i64, -1, [](i64 x, i64 y) { return (y != -1 ? y : x); }, true>;
+        using space = adsl::make_monoid<i64, std::numeric_limits<i64>::max(), [](i64 x, i64 y) { return std::min(x, y); }, true>;
+        using act = adsl::make_action<domain, space, [](i64 p, i64 x) { return (p != -1 ? p : x); }>;
+        using value_type = i64;
+        using operator_type = i64;
+
+        static constexpr const char* name = "assign_min";
+
+        static value_type random(std::mt19937_64& rng) {
+            return static_cast<i64>(rng() % 1000000000);
+        }
+
+        static operator_type random_operator(std::mt19937_64& rng) {
+            return static_cast<i64>(rng() % 1000000000);
+        }
+    };
+
+}
+
+#endif // !ADSL_BENCH_MONOIDS_HPP
@@ -0,0 +1,80 @@
+#include "adsl/segtree/persistent_segtree.hpp"
+#include "common.hpp"
+#include "monoids.hpp"
+
+namespace adsl_bench {
+
+    namespace {
+        template <typename Values>
+        using tree_type = adsl::persistent_segtree<typename Values::monoid>;
+
+        template <typename Values>
+        void build(benchmark::State& state, std::size_t n) {
+            const auto src = make_values<Values>(n, n);
+
+            for (auto _ : state) {
+                tree_type<Values> seg(src);
+                benchmark::DoNotOptimize(seg);
+            }
+
+            state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * n));
+        }
+
+        // each set makes a version from the newest one and releases the one before, so the arena stays the same size
+        template <typename Values>
+        void update(benchmark::State& state, access_pattern p, std::size_t n) {
+            tree_type<Values> seg(make_values<Values>(n, n));
+            const auto idx = make_indices(p, n, n + 1);
+            const auto val = make_values<Values>(ring_size, n + 2);
+
+            std::size_t i = 0, version = 0;
+            for (auto _ : state) {
+                const std::size_t next = *seg.set(version, idx[i], val[i]);
+                seg.release(version);
+                version = next;
+                i = (i + 1) & (ring_size - 1);
+            }
+
+            state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations()));
+        }
+
+        // queries spread over a history of n / 16 versions
+        template <typename Values>
+        void query(benchmark::State& state, access_pattern p, std::size_t n) {
+            tree_type<Values> seg(make_values<Values>(n, n));
+            const auto idx = make_indices(p, n, n + 1);
+            const auto val = make_values<Values>(ring_size, n + 2);
+            const auto ranges = make_ranges(p, n, n + 3);
+
+            const std::size_t versions = std::min(std::max<std::size_t>(n / 16, 1), ring_size);
+            for (std::size_t i = 0; i + 1 < versions; ++i)
+                seg.set(i, idx[i], val[i]);
+
+            std::size_t i = 0;
+            for (auto _ : state) {
+                benchmark::DoNotOptimize(seg.accumulate(i % versions, ranges[i].first, ranges[i].second));
+                i = (i + 1) & (ring_size - 1);
+            }
+
+            state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations()));
+        }
+
+        template <typename Values>
+        void register_for() {
+            for (std::size_t n : sizes) {
+                add(bench_name("persistent_segtree", Values::name, "build", n), [n](benchmark::State& state) { build<Values>(state, n); });
+
+                for (access_pattern p : patterns) {
+                    add(bench_name("persistent_segtree", Values::name, "update", p, n), [p, n](benchmark::State& state) { update<Values>(state, p, n); });
+                    add(bench_name("persistent_segtree", Values::name, "query", p, n), [p, n](benchmark::State& state) { query<Values>(state, p, n); });
+                }
+            }
+        }
+    }
+
+    void register_persistent_segtree() {
+        register_for<sum_i64>();
+        register_for<affine_mod>();
+    }
+
+}
@@ -0,0 +1,70 @@
+#include "adsl/segtree/range_fenwick_tree.hpp"
+#include "common.hpp"
+#include "monoids.hpp"
+
+// compare with lazy_segtree/add_sum, which answers the same range add / range sum workload
+namespace adsl_bench {
+
+    namespace {
+        template <typename Values>
+        using tree_type = adsl::range_fenwick_tree<typename Values::monoid>;
+
+        template <typename Values>
+        void build(benchmark::State& state, std::size_t n) {
+            const auto src = make_values<Values>(n, n);
+
+            for (auto _ : state) {
+                tree_type<Values> seg(src);
+                benchmark::DoNotOptimize(seg);
+            }
+
+            state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * n));
+        }
+
+        template <typename Values>
+        void query(benchmark::State& state, access_pattern p, std::size_t n) {
+            const tree_type<Values> seg(make_values<Values>(n, n));
+            const auto ranges = make_ranges(p, n, n + 1);
+
+            std::size_t i = 0;
+            for (auto _ : state) {
+                benchmark::DoNotOptimize(seg.accumulate(ranges[i].first, ranges[i].second));
+                i = (i + 1) & (ring_size - 1);
+            }
+
+            state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations()));
+        }
+
+        template <typename Values>
+        void apply(benchmark::State& state, access_pattern p, std::size_t n) {
+            tree_type<Values> seg(make_values<Values>(n, n));
+            const auto ranges = make_ranges(p, n, n + 1);
+            const auto val = make_values<Values>(ring_size, n + 2);
+
+            std::size_t i = 0;
+            for (auto _ : state) {
+                seg.append(ranges[i].first, ranges[i].second, val[i]);
+                i = (i + 1) & (ring_size - 1);
+            }
+
+            state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations()));
+        }
+
+        template <typename Values>
+        void register_for() {
+            for (std::size_t n : sizes) {
+                add(bench_name("range_fenwick_tree", Values::name, "build", n), [n](benchmark::State& state) { build<Values>(state, n); });
+
+                for (access_pattern p : patterns) {
+                    add(bench_name("range_fenwick_tree", Values::name, "query", p, n), [p, n](benchmark::State& state) { query<Values>(state, p, n); });
+                    add(bench_name("range_fenwick_tree", Values::name, "apply", p, n), [p, n](benchmark::State& state) { apply<Values>(state, p, n); });
+                }
+            }
+        }
+    }
+
+    void register_range_fenwick_tree() {
+        register_for<sum_group_i64>();
+    }
+
+}
@@ -0,0 +1,105 @@
+#include "adsl/segtree/segtree.hpp"
+#include "common.hpp"
+#include "monoids.hpp"
+
+namespace adsl_bench {
+
+    namespace {
+        template <typename Values>
+        using tree_type = adsl::segtree<typename Values::monoid>;
+
+        template <typename Values>
+        void build(benchmark::State& state, std::size_t n) {
+            const auto src = make_values<Values>(n, n);
+
+            for (auto _ : state) {
+                tree_type<Values> seg(src);
+                benchmark::DoNotOptimize(seg);
+            }
+
+            state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * n));
+        }
+
+        template <typename Values>
+        void materialize(benchmark::State& state, std::size_t n) {
+            const tree_type<Values> seg(make_values<Values>(n, n));
+            std::vector<typename Values::value_type> out(n);
+
+            for (auto _ : state) {
+                seg.materialize(out.begin());
+                benchmark::DoNotOptimize(out.data());
+            }
+
+            state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * n));
+        }
+
+        template <typename Values>
+        void update(benchmark::State& state, access_pattern p, std::size_t n) {
+            tree_type<Values> seg(make_values<Values>(n, n));
+            const auto idx = make_indices(p, n, n + 1);
+            const auto val = make_values<Values>(ring_size, n + 2);
+
+            std::size_t i = 0;
+            for (auto _ : state) {
+                seg.set(idx[i], val[i]);
+                i = (i + 1) & (ring_size - 1);
+            }
+
+            state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations()));
+        }
+
+        template <typename Values>
+        void update_batch(benchmark::State& state, access_pattern p, std::size_t n) {
+            tree_type<Values> seg(make_values<Values>(n, n));
+            const auto idx = make_indices(p, n, n + 1);
+            const auto val = make_values<Values>(ring_size, n + 2);
+
+            std::vector<std::pair<std::size_t, typename Values::value_type>> updates(ring_size);
+            for (std::size_t i = 0; i < ring_size; ++i)
+                updates[i] = { idx[i], val[i] };
+
+            std::size_t i = 0;
+            for (auto _ : state) {
+                seg.set_batch(std::span(updates).subspan(i, batch_size));
+                i = (i + batch_size) & (ring_size - 1);
+            }
+
+            state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * batch_size));
+        }
+
+        template <typename Values>
+        void query(benchmark::State& state, access_pattern p, std::size_t n) {
+            const tree_type<Values> seg(make_values<Values>(n, n));
+            const auto ranges = make_ranges(p, n, n + 1);
+
+            std::size_t i = 0;
+            for (auto _ : state) {
+                benchmark::DoNotOptimize(seg.accumulate(ranges[i].first, ranges[i].second));
+                i = (i + 1) & (ring_size - 1);
+            }
+
+            state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations()));
+        }
+
+        template <typename Values>
+        void register_for() {
+            for (std::size_t n : sizes) {
+                add(bench_name("segtree", Values::name, "build", n), [n](benchmark::State& state) { build<Values>(state, n); });
+                add(bench_name("segtree", Values::name, "materialize", n), [n](benchmark::State& state) { materialize<Values>(state, n); });
+
+                for (access_pattern p : patterns) {
+                    add(bench_name("segtree", Values::name, "update", p, n), [p, n](benchmark::State& state) { update<Values>(state, p, n); });
+                    add(bench_name("segtree", Values::name, "update_batch", p, n), [p, n](benchmark::State& state) { update_batch<Values>(state, p, n); });
+                    add(bench_name("segtree", Values::name, "query", p, n), [p, n](benchmark::State& state) { query<Values>(state, p, n); });
+                }
+            }
+        }
+    }
+
+    void register_segtree() {
+        register_for<sum_i64>();
+        register_for<min_i32>();
+        register_for<affine_mod>();
+    }
+
+}
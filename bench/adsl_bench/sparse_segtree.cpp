@@ -0,0 +1,95 @@
+#include <algorithm>
+#include "adsl/segtree/sparse_segtree.hpp"
+#include "common.hpp"
+#include "monoids.hpp"
+
+namespace adsl_bench {
+
+    namespace {
+        template <typename Values>
+        using tree_type = adsl::sparse_segtree<typename Values::monoid>;
+
+        // n sorted keys scattered over the whole 64-bit space; the access patterns pick among them
+        inline std::vector<u64> make_keys(std::size_t n, u64 seed) {
+            std::mt19937_64 rng(seed);
+            std::vector<u64> res(n);
+            for (auto&& e : res)
+                e = rng() >> 1;
+
+            std::sort(res.begin(), res.end());
+            return res;
+        }
+
+        template <typename Values>
+        tree_type<Values> make_tree(const std::vector<u64>& keys) {
+            tree_type<Values> seg;
+            seg.reserve(keys.size() * 48);
+
+            const auto val = make_values<Values>(keys.size(), keys.size());
+            for (std::size_t i = 0; i < keys.size(); ++i)
+                seg.set(keys[i], val[i]);
+
+            return seg;
+        }
+
+        template <typename Values>
+        void build(benchmark::State& state, std::size_t n) {
+            const auto keys = make_keys(n, n);
+
+            for (auto _ : state) {
+                auto seg = make_tree<Values>(keys);
+                benchmark::DoNotOptimize(seg);
+            }
+
+            state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * n));
+        }
+
+        template <typename Values>
+        void update(benchmark::State& state, access_pattern p, std::size_t n) {
+            const auto keys = make_keys(n, n);
+            auto seg = make_tree<Values>(keys);
+            const auto idx = make_indices(p, n, n + 1);
+            const auto val = make_values<Values>(ring_size, n + 2);
+
+            std::size_t i = 0;
+            for (auto _ : state) {
+                seg.set(keys[idx[i]], val[i]);
+                i = (i + 1) & (ring_size - 1);
+            }
+
+            state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations()));
+        }
+
+        template <typename Values>
+        void query(benchmark::State& state, access_pattern p, std::size_t n) {
+            const auto keys = make_keys(n, n);
+            const auto seg = make_tree<Values>(keys);
+            const auto ranges = make_ranges(p, n, n + 1);
+
+            std::size_t i = 0;
+            for (auto _ : state) {
+                benchmark::DoNotOptimize(seg.accumulate(keys[ranges[i].first], keys[ranges[i].second - 1] + 1));
+                i = (i + 1) & (ring_size - 1);
+            }
+
+            state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations()));
+        }
+
+        template <typename Values>
+        void register_for() {
+            for (std::size_t n : sizes) {
+                add(bench_name("sparse_segtree", Values::name, "build", n), [n](benchmark::State& state) { build<Values>(state, n); });
+
+                for (access_pattern p : patterns) {
+                    add(bench_name("sparse_segtree", Values::name, "update", p, n), [p, n](benchmark::State& state) { update<Values>(state, p, n); });
+                    add(bench_name("sparse_segtree", Values::name, "query", p, n), [p, n](benchmark::State& state) { query<Values>(state, p, n); });
+                }
+            }
+        }
+    }
+
+    void register_sparse_segtree() {
+        register_for<sum_i64>();
+    }
+
+}
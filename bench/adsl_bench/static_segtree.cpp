@@ -0,0 +1,92 @@
+#include "adsl/segtree/static_segtree.hpp"
+#include "adsl/segtree/segtree.hpp"
+#include "common.hpp"
+#include "monoids.hpp"
+#include <memory>
+#include <utility>
+
+namespace adsl_bench {
+
+    namespace {
+        template <typename Values, std::size_t N>
+        using tree_type = adsl::static_segtree<typename Values::monoid, N>;
+
+        // the sizes a static_segtree is meant for, small enough that the whole tree stays in L1 or L2
+        constexpr std::index_sequence<64, 1024, 4096> static_sizes;
+
+        // on the heap, since the largest trees would strain the stack
+        template <typename Values, std::size_t N>
+        std::unique_ptr<tree_type<Values, N>> make_tree(u64 seed) {
+            const auto values = make_values<Values>(N, seed);
+
+            std::array<typename Values::value_type, N> src;
+            std::copy(values.begin(), values.end(), src.begin());
+
+            return std::make_unique<tree_type<Values, N>>(src);
+        }
+
+        template <typename Values, std::size_t N>
+        void update(benchmark::State& state, access_pattern p) {
+            auto seg = make_tree<Values, N>(N);
+            const auto idx = make_indices(p, N, N + 1);
+            const auto val = make_values<Values>(ring_size, N + 2);
+
+            std::size_t i = 0;
+            for (auto _ : state) {
+                seg->set_unchecked(idx[i], val[i]);
+                i = (i + 1) & (ring_size - 1);
+            }
+
+            state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations()));
+        }
+
+        template <typename Values, std::size_t N>
+        void query(benchmark::State& state, access_pattern p) {
+            const auto seg = make_tree<Values, N>(N);
+            const auto ranges = make_ranges(p, N, N + 1);
+
+            std::size_t i = 0;
+            for (auto _ : state) {
+                benchmark::DoNotOptimize(seg->accumulate_unchecked(ranges[i].first, ranges[i].second));
+                i = (i + 1) & (ring_size - 1);
+            }
+
+            state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations()));
+        }
+
+        // the same queries on a segtree, which has to find its height and check the ranges at run time
+        template <typename Values>
+        void query_segtree(benchmark::State& state, access_pattern p, std::size_t n) {
+            const adsl::segtree<typename Values::monoid> seg(make_values<Values>(n, n));
+            const auto ranges = make_ranges(p, n, n + 1);
+
+            std::size_t i = 0;
+            for (auto _ : state) {
+                benchmark::DoNotOptimize(seg.accumulate(ranges[i].first, ranges[i].second));
+                i = (i + 1) & (ring_size - 1);
+            }
+
+            state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations()));
+        }
+
+        template <typename Values, std::size_t N>
+        void register_size() {
+            for (access_pattern p : patterns) {
+                add(bench_name("static_segtree", Values::name, "update", p, N), [p](benchmark::State& state) { update<Values, N>(state, p); });
+                add(bench_name("static_segtree", Values::name, "query", p, N), [p](benchmark::State& state) { query<Values, N>(state, p); });
+                add(bench_name("static_segtree", Values::name, "query_segtree", p, N), [p](benchmark::State& state) { query_segtree<Values>(state, p, N); });
+            }
+        }
+
+        template <typename Values, std::size_t... N>
+        void register_for(std::index_sequence<N...>) {
+            (register_size<Values, N>(), ...);
+        }
+    }
+
+    void register_static_segtree() {
+        register_for<sum_i64>(static_sizes);
+        register_for<min_i32>(static_sizes);
+    }
+
+}
@@ -0,0 +1,152 @@
+#include <array>
+#include "adsl/segtree/fenwick_tree.hpp"
+#include "adsl/segtree/fenwick_tree_2d.hpp"
+#include "adsl/segtree/segtree_2d.hpp"
+#include "common.hpp"
+#include "monoids.hpp"
+
+namespace adsl_bench {
+
+    namespace {
+        // square grids of side n
+        inline constexpr std::array<std::size_t, 3> sides = { std::size_t{1} << 8, std::size_t{1} << 10, std::size_t{1} << 12 };
+
+        struct cell {
+            std::size_t r, c;
+        };
+
+        inline std::vector<cell> make_cells(std::size_t n, u64 seed) {
+            std::mt19937_64 rng(seed);
+            std::vector<cell> res(ring_size);
+            for (auto&& e : res)
+                e = { rng() % n, rng() % n };
+
+            return res;
+        }
+
+        // rectangles [r1, r2) x [c1, c2) with random corners
+        inline std::vector<std::pair<cell, cell>> make_rects(std::size_t n, u64 seed) {
+            const auto a = make_cells(n, seed), b = make_cells(n, seed + 1);
+            std::vector<std::pair<cell, cell>> res(ring_size);
+            for (std::size_t i = 0; i < ring_size; ++i)
+                res[i] = { { std::min(a[i].r, b[i].r), std::min(a[i].c, b[i].c) }, { std::max(a[i].r, b[i].r) + 1, std::max(a[i].c, b[i].c) + 1 } };
+
+            return res;
+        }
+
+        // the layout fenwick_tree_2d replaces: one fenwick_tree per row
+        template <typename Values>
+        class fenwick_rows {
+            std::vector<adsl::fenwick_tree<typename Values::monoid>> row;
+
+        public:
+            fenwick_rows(std::size_t n, const std::vector<typename Values::value_type>& src) {
+                row.reserve(n);
+                for (std::size_t i = 0; i < n; ++i)
+                    row.emplace_back(std::vector<typename Values::value_type>(src.begin() + i * n, src.begin() + (i + 1) * n));
+            }
+
+            void append_at(std::size_t r, std::size_t c, const typename Values::value_type& inc) {
+                row[r].append_at(c, inc);
+            }
+
+            auto accumulate(std::size_t r1, std::size_t c1, std::size_t r2, std::size_t c2) const {
+                typename Values::value_type res{};
+                for (std::size_t i = r1; i < r2; ++i)
+                    res += *row[i].accumulate(c1, c2);
+
+                return std::optional(res);
+            }
+        };
+
+        template <typename Values>
+        struct fenwick_2d : adsl::fenwick_tree_2d<typename Values::monoid> {
+            fenwick_2d(std::size_t n, const std::vector<typename Values::value_type>& src) : adsl::fenwick_tree_2d<typename Values::monoid>(n, n, src) {}
+        };
+
+        template <typename Values>
+        struct segtree_2d : adsl::segtree_2d<typename Values::monoid> {
+            segtree_2d(std::size_t n, const std::vector<typename Values::value_type>& src) : adsl::segtree_2d<typename Values::monoid>(n, n, src) {}
+
+            void append_at(std::size_t r, std::size_t c, const typename Values::value_type& v) {
+                this->set(r, c, v);
+            }
+        };
+
+        template <typename Tree, typename Values>
+        void update(benchmark::State& state, std::size_t n) {
+            Tree tree(n, make_values<Values>(n * n, n));
+            const auto cells = make_cells(n, n + 1);
+            const auto val = make_values<Values>(ring_size, n + 2);
+
+            std::size_t i = 0;
+            for (auto _ : state) {
+                tree.append_at(cells[i].r, cells[i].c, val[i]);
+                i = (i + 1) & (ring_size - 1);
+            }
+
+            state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations()));
+        }
+
+        template <typename Tree, typename Values>
+        void query(benchmark::State& state, std::size_t n) {
+            const Tree tree(n, make_values<Values>(n * n, n));
+            const auto rects = make_rects(n, n + 1);
+
+            std::size_t i = 0;
+            for (auto _ : state) {
+                const auto& [lo, hi] = rects[i];
+                benchmark::DoNotOptimize(tree.accumulate(lo.r, lo.c, hi.r, hi.c));
+                i = (i + 1) & (ring_size - 1);
+            }
+
+            state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations()));
+        }
+
+        // p points spread over a 2^32 x 2^32 plane
+        template <typename Values>
+        void offline(benchmark::State& state, bool is_query, std::size_t p) {
+            std::mt19937_64 rng(p);
+            std::vector<std::pair<std::int64_t, std::int64_t>> pts(p);
+            for (auto&& [x, y] : pts)
+                x = static_cast<std::int64_t>(rng() >> 32), y = static_cast<std::int64_t>(rng() >> 32);
+
+            adsl::offline_fenwick_tree_2d<typename Values::monoid> tree(pts);
+            const auto idx = make_indices(access_pattern::uniform, p, p + 1);
+            const auto val = make_values<Values>(ring_size, p + 2);
+
+            std::size_t i = 0;
+            for (auto _ : state) {
+                const auto& [x, y] = pts[idx[i]];
+                if (is_query)
+                    benchmark::DoNotOptimize(tree.accumulate(x, y));
+                else
+                    tree.append_at(x, y, val[i]);
+                i = (i + 1) & (ring_size - 1);
+            }
+
+            state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations()));
+        }
+
+        template <template <typename> typename Tree, typename Values>
+        void register_for(const char* name) {
+            for (std::size_t n : sides) {
+                add(bench_name(name, Values::name, "update", n), [n](benchmark::State& state) { update<Tree<Values>, Values>(state, n); });
+                add(bench_name(name, Values::name, "query", n), [n](benchmark::State& state) { query<Tree<Values>, Values>(state, n); });
+            }
+        }
+    }
+
+    // N is the side of the grid, or the number of points of the offline tree
+    void register_tree_2d() {
+        register_for<fenwick_rows, sum_group_i64>("fenwick_rows");
+        register_for<fenwick_2d, sum_group_i64>("fenwick_tree_2d");
+        register_for<segtree_2d, min_i32>("segtree_2d");
+
+        for (std::size_t p : sizes) {
+            add(bench_name("offline_fenwick_tree_2d", sum_group_i64::name, "update", p), [p](benchmark::State& state) { offline<sum_group_i64>(state, false, p); });
+            add(bench_name("offline_fenwick_tree_2d", sum_group_i64::name, "query", p), [p](benchmark::State& state) { offline<sum_group_i64>(state, true, p); });
+        }
+    }
+
+}
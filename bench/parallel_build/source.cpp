@@ -0,0 +1,59 @@
+// reports how the threaded constructors scale with the number of threads
+// usage: ./a.out [N] [max_threads]
+
+#include <iostream>
+#include <vector>
+#include <cstdint>
+#include <cstdlib>
+#include <chrono>
+#include <thread>
+#include <limits>
+#include <algorithm>
+
+#include "adsl/segtree/segtree.hpp"
+#include "adsl/segtree/fenwick_tree.hpp"
+#include "adsl/segtree/lazy_segtree.hpp"
+
+using i64 = std::int64_t;
+
+constexpr i64 Inf = std::numeric_limits<i64>::max();
+
+template <typename F>
+double measure_ms(F&& f) {
+    const auto start = std::chrono::steady_clock::now();
+    f();
+    const auto end = std::chrono::steady_clock::now();
+
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+template <typename Tree>
+void run(const char* name, const std::vector<i64>& vec, std::size_t max_threads) {
+    double base = 0;
+    for (std::size_t th = 1; th <= max_threads; th <<= 1) {
+        const double ms = measure_ms([&] { Tree tree(vec, th); });
+        if (th == 1)
+            base = ms;
+
+        std::cout << name << "\tthreads " << th << "\t" << ms << "ms\tspeedup " << base / ms << "\n";
+    }
+}
+
+int main(int argc, char** argv) {
+    const std::size_t N = (argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1 << 26);
+    const std::size_t max_threads = (argc > 2 ? std::strtoull(argv[2], nullptr, 10) : std::max(1u, std::thread::hardware_concurrency()));
+
+    std::vector<i64> vec(N);
+    for (std::size_t i = 0; i < N; ++i)
+        vec[i] = static_cast<i64>(i % 1000);
+
+    using O = adsl::make_monoid<i64, 0, [](i64 x, i64 y) { return x + y; }, true>;
+    using M = adsl::make_monoid<i64, Inf, [](i64 x, i64 y) { return std::min(x, y); }, true>;
+    using Act = adsl::make_action<O, M, [](i64 a, i64 x) { return (x == Inf ? x : x + a); }>;
+
+    run<adsl::segtree<adsl::default_monoid<i64>>>("segtree     ", vec, max_threads);
+    run<adsl::fenwick_tree<adsl::default_group<i64>>>("fenwick_tree", vec, max_threads);
+    run<adsl::lazy_segtree<Act>>("lazy_segtree", vec, max_threads);
+
+    std::cout << std::flush;
+}
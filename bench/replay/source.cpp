@@ -0,0 +1,132 @@
+// replays a binary log of operations against the trees and reports their throughput and latency percentiles
+// the log is memory-mapped, so no stream parsing or flushing lands in the measurement
+// usage: ./a.out generate <log> [N] [Q] [seed]   write a log of Q random set/update/append/accumulate over N values
+//        ./a.out <log> [tree...]                 replay it on segtree, dual_segtree, lazy_segtree and fenwick_tree, or the given ones
+// the checksum folds every accumulate result, so two builds replaying the same log on the same tree must agree on it
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <string_view>
+#include <cstdint>
+#include <cstdlib>
+#include <random>
+#include <utility>
+#include <algorithm>
+#include <limits>
+
+#include "adsl/segtree/replay.hpp"
+
+using i64 = std::int64_t;
+using u64 = std::uint64_t;
+
+constexpr i64 Inf = std::numeric_limits<i64>::max();
+
+int generate(const char* path, std::size_t N, std::size_t Q, u64 seed) {
+    std::mt19937_64 rng(seed);
+    std::vector<adsl::replay_op> ops(Q);
+
+    for (auto&& op : ops) {
+        op.kind = static_cast<adsl::replay_kind>(rng() % 4 + 1);
+        op.l = rng() % N;
+        op.r = rng() % N;
+        if (op.l > op.r)
+            std::swap(op.l, op.r);
+        ++op.r;
+        op.value = static_cast<i64>(rng() % 2001) - 1000;
+
+        if (op.kind == adsl::replay_kind::set || op.kind == adsl::replay_kind::update)
+            op.r = op.l + 1;
+    }
+
+    if (!adsl::save_replay_log(path, N, ops)) {
+        std::cerr << "cannot write " << path << "\n";
+        return 1;
+    }
+
+    std::cout << "wrote " << Q << " operations over " << N << " values to " << path << "\n";
+    return 0;
+}
+
+// one pass without timing each operation for the throughput, then one with it for the latencies, each on a fresh tree
+template <typename Tree>
+void report(const char* name, const adsl::replay_log& log) {
+    const std::size_t N = static_cast<std::size_t>(log.size());
+
+    Tree throughput_tree(N);
+    const adsl::replay_result res = adsl::replay(throughput_tree, log);
+
+    Tree latency_tree(N);
+    adsl::latency_histogram latencies;
+    adsl::replay(latency_tree, log, &latencies);
+
+    std::cout << std::left << std::setw(14) << name << std::right
+              << " ops " << res.executed << " skipped " << res.skipped
+              << std::fixed << std::setprecision(2) << "\t" << res.ops_per_second() / 1e6 << " Mops/s"
+              << std::setprecision(1) << "\tmean " << latencies.mean() << "ns"
+              << "\tp50 " << latencies.percentile(0.5) << "ns"
+              << "\tp99 " << latencies.percentile(0.99) << "ns"
+              << "\tp999 " << latencies.percentile(0.999) << "ns"
+              << "\tmax " << latencies.max() << "ns"
+              << "\tchecksum " << std::hex << res.checksum << std::dec << "\n";
+}
+
+int main(int argc, char** argv) {
+    std::ios::sync_with_stdio(false);
+
+    if (argc < 2) {
+        std::cerr << "usage: " << argv[0] << " generate <log> [N] [Q] [seed]\n"
+                  << "       " << argv[0] << " <log> [segtree|dual_segtree|lazy_segtree|fenwick_tree...]\n";
+        return 1;
+    }
+
+    if (std::string_view(argv[1]) == "generate") {
+        if (argc < 3) {
+            std::cerr << "generate needs the path of the log\n";
+            return 1;
+        }
+
+        const std::size_t N = (argc > 3 ? std::strtoull(argv[3], nullptr, 10) : 1 << 20);
+        const std::size_t Q = (argc > 4 ? std::strtoull(argv[4], nullptr, 10) : 1 << 22);
+        const u64 seed = (argc > 5 ? std::strtoull(argv[5], nullptr, 10) : 0);
+
+        if (N == 0) {
+            std::cerr << "N must be positive\n";
+            return 1;
+        }
+
+        return generate(argv[2], N, Q, seed);
+    }
+
+    const auto log = adsl::replay_log::open(argv[1]);
+    if (!log) {
+        std::cerr << "cannot open " << argv[1] << " as a replay log\n";
+        return 1;
+    }
+
+    std::vector<std::string_view> trees(argv + 2, argv + argc);
+    if (trees.empty())
+        trees = { "segtree", "dual_segtree", "lazy_segtree", "fenwick_tree" };
+
+    using O = adsl::make_monoid<i64, 0, [](i64 x, i64 y) { return x + y; }, true>;
+    using M = adsl::make_monoid<i64, Inf, [](i64 x, i64 y) { return std::min(x, y); }, true>;
+    using Act = adsl::make_action<O, M, [](i64 a, i64 x) { return (x == Inf ? x : x + a); }>;
+
+    std::cout << log->ops().size() << " operations over " << log->size() << " values\n";
+
+    for (std::string_view tree : trees) {
+        if (tree == "segtree")
+            report<adsl::segtree<adsl::default_monoid<i64>>>("segtree", *log);
+        else if (tree == "dual_segtree")
+            report<adsl::dual_segtree<adsl::default_monoid<i64>>>("dual_segtree", *log);
+        else if (tree == "lazy_segtree")
+            report<adsl::lazy_segtree<Act>>("lazy_segtree", *log);
+        else if (tree == "fenwick_tree")
+            report<adsl::fenwick_tree<adsl::default_group<i64>>>("fenwick_tree", *log);
+        else
+            std::cerr << "unknown tree " << tree << "\n";
+    }
+
+    std::cout << std::flush;
+}
@@ -0,0 +1,81 @@
+// compares accumulate_batch against a loop over accumulate
+// usage: ./a.out [N] [Q]
+
+#include <iostream>
+#include <vector>
+#include <cstdint>
+#include <cstdlib>
+#include <chrono>
+#include <random>
+#include <utility>
+#include <optional>
+#include <algorithm>
+#include <limits>
+
+#include "adsl/segtree/segtree.hpp"
+#include "adsl/segtree/lazy_segtree.hpp"
+
+using i64 = std::int64_t;
+
+constexpr i64 Inf = std::numeric_limits<i64>::max();
+
+template <typename F>
+double measure_ms(F&& f) {
+    const auto start = std::chrono::steady_clock::now();
+    f();
+    const auto end = std::chrono::steady_clock::now();
+
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+template <typename Tree>
+void run(const char* name, Tree& tree, const std::vector<std::pair<std::size_t, std::size_t>>& queries) {
+    std::vector<std::optional<i64>> scalar(queries.size()), batch(queries.size());
+
+    // warm up the caches and the page tables of both outputs
+    tree.accumulate_batch(queries, scalar.begin());
+    tree.accumulate_batch(queries, batch.begin());
+
+    const double scalar_ms = measure_ms([&] {
+        for (std::size_t i = 0; i < queries.size(); ++i)
+            scalar[i] = tree.accumulate(queries[i].first, queries[i].second);
+    });
+    const double batch_ms = measure_ms([&] {
+        tree.accumulate_batch(queries, batch.begin());
+    });
+
+    std::cout << name << " scalar : " << scalar_ms << "ms\n";
+    std::cout << name << " batch  : " << batch_ms << "ms" << (scalar == batch ? "" : " (MISMATCH)") << "\n";
+}
+
+int main(int argc, char** argv) {
+    const std::size_t N = (argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1 << 24);
+    const std::size_t Q = (argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 1 << 20);
+
+    std::mt19937_64 rng(0);
+
+    std::vector<i64> vec(N);
+    for (auto&& e : vec)
+        e = static_cast<i64>(rng() % 1000000);
+
+    std::vector<std::pair<std::size_t, std::size_t>> queries(Q);
+    for (auto&& [l, r] : queries) {
+        l = rng() % N;
+        r = rng() % N;
+        if (l > r)
+            std::swap(l, r);
+        ++r;
+    }
+
+    adsl::segtree<adsl::default_monoid<i64>> seg(vec);
+    run("segtree", seg, queries);
+
+    using O = adsl::make_monoid<i64, 0, [](i64 x, i64 y) { return x + y; }, true>;
+    using M = adsl::make_monoid<i64, Inf, [](i64 x, i64 y) { return std::min(x, y); }, true>;
+    using Act = adsl::make_action<O, M, [](i64 a, i64 x) { return (x == Inf ? x : x + a); }>;
+
+    adsl::lazy_segtree<Act> lazy(vec);
+    run("lazy_segtree", lazy, queries);
+
+    std::cout << std::flush;
+}
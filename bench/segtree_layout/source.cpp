@@ -0,0 +1,74 @@
+// compares the node layouts of segtree over N = 10^3, 10^4, ..., 10^max_exp
+// usage: ./a.out [max_exp] [Q]
+
+#include <iostream>
+#include <vector>
+#include <cstdint>
+#include <cstdlib>
+#include <chrono>
+#include <random>
+#include <utility>
+
+#include "adsl/segtree/segtree.hpp"
+#include "adsl/segtree/layout.hpp"
+
+using i64 = std::int64_t;
+
+template <typename F>
+double measure_ns_per_op(std::size_t ops, F&& f) {
+    const auto start = std::chrono::steady_clock::now();
+    f();
+    const auto end = std::chrono::steady_clock::now();
+
+    return std::chrono::duration<double, std::nano>(end - start).count() / static_cast<double>(ops);
+}
+
+template <typename Layout>
+void run(const char* name, std::size_t N, std::size_t Q) {
+    std::mt19937_64 rng(N);
+
+    std::vector<i64> vec(N);
+    for (auto&& e : vec)
+        e = static_cast<i64>(rng() % 1000000);
+
+    adsl::segtree<adsl::default_monoid<i64>, std::vector<i64>, Layout> seg(vec);
+    vec = std::vector<i64>();
+
+    const double update_ns = measure_ns_per_op(Q, [&] {
+        for (std::size_t i = 0; i < Q; ++i)
+            seg.update(rng() % N, [](i64 v) constexpr noexcept { return v + 1; });
+    });
+
+    i64 sink = 0;
+    const double prefix_ns = measure_ns_per_op(Q, [&] {
+        for (std::size_t i = 0; i < Q; ++i)
+            sink += *seg.accumulate(0, rng() % N + 1);
+    });
+    const double range_ns = measure_ns_per_op(Q, [&] {
+        for (std::size_t i = 0; i < Q; ++i) {
+            std::size_t l = rng() % N, r = rng() % N;
+            if (l > r)
+                std::swap(l, r);
+
+            sink += *seg.accumulate(l, r + 1);
+        }
+    });
+
+    std::cout << N << "\t" << name << "\tupdate " << update_ns << "ns\tprefix " << prefix_ns << "ns\trange " << range_ns << "ns" << (sink == 0 ? "\n" : "\n");
+}
+
+int main(int argc, char** argv) {
+    const int max_exp = (argc > 1 ? std::atoi(argv[1]) : 9);
+    const std::size_t Q = (argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 1 << 20);
+
+    std::size_t N = 1000;
+    for (int e = 3; e <= max_exp; ++e, N *= 10) {
+        run<adsl::binary_heap_layout>("binary_heap ", N, Q);
+        run<adsl::blocked_heap_layout<3>>("blocked<3>  ", N, Q);
+        run<adsl::blocked_heap_layout<4>>("blocked<4>  ", N, Q);
+        run<adsl::truncated_heap_layout>("truncated   ", N, Q);
+        run<adsl::compact_heap_layout>("compact     ", N, Q);
+    }
+
+    std::cout << std::flush;
+}
@@ -0,0 +1,47 @@
+// reports the node storage of segtree and lazy_segtree for each layout, with 8-byte values and operators
+// the default sizes include N = 2^k + 1, the worst case of the perfect layouts
+// usage: ./a.out [N...]
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <cstdlib>
+
+#include "adsl/segtree/layout.hpp"
+
+using i64 = std::int64_t;
+
+template <typename Layout>
+void report(const char* name, std::size_t N) {
+    const std::size_t storage = Layout(N).storage_size();
+
+    // segtree holds one value per slot, lazy_segtree a value and an operator
+    const double segtree_mib = static_cast<double>(storage * sizeof(i64)) / (1 << 20);
+    const double lazy_mib = static_cast<double>(storage * (sizeof(i64) + sizeof(i64))) / (1 << 20);
+
+    std::cout << N << "\t" << name << "\tslots " << storage << "\tslots/N " << std::fixed << std::setprecision(3) << static_cast<double>(storage) / static_cast<double>(N)
+              << "\tsegtree " << std::setprecision(1) << segtree_mib << "MiB\tlazy_segtree " << lazy_mib << "MiB\n";
+}
+
+int main(int argc, char** argv) {
+    std::vector<std::size_t> sizes;
+    for (int i = 1; i < argc; ++i)
+        sizes.push_back(std::strtoull(argv[i], nullptr, 10));
+
+    if (sizes.empty())
+        sizes = { 1000000, (1 << 20), (1 << 20) + 1, 3 << 19, 500000000, (std::size_t{1} << 29) + 1 };
+
+    for (std::size_t N : sizes) {
+        if (N == 0)
+            continue;
+
+        report<adsl::binary_heap_layout>("binary_heap   ", N);
+        report<adsl::blocked_heap_layout<3>>("blocked<3>    ", N);
+        report<adsl::truncated_heap_layout>("truncated_heap", N);
+        report<adsl::compact_heap_layout>("compact_heap  ", N);
+    }
+
+    std::cout << std::flush;
+}
\ No newline at end of file
@@ -1,6 +1,7 @@
 #ifndef ADSL_ALGEBRA_DATA_TYPE_HPP
 #define ADSL_ALGEBRA_DATA_TYPE_HPP
 
+#include <cstddef>
 #include <utility>
 #include <type_traits>
 #include <concepts>
@@ -41,6 +42,35 @@ namespace adsl {
 	concept CommutativeGroup = Group<G> && std::is_base_of_v<commutative_tag, G>;
 
 
+	class vectorizable_tag {};
+
+	template <typename M>
+	struct is_vectorizable : std::bool_constant<std::is_base_of_v<vectorizable_tag, M>> {};
+
+	// M::op must be a lane-wise operation such as +, min, max, xor, and, or,
+	// so that a fold may be split into independent SIMD lanes and merged in any order
+	template <typename M>
+	concept VectorizableMonoid = CommutativeMonoid<M> && std::is_arithmetic_v<typename M::value_type> && is_vectorizable<M>::value;
+
+
+	class additive_tag {};
+
+	// M::op(x, y) must equal to x + y
+	template <typename M>
+	struct is_additive : std::bool_constant<std::is_base_of_v<additive_tag, M>> {};
+
+	// G::scale(v, n) must equal to G::op(v, G::op(v, ...)) with n copies of v, and G::scale(v, 0) to G::unit()
+	// an additive group of arithmetic values may leave it out to use v * n
+	template <typename G>
+	concept ScalableGroup = CommutativeGroup<G> && (
+		requires { { G::scale(std::declval<typename G::value_type>(), std::size_t{}) } -> std::convertible_to<typename G::value_type>; } ||
+		(std::is_arithmetic_v<typename G::value_type> && is_additive<G>::value) );
+
+	// integral addition, which may be applied in place by std::atomic<T>::fetch_add
+	template <typename M>
+	concept AdditiveMonoid = CommutativeMonoid<M> && std::is_integral_v<typename M::value_type> && is_additive<M>::value;
+
+
 	template <typename T>
 	concept MonoidallyAdditionable = requires(T x, T y) {
         requires std::is_default_constructible_v<T>;
@@ -68,6 +98,13 @@ namespace adsl {
 	template <typename A>
 	concept MonoidAction = LeftAction<A> && CommutativeMonoid<typename A::domain>;
 
+	// A::act(m, x) must equal to A::act(m)(x)
+	// the data structures call it instead, so that no closure is built on each application
+	template <typename A>
+	concept DirectAction = LeftAction<A> && requires {
+		{ A::act(std::declval<typename A::domain::value_type>(), std::declval<typename A::space::value_type>()) } -> std::convertible_to<typename A::space::value_type>;
+	};
+
 	// F.operator () (Domain::unit()) must equal to Codomain::unit()
 	template <typename F, typename Domain, typename Codomain>
 	concept MonoidHomomorphism = Monoid<Domain> && Monoid<Codomain> && std::convertible_to<std::invoke_result_t<F, typename Domain::value_type>, typename Codomain::value_type>;
@@ -164,6 +164,25 @@ namespace adsl {
     template <GrouplyAdditionable T, bool is_commutative = std::is_signed_v<T>>
     using default_group = impl::default_group<T, is_commutative>;
 
+    // integral addition may be split into SIMD lanes
+    // floating point addition is left out since reassociating it changes the rounding
+    template <typename T>
+    requires std::is_integral_v<T>
+    struct is_vectorizable<impl::default_monoid<T, true>> : std::true_type {};
+
+    template <typename T>
+    requires std::is_integral_v<T>
+    struct is_vectorizable<impl::default_group<T, true>> : std::true_type {};
+
+
+    template <typename T>
+    requires std::is_arithmetic_v<T>
+    struct is_additive<impl::default_monoid<T, true>> : std::true_type {};
+
+    template <typename T>
+    requires std::is_arithmetic_v<T>
+    struct is_additive<impl::default_group<T, true>> : std::true_type {};
+
 
     template <typename D, typename S, auto func>
     requires requires { {func(std::declval<typename D::value_type>(), std::declval<typename S::value_type>())} -> std::convertible_to<typename S::value_type>; }
@@ -174,6 +193,9 @@ namespace adsl {
         static constexpr auto act(const domain::value_type& v) noexcept(noexcept(func(v, std::declval<typename space::value_type>()))) {
             return [&v](const space::value_type& s) noexcept(noexcept(func(v, s))) { return func(v, s); };
         }
+        static constexpr space::value_type act(const domain::value_type& v, const space::value_type& s) noexcept(noexcept(func(v, s))) {
+            return func(v, s);
+        }
     };
 }
 
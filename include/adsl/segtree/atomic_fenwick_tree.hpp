@@ -0,0 +1,157 @@
+#ifndef ADSL_SEGTREE_ATOMIC_FENWICK_TREE_HPP
+#define ADSL_SEGTREE_ATOMIC_FENWICK_TREE_HPP
+
+#include <cstddef>
+#include <vector>
+#include <algorithm>
+#include <optional>
+#include <atomic>
+#include <type_traits>
+#include <bit>
+#include "../algebra/data_type.hpp"
+#include "../algebra/type_util.hpp"
+#include "../utility/cache_aligned_allocator.hpp"
+#include "../utility/parallel.hpp"
+
+namespace adsl {
+
+    // a fenwick tree whose nodes are std::atomic, so that any number of threads may append_at and accumulate at once
+    // without locks; append_at is a fetch_add per node for an AdditiveMonoid and a compare-exchange loop otherwise
+    // the tree is kept Stripes times, each thread appends to the copy picked by its thread slot and readers sum all of them,
+    // which keeps writers on different threads from fighting over the cache lines of the top nodes
+    // consistency, with every access relaxed:
+    //   - a prefix accumulate reads one node per copy covering each index, so it counts every append_at either
+    //     wholly or not at all, and always counts those that happen-before it (the calling thread's own, and those of
+    //     threads it has synchronized with); an append that merely finished earlier in time may still be missed
+    //   - it is not linearizable: appends racing with it may be counted in any subset, even one leaving out an earlier
+    //     append of the same thread; a range accumulate is the difference of two such reads
+    //   - once the writers are joined (or otherwise synchronized with), reads are exact
+    template <CommutativeMonoid M, std::size_t Stripes = 1>
+    requires (
+        std::atomic<typename M::value_type>::is_always_lock_free &&
+        std::has_single_bit(Stripes) )
+    class atomic_fenwick_tree {
+    public:
+        using value_type = M::value_type;
+        using size_type = std::size_t;
+
+    private:
+        static constexpr size_type cache_line = impl::cache_line_size;
+
+        // the copies start on cache lines only if the storage does
+        std::vector<std::atomic<value_type>, impl::cache_aligned_allocator<std::atomic<value_type>>> node;
+        size_type len = 0;
+        size_type stride = 0; // len + 1 rounded up to a whole number of cache lines
+        size_type actual_size = 0;
+
+        static constexpr bool is_nothrow_op = noexcept(M::op(std::declval<value_type>(), std::declval<value_type>()));
+
+        static void apply(std::atomic<value_type>& a, const value_type& inc) noexcept(is_nothrow_op) {
+            if constexpr (AdditiveMonoid<M>) {
+                a.fetch_add(inc, std::memory_order_relaxed);
+            }
+            else {
+                value_type cur = a.load(std::memory_order_relaxed);
+                while (!a.compare_exchange_weak(cur, M::op(cur, inc), std::memory_order_relaxed))
+                    ;
+            }
+        }
+
+        value_type accumulate_impl(size_type idx) const noexcept(is_nothrow_op) {
+            value_type res = M::unit();
+            for (size_type s = 0; s < Stripes; ++s) {
+                const std::atomic<value_type>* base = node.data() + s * stride;
+                for (size_type i = idx + 1; i > 0; i &= i - 1)
+                    res = M::op(res, base[i].load(std::memory_order_relaxed));
+            }
+
+            return res;
+        }
+
+        static size_type get_parent_idx(size_type idx) noexcept {
+            return idx + (idx & (~idx + 1));
+        }
+
+        void init(size_type _size) {
+            actual_size = _size;
+            len = std::bit_ceil(std::max<size_type>(_size, 1));
+
+            constexpr size_type per_line = std::max<size_type>(cache_line / sizeof(value_type), 1);
+            stride = (Stripes == 1 ? len + 1 : (len + per_line) / per_line * per_line);
+
+            node = decltype(node)(Stripes * stride);
+            for (auto&& e : node)
+                e.store(M::unit(), std::memory_order_relaxed);
+        }
+
+    public:
+        atomic_fenwick_tree() = default;
+        atomic_fenwick_tree(atomic_fenwick_tree&&) = default;
+        atomic_fenwick_tree& operator=(atomic_fenwick_tree&&) = default;
+
+        explicit atomic_fenwick_tree(size_type _size) {
+            init(_size);
+        }
+        explicit atomic_fenwick_tree(const std::vector<value_type>& src) {
+            if (src.size() == 0)
+                return;
+
+            init(src.size());
+
+            std::vector<value_type> tmp(len + 1, M::unit());
+            std::copy(src.begin(), src.end(), tmp.begin() + 1);
+
+            for (size_type i = 1; i < len; ++i) {
+                const size_type par = get_parent_idx(i);
+                tmp[par] = M::op(tmp[par], tmp[i]);
+            }
+
+            for (size_type i = 1; i <= len; ++i)
+                node[i].store(tmp[i], std::memory_order_relaxed);
+        }
+
+        size_type size() const noexcept {
+            return actual_size;
+        }
+
+        bool is_empty() const noexcept {
+            return size() == 0;
+        }
+
+        // update i-th value by applying inc; safe to call from any thread
+        // time complexity: Θ(logN)
+        void append_at(size_type idx, const value_type& inc) noexcept(is_nothrow_op) {
+            if (idx >= size())
+                return;
+
+            std::atomic<value_type>* base = node.data() + (impl::thread_slot() & (Stripes - 1)) * stride;
+            for (size_type i = idx + 1; i <= len; i = get_parent_idx(i))
+                apply(base[i], inc);
+        }
+
+        // accumulate [0, idx], return std::nullopt if the given index is invalid; safe to call from any thread
+        // time complexity: Θ(Stripes logN)
+        std::optional<value_type> accumulate(size_type idx) const noexcept(is_nothrow_op) {
+            if (idx >= size())
+                return std::nullopt;
+
+            return accumulate_impl(idx);
+        }
+
+        // accumulate [l, r), return std::nullopt if the given range is invalid; safe to call from any thread
+        // time complexity: Θ(Stripes logN)
+        // requires: commutative
+        std::optional<value_type> accumulate(size_type l, size_type r) const
+        noexcept(is_nothrow_op && noexcept(M::inv(M::unit())))
+        requires CommutativeGroup<M>
+        {
+            if (l >= size() || r > size() || l >= r)
+                return std::nullopt;
+
+            return M::op(accumulate_impl(r - 1), (l == 0 ? M::unit() : M::inv(accumulate_impl(l - 1))));
+        }
+    };
+
+}
+
+#endif // !ADSL_SEGTREE_ATOMIC_FENWICK_TREE_HPP
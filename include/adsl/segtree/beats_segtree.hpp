@@ -0,0 +1,341 @@
+#ifndef ADSL_SEGTREE_BEATS_SEGTREE_HPP
+#define ADSL_SEGTREE_BEATS_SEGTREE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <concepts>
+#include <algorithm>
+#include <vector>
+#include <optional>
+#include <limits>
+#include <bit>
+
+namespace adsl {
+
+    // a segment tree beats over integers: range chmin, chmax and add with range sum, max and min
+    // clamping is not an endomorphism of the sums, so it cannot be a lazy_segtree action; instead each node keeps
+    // its largest and smallest values, the runner-ups and their counts, and a clamp stops at a node it cannot reach,
+    // tags a node where it only moves the extreme values, and descends otherwise
+    // each descent past a tag merges two distinct values of a node, which bounds the amortized cost
+    // contracts: every value stays in (std::numeric_limits<T>::lowest(), std::numeric_limits<T>::max()),
+    //            which mark the missing runner-ups, and no sum overflows T
+    template <std::signed_integral T = std::int64_t>
+    class beats_segtree {
+    public:
+        using value_type = T;
+        using size_type = std::size_t;
+
+    private:
+        static constexpr value_type lowest = std::numeric_limits<value_type>::lowest();
+        static constexpr value_type highest = std::numeric_limits<value_type>::max();
+
+        struct node_type {
+            value_type sum = 0;
+            value_type max1 = lowest, max2 = lowest; // the largest value and the largest one below it
+            value_type min1 = highest, min2 = highest; // the smallest value and the smallest one above it
+            size_type max_count = 0, min_count = 0;
+            value_type add = 0; // the pending add of the children
+        };
+
+        // heap-indexed nodes of a perfect tree; the leaves past size() are empty and never written
+        std::vector<node_type> node;
+        size_type height = 0;
+        size_type actual_size = 0;
+
+        size_type leaf_offset() const noexcept {
+            return size_type{1} << height;
+        }
+
+        // the number of leaves below k that are not empty
+        size_type length(size_type k) const noexcept {
+            const size_type shift = height + 1 - static_cast<size_type>(std::bit_width(k));
+            const size_type lo = (k << shift) - leaf_offset();
+
+            return (lo >= size() ? 0 : std::min(lo + (size_type{1} << shift), size()) - lo);
+        }
+
+        static void apply_add(node_type& v, value_type x, size_type len) noexcept {
+            v.sum += x * static_cast<value_type>(len);
+            v.max1 += x;
+            v.min1 += x;
+            if (v.max2 != lowest)
+                v.max2 += x;
+            if (v.min2 != highest)
+                v.min2 += x;
+            v.add += x;
+        }
+
+        // contracts: v.max2 < x < v.max1
+        static void apply_chmin(node_type& v, value_type x) noexcept {
+            v.sum += (x - v.max1) * static_cast<value_type>(v.max_count);
+            if (v.min1 == v.max1)
+                v.min1 = x;
+            else if (v.min2 == v.max1)
+                v.min2 = x;
+            v.max1 = x;
+        }
+
+        // contracts: v.min1 < x < v.min2
+        static void apply_chmax(node_type& v, value_type x) noexcept {
+            v.sum += (x - v.min1) * static_cast<value_type>(v.min_count);
+            if (v.max1 == v.min1)
+                v.max1 = x;
+            else if (v.max2 == v.min1)
+                v.max2 = x;
+            v.min1 = x;
+        }
+
+        // hand the add and the clamps of k to its children
+        // contracts: k <- [1, leaf_offset())
+        void push(size_type k) noexcept {
+            node_type& v = node[k];
+
+            // an empty child, the only kind with no largest value, is left as it is so that the add does not move its sentinels
+            auto push_to = [this, &v](size_type c) noexcept {
+                node_type& w = node[c];
+                if (w.max_count == 0)
+                    return;
+
+                if (v.add != 0)
+                    apply_add(w, v.add, length(c));
+                if (w.max1 > v.max1)
+                    apply_chmin(w, v.max1);
+                if (w.min1 < v.min1)
+                    apply_chmax(w, v.min1);
+            };
+
+            push_to(k << 1);
+            push_to((k << 1) + 1);
+            v.add = 0;
+        }
+
+        // contracts: k <- [1, leaf_offset()), the tags of k are handed down
+        void pull(size_type k) noexcept {
+            node_type& v = node[k];
+            const node_type& a = node[k << 1];
+            const node_type& b = node[(k << 1) + 1];
+
+            v.sum = a.sum + b.sum;
+
+            if (a.max1 == b.max1) {
+                v.max1 = a.max1;
+                v.max2 = std::max(a.max2, b.max2);
+                v.max_count = a.max_count + b.max_count;
+            }
+            else if (a.max1 > b.max1) {
+                v.max1 = a.max1;
+                v.max2 = std::max(a.max2, b.max1);
+                v.max_count = a.max_count;
+            }
+            else {
+                v.max1 = b.max1;
+                v.max2 = std::max(a.max1, b.max2);
+                v.max_count = b.max_count;
+            }
+
+            if (a.min1 == b.min1) {
+                v.min1 = a.min1;
+                v.min2 = std::min(a.min2, b.min2);
+                v.min_count = a.min_count + b.min_count;
+            }
+            else if (a.min1 < b.min1) {
+                v.min1 = a.min1;
+                v.min2 = std::min(a.min2, b.min1);
+                v.min_count = a.min_count;
+            }
+            else {
+                v.min1 = b.min1;
+                v.min2 = std::min(a.min1, b.min2);
+                v.min_count = b.min_count;
+            }
+        }
+
+        // clamp the subtree of k from above by x: stop if it reaches no value, tag k if it only moves the largest ones,
+        // and descend otherwise; a leaf has no runner-up, so it is always tagged
+        void all_chmin(size_type k, value_type x) noexcept {
+            node_type& v = node[k];
+            if (v.max1 <= x)
+                return;
+
+            if (v.max2 < x) {
+                apply_chmin(v, x);
+                return;
+            }
+
+            push(k);
+            all_chmin(k << 1, x);
+            all_chmin((k << 1) + 1, x);
+            pull(k);
+        }
+
+        void all_chmax(size_type k, value_type x) noexcept {
+            node_type& v = node[k];
+            if (v.min1 >= x)
+                return;
+
+            if (v.min2 > x) {
+                apply_chmax(v, x);
+                return;
+            }
+
+            push(k);
+            all_chmax(k << 1, x);
+            all_chmax((k << 1) + 1, x);
+            pull(k);
+        }
+
+        // push the tags down along the paths from the root to l and to r - 1, given in heap indices,
+        // stopping above the nodes that [l, r) covers whole
+        void push_bounds(size_type l, size_type r) noexcept {
+            for (size_type i = height; i >= 1; --i) {
+                if (((l >> i) << i) != l)
+                    push(l >> i);
+                if (((r >> i) << i) != r)
+                    push((r - 1) >> i);
+            }
+        }
+
+        void pull_bounds(size_type l, size_type r) noexcept {
+            for (size_type i = 1; i <= height; ++i) {
+                if (((l >> i) << i) != l)
+                    pull(l >> i);
+                if (((r >> i) << i) != r)
+                    pull((r - 1) >> i);
+            }
+        }
+
+        // call all(k) for the nodes covering [l, r) exactly, then recompute their ancestors
+        template <typename F>
+        void update(size_type l, size_type r, F all) noexcept {
+            l += leaf_offset();
+            r += leaf_offset();
+
+            push_bounds(l, r);
+            for (size_type _l = l, _r = r; _l < _r; _l >>= 1, _r >>= 1) {
+                if (_l & 1)
+                    all(_l++);
+                if (_r & 1)
+                    all(--_r);
+            }
+            pull_bounds(l, r);
+        }
+
+        // call f on the nodes covering [l, r) exactly, in no particular order
+        template <typename F>
+        void fold(size_type l, size_type r, F f) noexcept {
+            l += leaf_offset();
+            r += leaf_offset();
+
+            push_bounds(l, r);
+            for (; l < r; l >>= 1, r >>= 1) {
+                if (l & 1)
+                    f(node[l++]);
+                if (r & 1)
+                    f(node[--r]);
+            }
+        }
+
+    public:
+        beats_segtree() = default;
+        beats_segtree(const beats_segtree&) = default;
+        beats_segtree(beats_segtree&&) = default;
+        beats_segtree& operator=(const beats_segtree&) = default;
+        beats_segtree& operator=(beats_segtree&&) = default;
+
+        // every value starts at 0
+        explicit beats_segtree(size_type _size) : beats_segtree(std::vector<value_type>(_size, 0)) {}
+        // time complexity: Θ(N)
+        beats_segtree(const std::vector<value_type>& src) : actual_size(src.size()) {
+            if (src.empty())
+                return;
+
+            height = static_cast<size_type>(std::bit_width(src.size() - 1));
+            node.assign(leaf_offset() * 2, node_type{});
+
+            for (size_type i = 0; i < size(); ++i)
+                node[leaf_offset() + i] = { src[i], src[i], lowest, src[i], highest, 1, 1, 0 };
+
+            // the nodes covering no leaf are pulled from empty children and stay empty
+            for (size_type i = leaf_offset(); i-- > 1; )
+                pull(i);
+        }
+
+        size_type size() const noexcept {
+            return actual_size;
+        }
+
+        bool is_empty() const noexcept {
+            return size() == 0;
+        }
+
+        // replace every value v in [l, r) with min(v, x)
+        // time complexity: amortized Θ(logN), or Θ(log²N) when mixed with add
+        void chmin(size_type l, size_type r, value_type x) noexcept {
+            // once the values are clamped, most clamps reach none of them
+            if (l >= size() || r > size() || l >= r || node[1].max1 <= x)
+                return;
+
+            update(l, r, [this, x](size_type k) noexcept { all_chmin(k, x); });
+        }
+
+        // replace every value v in [l, r) with max(v, x)
+        // time complexity: amortized Θ(logN), or Θ(log²N) when mixed with add
+        void chmax(size_type l, size_type r, value_type x) noexcept {
+            if (l >= size() || r > size() || l >= r || node[1].min1 >= x)
+                return;
+
+            update(l, r, [this, x](size_type k) noexcept { all_chmax(k, x); });
+        }
+
+        // add x to every value in [l, r)
+        // time complexity: Θ(logN)
+        void add(size_type l, size_type r, value_type x) noexcept {
+            if (l >= size() || r > size() || l >= r)
+                return;
+
+            update(l, r, [this, x](size_type k) noexcept { apply_add(node[k], x, length(k)); });
+        }
+
+        // sum [l, r), return std::nullopt if the given range is invalid
+        // time complexity: Θ(logN)
+        std::optional<value_type> sum(size_type l, size_type r) noexcept {
+            if (l >= size() || r > size() || l >= r)
+                return std::nullopt;
+
+            value_type res = 0;
+            fold(l, r, [&res](const node_type& v) noexcept { res += v.sum; });
+            return res;
+        }
+
+        // the largest value in [l, r), return std::nullopt if the given range is invalid
+        // time complexity: Θ(logN)
+        std::optional<value_type> max(size_type l, size_type r) noexcept {
+            if (l >= size() || r > size() || l >= r)
+                return std::nullopt;
+
+            value_type res = lowest;
+            fold(l, r, [&res](const node_type& v) noexcept { res = std::max(res, v.max1); });
+            return res;
+        }
+
+        // the smallest value in [l, r), return std::nullopt if the given range is invalid
+        // time complexity: Θ(logN)
+        std::optional<value_type> min(size_type l, size_type r) noexcept {
+            if (l >= size() || r > size() || l >= r)
+                return std::nullopt;
+
+            value_type res = highest;
+            fold(l, r, [&res](const node_type& v) noexcept { res = std::min(res, v.min1); });
+            return res;
+        }
+
+        // calculate i-th value
+        // time complexity: Θ(logN)
+        std::optional<value_type> calc(size_type idx) noexcept {
+            return sum(idx, idx + 1);
+        }
+    };
+
+}
+
+#endif // !ADSL_SEGTREE_BEATS_SEGTREE_HPP
@@ -0,0 +1,192 @@
+#ifndef ADSL_SEGTREE_BLOCKED_SEGTREE_HPP
+#define ADSL_SEGTREE_BLOCKED_SEGTREE_HPP
+
+#include <cstddef>
+#include <vector>
+#include <concepts>
+#include <algorithm>
+#include <iterator>
+#include <utility>
+#include <optional>
+#include <type_traits>
+#include <span>
+#include <ranges>
+#include "../algebra/data_type.hpp"
+#include "../algebra/type_util.hpp"
+#include "../utility/simd.hpp"
+#include "segtree.hpp"
+
+namespace adsl {
+
+    namespace impl {
+        // two cache lines of values, about as much as a scan reads in the time of one more miss down the tree
+        template <typename T>
+        inline constexpr std::size_t default_block_size = (sizeof(T) >= 128 ? 1 : 128 / sizeof(T));
+    }
+
+    // a segtree whose leaves are blocks of B consecutive values: the values are stored as they are,
+    // and an inner segtree holds the fold of each block
+    // it takes (1 + 2 / B) times the space of the values instead of about 2 times, and drops the lowest log2(B) levels
+    // of the walks in exchange for a scan of at most B values at each end, vectorized for a VectorizableMonoid
+    template <Monoid M, std::size_t B = impl::default_block_size<typename M::value_type>, typename Container = std::vector<typename M::value_type>>
+    requires (
+        std::copyable<typename M::value_type> &&
+        std::same_as<typename Container::value_type, typename M::value_type> &&
+        B > 0 )
+    class blocked_segtree {
+    public:
+        using value_type = M::value_type;
+        using size_type = Container::size_type;
+        using reference = Container::reference;
+        using const_reference = Container::const_reference;
+        using container_type = Container;
+
+        static constexpr size_type block_size = B;
+
+    private:
+        container_type values;
+        segtree<M> blocks;
+        size_type actual_size = 0;
+
+        static constexpr bool use_simd_fold = VectorizableMonoid<M> && std::ranges::contiguous_range<container_type>;
+
+        // the fold of a block can be patched in place of a rescan; floating point is left out, since the rounding errors would pile up
+        static constexpr bool use_group_update = CommutativeGroup<M> && !std::is_floating_point_v<value_type>;
+
+        // fold values[first, last)
+        value_type fold(size_type first, size_type last) const {
+            if constexpr (use_simd_fold) {
+                const value_type* data = std::ranges::data(values);
+                return impl::simd_fold<M>(data + first, data + last);
+            }
+            else {
+                value_type res = M::unit();
+                for (size_type i = first; i < last; ++i)
+                    res = M::op(res, values[i]);
+
+                return res;
+            }
+        }
+
+        size_type block_count() const noexcept {
+            return (size() + B - 1) / B;
+        }
+
+        // the fold of the whole block k
+        value_type fold_block(size_type k) const {
+            return fold(k * B, std::min((k + 1) * B, size()));
+        }
+
+        void build() {
+            std::vector<value_type> src;
+            src.reserve(block_count());
+            for (size_type k = 0; k < block_count(); ++k)
+                src.push_back(fold_block(k));
+
+            blocks = segtree<M>(src);
+        }
+
+    public:
+        blocked_segtree() = default;
+        blocked_segtree(const blocked_segtree&) = default;
+        blocked_segtree(blocked_segtree&&) = default;
+        blocked_segtree& operator=(const blocked_segtree&) = default;
+        blocked_segtree& operator=(blocked_segtree&&) = default;
+
+        explicit blocked_segtree(size_type _size) : values(_size, M::unit()), actual_size(_size) {
+            blocks = segtree<M>(std::vector<value_type>(block_count(), M::unit()));
+        }
+        // time complexity: Θ(N)
+        blocked_segtree(const container_type& src) : values(src), actual_size(src.size()) {
+            build();
+        }
+
+        size_type size() const noexcept {
+            return actual_size;
+        }
+
+        bool is_empty() const noexcept {
+            return size() == 0;
+        }
+
+        // update i-th value with updater(i-th value)
+        // time complexity: Θ(B + log(N / B)), or Θ(log(N / B)) for a commutative group that is not floating point
+        template <typename F>
+        void update(size_type idx, F&& updater)
+        requires requires { {updater(std::declval<value_type>())} -> std::convertible_to<value_type>; }
+        {
+            if (idx >= size())
+                return;
+
+            if constexpr (use_group_update) {
+                const value_type diff = M::op(updater(values[idx]), M::inv(values[idx]));
+
+                values[idx] = M::op(values[idx], diff);
+                blocks.update(idx / B, [&diff](const value_type& v) { return M::op(v, diff); });
+            }
+            else {
+                values[idx] = updater(values[idx]);
+                blocks.set(idx / B, fold_block(idx / B));
+            }
+        }
+
+        // time complexity: Θ(B + log(N / B)), or Θ(log(N / B)) for a commutative group that is not floating point
+        void set(size_type idx, const_reference v) {
+            update(idx, [=, &v](auto&&) noexcept { return v; });
+        }
+
+        // calculate i-th value
+        // time complexity: Θ(1)
+        std::optional<value_type> calc(size_type idx) const {
+            if (idx >= size())
+                return std::nullopt;
+
+            return values[idx];
+        }
+
+        // accumulate [l, r), return std::nullopt if the given range is invalid
+        // the partial blocks at the ends are scanned, the whole blocks between them are folded by the inner segtree
+        // time complexity: Θ(B + log(N / B))
+        std::optional<value_type> accumulate(size_type l, size_type r) const {
+            if (l >= size() || r > size() || l >= r)
+                return std::nullopt;
+
+            const size_type lb = l / B, rb = (r - 1) / B;
+            if (lb == rb)
+                return fold(l, r);
+
+            value_type res = fold(l, (lb + 1) * B);
+            if (lb + 1 < rb)
+                res = M::op(res, *blocks.accumulate(lb + 1, rb));
+
+            return M::op(res, fold(rb * B, r));
+        }
+
+        // the fold of every value
+        // time complexity: Θ(log(N / B))
+        std::optional<value_type> accumulate_all() const {
+            if (is_empty())
+                return std::nullopt;
+
+            return blocks.accumulate(0, block_count());
+        }
+
+        // a read-only view of the values in index order, which stays valid until the tree is destroyed or reassigned
+        auto leaves() const {
+            if constexpr (std::ranges::contiguous_range<const container_type>)
+                return std::span<const value_type>(std::ranges::data(values), size());
+            else
+                return std::views::all(values);
+        }
+
+        // write every value to out in index order
+        // time complexity: Θ(N)
+        template <std::output_iterator<const value_type&> OutputIt>
+        OutputIt materialize(OutputIt out) const {
+            return std::ranges::copy(leaves(), std::move(out)).out;
+        }
+    };
+
+}
+
+#endif // !ADSL_SEGTREE_BLOCKED_SEGTREE_HPP
@@ -0,0 +1,184 @@
+#ifndef ADSL_SEGTREE_CONCURRENT_SEGTREE_HPP
+#define ADSL_SEGTREE_CONCURRENT_SEGTREE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <concepts>
+#include <algorithm>
+#include <optional>
+#include <type_traits>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <bit>
+#include "../algebra/data_type.hpp"
+#include "../algebra/type_util.hpp"
+#include "../utility/parallel.hpp"
+#include "../utility/seqlock.hpp"
+
+namespace adsl {
+
+    // a segment tree that many threads may query and update at once
+    // the leaves are split into shards, each a small segment tree with its own mutex and seqlock:
+    //   - update / set lock only the shard holding the index, so writers to different shards never contend
+    //   - accumulate takes no lock; it opens the seqlock of every shard it touches, folds them, and retries
+    //     if a writer published to any of those shards in the meantime
+    // consistency: a query reads a snapshot; there is a moment during the call at which every shard it touches
+    //   held exactly the values it folded, so a value never appears half-updated and no update is seen without
+    //   an update to another shard that happened-before it
+    // progress: readers never block writers, but they are not wait-free; a reader waits out a write in progress and
+    //   retries while writers keep publishing to its shards, so a wide query under heavy writes may retry many times
+    // M::op must not throw, and must accept the (discarded) result of combining values read during a write
+    template <Monoid M>
+    requires std::is_trivially_copyable_v<typename M::value_type>
+    class concurrent_segtree {
+    public:
+        using value_type = M::value_type;
+        using size_type = std::size_t;
+
+    private:
+        // a local heap: the root is 1 and the leaves are [leaf_count, 2 * leaf_count)
+        struct alignas(64) shard {
+            impl::seqlock seq;
+            std::mutex lock;
+            std::vector<value_type> node;
+        };
+
+        std::unique_ptr<shard[]> shards;
+        size_type shard_total = 0;
+        size_type leaf_count = 0; // per shard, a power of two
+        size_type leaf_shift = 0;
+        size_type actual_size = 0;
+
+        void init(size_type _size, size_type _shard_count) {
+            actual_size = _size;
+            if (_size == 0)
+                return;
+
+            shard_total = impl::pow2_thread_count(_shard_count, std::bit_ceil(_size));
+            leaf_count = std::bit_ceil(_size) / shard_total;
+            leaf_shift = static_cast<size_type>(std::countr_zero(leaf_count));
+
+            shards = std::make_unique<shard[]>(shard_total);
+            for (size_type i = 0; i < shard_total; ++i)
+                shards[i].node.assign(leaf_count << 1, M::unit());
+        }
+
+        // fold the local leaves [l, r) of s, l < r; the result may be torn unless the seqlock validates
+        value_type fold_shard(const shard& s, size_type l, size_type r) const noexcept {
+            const value_type* node = s.node.data();
+
+            value_type res_l = M::unit(), res_r = M::unit();
+            for (size_type lo = l + leaf_count, hi = r + leaf_count; lo < hi; lo >>= 1, hi >>= 1) {
+                if (lo & 1)
+                    res_l = M::op(res_l, impl::racy_load(node[lo++]));
+                if (hi & 1)
+                    res_r = M::op(impl::racy_load(node[hi - 1]), res_r);
+            }
+
+            return M::op(res_l, res_r);
+        }
+
+    public:
+        concurrent_segtree() = default;
+        concurrent_segtree(concurrent_segtree&&) = default;
+        concurrent_segtree& operator=(concurrent_segtree&&) = default;
+
+        // shard_count is rounded down to a power of two; 0 means std::thread::hardware_concurrency()
+        explicit concurrent_segtree(size_type _size, size_type _shard_count = 0) {
+            init(_size, _shard_count);
+        }
+        explicit concurrent_segtree(const std::vector<value_type>& src, size_type _shard_count = 0) {
+            init(src.size(), _shard_count);
+
+            for (size_type i = 0; i < src.size(); ++i)
+                shards[i >> leaf_shift].node[(i & (leaf_count - 1)) + leaf_count] = src[i];
+
+            for (size_type i = 0; i < shard_total; ++i) {
+                std::vector<value_type>& node = shards[i].node;
+                for (size_type idx = leaf_count - 1; idx > 0; --idx)
+                    node[idx] = M::op(node[idx << 1], node[(idx << 1) + 1]);
+            }
+        }
+
+        size_type size() const noexcept {
+            return actual_size;
+        }
+
+        bool is_empty() const noexcept {
+            return size() == 0;
+        }
+
+        size_type shard_count() const noexcept {
+            return shard_total;
+        }
+
+        // update i-th value with updater(i-th value); safe to call from any thread
+        // the updater runs under the shard's mutex, before readers are held off
+        // time complexity: Θ(log(N / S))
+        template <typename F>
+        void update(size_type idx, F&& updater)
+        requires requires { {updater(std::declval<value_type>())} -> std::convertible_to<value_type>; }
+        {
+            if (idx >= size())
+                return;
+
+            shard& s = shards[idx >> leaf_shift];
+            value_type* node = s.node.data();
+            idx = (idx & (leaf_count - 1)) + leaf_count;
+
+            // only writers store to node and they hold the lock, so plain loads see the latest values
+            std::scoped_lock guard(s.lock);
+            const value_type v = updater(node[idx]);
+
+            s.seq.write_begin();
+            impl::racy_store(node[idx], v);
+            while (idx >>= 1)
+                impl::racy_store(node[idx], M::op(node[idx << 1], node[(idx << 1) + 1]));
+            s.seq.write_end();
+        }
+
+        // time complexity: Θ(log(N / S))
+        void set(size_type idx, const value_type& v) {
+            update(idx, [&v](auto&&) noexcept { return v; });
+        }
+
+        // accumulate [l, r), return std::nullopt if the given range is invalid; safe to call from any thread
+        // time complexity: Θ(log(N / S) + S) for a range over every shard, Θ(log(N / S)) inside one shard
+        std::optional<value_type> accumulate(size_type l, size_type r) const noexcept {
+            if (l >= size() || r > size() || l >= r)
+                return std::nullopt;
+
+            const size_type first = l >> leaf_shift, last = (r - 1) >> leaf_shift;
+            const size_type mask = leaf_count - 1;
+
+            for (;;) {
+                // every shard is opened before any is read, so the shards all held what was read
+                // between the last read_begin and the fence, if none of them was written meanwhile
+                std::uint64_t begun = 0;
+                for (size_type i = first; i <= last; ++i)
+                    begun += shards[i].seq.read_begin();
+
+                value_type res = fold_shard(shards[first], l & mask, (first == last ? ((r - 1) & mask) + 1 : leaf_count));
+                if (first != last) {
+                    for (size_type i = first + 1; i < last; ++i)
+                        res = M::op(res, impl::racy_load(shards[i].node[1]));
+                    res = M::op(res, fold_shard(shards[last], 0, ((r - 1) & mask) + 1));
+                }
+
+                std::atomic_thread_fence(std::memory_order_acquire);
+
+                std::uint64_t current = 0;
+                for (size_type i = first; i <= last; ++i)
+                    current += shards[i].seq.read_current();
+
+                if (current == begun)
+                    return res;
+            }
+        }
+    };
+
+}
+
+#endif // !ADSL_SEGTREE_CONCURRENT_SEGTREE_HPP
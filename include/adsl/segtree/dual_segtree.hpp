@@ -3,12 +3,31 @@
 
 #include "../algebra/data_type.hpp"
 #include "../algebra/type_util.hpp"
+#include "layout.hpp"
+#include "../utility/prefetch.hpp"
+#include "../utility/stats.hpp"
 #include <utility>
 #include <vector>
+#include <optional>
+#include <iterator>
+#include <span>
+#include <memory>
+#include <cstdint>
+#include <bit>
 
 namespace adsl {
 
-    template <Monoid M, typename Container = std::vector<typename M::value_type>>
+    namespace impl {
+        struct snapshot_access;
+    }
+
+    // the tag of a node is never older than a tag below it: append hands the tags on the paths to both ends down first,
+    // so the nodes it writes have no tag above them; a value is therefore its leaf folded with the tags above it, bottom-up,
+    // which reads do without writing
+    // a commutative M needs no such order, so append skips the hand-down as well
+    // Stats is told of every monoid op, node access and hand-down made by the operations, which stats() reports;
+    // the default null_stats compiles all of it away
+    template <Monoid M, typename Container = std::vector<typename M::value_type>, SegtreeLayout Layout = binary_heap_layout, StatsPolicy Stats = null_stats>
     requires (
         std::copyable<typename M::value_type> &&
         std::same_as<typename Container::value_type, typename M::value_type> )
@@ -19,37 +38,113 @@ namespace adsl {
         using reference = Container::reference;
         using const_reference = Container::const_reference;
         using container_type = Container;
+        using layout_type = Layout;
+        using stats_type = Stats;
     
     private:
+        friend struct impl::snapshot_access;
+
         container_type node;
+        layout_type layout;
         size_type actual_size = 0;
-        size_type height = 0;
 
-        // contracts: idx <- [0, node.size() / 2)
-        void prop_at(size_type idx) noexcept(noexcept(M::op(std::declval<value_type>(), std::declval<value_type>()))) {
-            node[idx << 1] = M::op(node[idx << 1], node[idx]);
-            node[(idx << 1) + 1] = M::op(node[(idx << 1) + 1], node[idx]);
+        [[no_unique_address]] stats_type statistics;
 
-            node[idx] = M::unit();
+        // access a node by its heap index
+        reference at(size_type idx) noexcept(noexcept(node[idx])) {
+            return node[layout.pos(idx)];
+        }
+        const_reference at(size_type idx) const noexcept(noexcept(node[idx])) {
+            return node[layout.pos(idx)];
         }
 
+        static constexpr bool is_nothrow_op = noexcept(M::op(std::declval<value_type>(), std::declval<value_type>()));
+
+        value_type op(const value_type& x, const value_type& y) const noexcept(is_nothrow_op) {
+            statistics.count(tree_stat::op);
+            return M::op(x, y);
+        }
+
+        // contracts: idx <- [0, layout.leaf_offset())
+        void prop_at(size_type idx) noexcept(is_nothrow_op) {
+            statistics.count(tree_stat::propagation);
+            statistics.count(tree_stat::node_read, 3);
+            statistics.count(tree_stat::node_write, 3);
+
+            at(idx << 1) = op(at(idx << 1), at(idx));
+            at((idx << 1) + 1) = op(at((idx << 1) + 1), at(idx));
+
+            at(idx) = M::unit();
+        }
+
+        // calc_batch prefetches the lowest prefetch_levels nodes on the path of the read prefetch_distance ahead
+        static constexpr size_type prefetch_distance = 6;
+        static constexpr size_type prefetch_levels = 8;
+
         void prop_to(size_type idx) noexcept(noexcept(prop_at(idx))) {
-            for (size_type i = height; i >= 1; --i)
+            for (size_type i = layout.height(); i >= 1; --i)
                 prop_at(idx >> i);
         }
 
+        // the tags of the heap index x and its ancestors folded bottom-up
+        value_type calc_leaf(size_type x) const noexcept(std::is_nothrow_copy_constructible_v<value_type> && is_nothrow_op) {
+            statistics.count(tree_stat::node_read, static_cast<std::uint64_t>(std::bit_width(x)));
+
+            value_type res = at(x);
+            for (size_type i = x >> 1; i > 0; i >>= 1)
+                res = op(res, at(i));
+
+            return res;
+        }
+
+        // acc[i] = calc_leaf(i) for every inner node i that covers a leaf, acc[0] = M::unit()
+        std::vector<value_type> fold_all() const {
+            std::vector<value_type> acc(layout.leaf_offset(), M::unit());
+            if constexpr (Layout::perfect) {
+                const size_type last_leaf = layout.leaf_offset() + size() - 1;
+
+                for (size_type d = 0; d < layout.height(); ++d) {
+                    const size_type last = (last_leaf >> (layout.height() - d)) + 1;
+                    statistics.count(tree_stat::node_read, last - (size_type{1} << d));
+                    for (size_type i = size_type{1} << d; i < last; ++i)
+                        acc[i] = op(at(i), acc[i >> 1]);
+                }
+            }
+            else {
+                statistics.count(tree_stat::node_read, layout.leaf_offset() - 1);
+                for (size_type i = 1; i < layout.leaf_offset(); ++i)
+                    acc[i] = op(at(i), acc[i >> 1]);
+            }
+
+            return acc;
+        }
+
+        // hand every tag down to the leaves, parents before children, skipping the nodes that cover no leaf
+        void prop_all() noexcept(noexcept(prop_at(0))) {
+            if constexpr (Layout::perfect) {
+                const size_type last_leaf = layout.leaf_offset() + size() - 1;
+
+                for (size_type d = 0; d < layout.height(); ++d) {
+                    const size_type last = (last_leaf >> (layout.height() - d)) + 1;
+                    for (size_type i = size_type{1} << d; i < last; ++i)
+                        prop_at(i);
+                }
+            }
+            else {
+                for (size_type i = 1; i < layout.leaf_offset(); ++i)
+                    prop_at(i);
+            }
+        }
+
     public:
         dual_segtree() = default;
         dual_segtree(const dual_segtree&) = default;
+        dual_segtree(dual_segtree&&) = default;
+        dual_segtree& operator=(const dual_segtree&) = default;
+        dual_segtree& operator=(dual_segtree&&) = default;
 
-        explicit dual_segtree(size_type _size) : actual_size(_size) {
-            size_type len = 1;
-            while (len < _size) {
-                len <<= 1;
-                ++height;
-            }
-
-            node = container_type(len * 2, M::unit());
+        explicit dual_segtree(size_type _size) : layout(_size), actual_size(_size) {
+            node = container_type(layout.storage_size(), M::unit());
         }
 
         size_type size() const noexcept {
@@ -60,25 +155,45 @@ namespace adsl {
             return size() == 0;
         }
 
+        // the counts kept by Stats since construction or the last reset_stats()
+        tree_stats stats() const noexcept {
+            return statistics.snapshot();
+        }
+
+        void reset_stats() noexcept {
+            statistics.reset();
+        }
+
         // update [l, r) by applying inc
         // time complexity: Θ(logN)
-        void append(size_type l, size_type r, const_reference inc) noexcept(noexcept(M::op(std::declval<value_type>(), std::declval<value_type>()), prop_to(l))) {
+        void append(size_type l, size_type r, const_reference inc) noexcept(is_nothrow_op) {
             if (l >= size() || r > size() || l >= r)
                 return;
 
-            l += node.size() / 2;
-            r += node.size() / 2;
+            statistics.begin_operation();
+
+            l += layout.leaf_offset();
+            r += layout.leaf_offset();
 
-            prop_to(l);
-            prop_to(r - 1);
+            if constexpr (!CommutativeMonoid<M>) {
+                prop_to(l);
+                prop_to(r - 1);
+            }
 
             while (l < r) {
                 if (l & 1) {
-                    node[l] = M::op(node[l], inc);
+                    statistics.count(tree_stat::node_read);
+                    statistics.count(tree_stat::node_write);
+
+                    at(l) = op(at(l), inc);
                     ++l;
                 }
-                if (r & 1)
-                    node[r - 1] = M::op(node[r - 1], inc);
+                if (r & 1) {
+                    statistics.count(tree_stat::node_read);
+                    statistics.count(tree_stat::node_write);
+
+                    at(r - 1) = op(at(r - 1), inc);
+                }
                 
                 l >>= 1;
                 r >>= 1;
@@ -87,14 +202,92 @@ namespace adsl {
 
         // calculate i-th value
         // time complexity: Θ(logN)
-        std::optional<value_type> calc(size_type idx) noexcept(std::is_nothrow_move_constructible_v<value_type> && noexcept(prop_to(idx))) {
+        std::optional<value_type> calc(size_type idx) const noexcept(std::is_nothrow_copy_constructible_v<value_type> && is_nothrow_op) {
             if (idx >= size())
                 return std::nullopt;
 
-            idx += node.size() / 2;
+            statistics.begin_operation();
+
+            return calc_leaf(layout.leaf_offset() + idx);
+        }
+
+        // calculate every value in index order, folding the tags top-down once
+        // time complexity: Θ(N)
+        std::vector<value_type> calc_all() const {
+            statistics.begin_operation();
+
+            std::vector<value_type> res;
+            if (is_empty())
+                return res;
+
+            const std::vector<value_type> acc = fold_all();
+
+            statistics.count(tree_stat::node_read, size());
+            res.reserve(size());
+            for (size_type i = layout.leaf_offset(); i < layout.leaf_offset() + size(); ++i)
+                res.push_back(op(at(i), acc[i >> 1]));
+
+            return res;
+        }
+
+        // calculate the value at every index of indices, or std::nullopt for the invalid ones, in the given order
+        // a batch large enough to reach most nodes folds every tag top-down once, as calc_all does;
+        // a smaller one is read one index at a time, prefetching the lower nodes on the path of a later read,
+        // which are the ones that miss the cache on a large tree
+        // time complexity: Θ(min(KlogN, N + K)) for K indices
+        std::vector<std::optional<value_type>> calc_batch(std::span<const size_type> indices) const {
+            std::vector<std::optional<value_type>> res(indices.size());
+            if (is_empty())
+                return res;
+
+            if (indices.size() * layout.height() >= size()) {
+                const std::vector<value_type> acc = fold_all();
+                for (size_type k = 0; k < indices.size(); ++k) {
+                    if (indices[k] < size()) {
+                        statistics.begin_operation();
+
+                        const size_type x = layout.leaf_offset() + indices[k];
+
+                        statistics.count(tree_stat::node_read);
+                        res[k] = op(at(x), acc[x >> 1]);
+                    }
+                }
+
+                return res;
+            }
+
+            for (size_type k = 0; k < indices.size(); ++k) {
+                if (k + prefetch_distance < indices.size() && indices[k + prefetch_distance] < size()) {
+                    const size_type y = layout.leaf_offset() + indices[k + prefetch_distance];
+                    for (size_type d = 0; d < prefetch_levels && (y >> d) > 0; ++d)
+                        prefetch(std::addressof(at(y >> d)));
+                }
+
+                if (indices[k] < size()) {
+                    statistics.begin_operation();
+                    res[k] = calc_leaf(layout.leaf_offset() + indices[k]);
+                }
+            }
+
+            return res;
+        }
+
+        // write every value to out in index order, after handing all the tags down to the leaves in one sweep
+        // time complexity: Θ(N)
+        template <std::output_iterator<const value_type&> OutputIt>
+        OutputIt materialize(OutputIt out) {
+            statistics.begin_operation();
+
+            if (is_empty())
+                return out;
+
+            prop_all();
+
+            statistics.count(tree_stat::node_read, size());
+            for (size_type i = 0; i < size(); ++i, ++out)
+                *out = at(layout.leaf_offset() + i);
 
-            prop_to(idx);
-            return node[idx];
+            return out;
         }
 
     };
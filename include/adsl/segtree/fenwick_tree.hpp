@@ -3,13 +3,29 @@
 
 #include <vector>
 #include <optional>
+#include <algorithm>
+#include <iterator>
+#include <functional>
+#include <concepts>
+#include <utility>
+#include <span>
+#include <bit>
 #include "../algebra/data_type.hpp"
 #include "../algebra/type_util.hpp"
 #include "../utility/concepts.hpp"
+#include "../utility/parallel.hpp"
+#include "../utility/radix_sort.hpp"
+#include "../utility/stats.hpp"
 
 namespace adsl {
 
-    template <CommutativeMonoid M, typename Container = std::vector<typename M::value_type>>
+    namespace impl {
+        struct snapshot_access;
+    }
+
+    // Stats is told of every monoid op and node access made by the operations, so node_reads and node_writes measure
+    // the lengths of the walks; stats() reports them, and the default null_stats compiles all of it away
+    template <CommutativeMonoid M, typename Container = std::vector<typename M::value_type>, StatsPolicy Stats = null_stats>
     requires (
         std::copyable<typename M::value_type> &&
         std::same_as<typename Container::value_type, typename M::value_type> )
@@ -20,22 +36,42 @@ namespace adsl {
         using reference = Container::reference;
         using const_reference = Container::const_reference;
         using container_type = Container;
+        using stats_type = Stats;
 
     private:
+        friend struct impl::snapshot_access;
+
         container_type node;
         size_type actual_size = 0;
 
+        [[no_unique_address]] stats_type statistics;
+
         static constexpr bool is_nothrow_unit = noexcept(M::unit());
         static constexpr bool is_nothrow_op = noexcept(M::op(std::declval<value_type>(), std::declval<value_type>()));
 
+        value_type op(const value_type& x, const value_type& y) const noexcept(is_nothrow_op) {
+            statistics.count(tree_stat::op);
+            return M::op(x, y);
+        }
+
         value_type accumulate_impl(size_type idx) const noexcept(is_nothrow_unit && is_nothrow_op) {
             value_type res = M::unit();
-            for (size_type i = idx + 1; i > 0; i &= i - 1)
-                res = M::op(res, node[i]);
+            for (size_type i = idx + 1; i > 0; i &= i - 1) {
+                statistics.count(tree_stat::node_read);
+                res = op(res, node[i]);
+            }
             
             return res;
         }
 
+        void append_impl(size_type idx, const_reference inc) noexcept(is_nothrow_op) {
+            for (size_type i = idx + 1; i < node.size(); i = get_parent_idx(i)) {
+                statistics.count(tree_stat::node_read);
+                statistics.count(tree_stat::node_write);
+                node[i] = op(node[i], inc);
+            }
+        }
+
         size_type get_parent_idx(size_type idx) const noexcept {
             return idx + (idx & (~idx + 1));
         }
@@ -43,6 +79,9 @@ namespace adsl {
     public:
         fenwick_tree() = default;
         fenwick_tree(const fenwick_tree&) = default;
+        fenwick_tree(fenwick_tree&&) = default;
+        fenwick_tree& operator=(const fenwick_tree&) = default;
+        fenwick_tree& operator=(fenwick_tree&&) = default;
 
         explicit fenwick_tree(size_type _size) : actual_size(_size) {
             size_type len = 1;
@@ -61,15 +100,58 @@ namespace adsl {
             
             node = container_type(len + 1, M::unit());
 
-            for (size_type i = 0; i + 1 < len; ++i) {
-                if (i < src.size())
-                    node[i + 1] = M::op(node[i + 1], src[i]);
+            auto it = node.begin();
+            std::advance(it, 1);
+
+            std::copy(src.begin(), src.end(), it);
+
+            for (size_type i = 1; i < len; ++i) {
+                const size_type par = get_parent_idx(i);
+                node[par] = M::op(node[par], node[i]);
+            }
+        }
+
+        // build blocks of the tree on separate threads, then link the ends of the blocks serially
+        // thread_count = 0 means std::thread::hardware_concurrency()
+        // time complexity: Θ(N / thread_count + thread_count)
+        fenwick_tree(const container_type& src, size_type thread_count) : actual_size(src.size()) {
+            if (src.size() == 0)
+                return;
+
+            size_type len = 1;
+            while (len < src.size())
+                len <<= 1;
+
+            node = container_type(len + 1, M::unit());
+
+            const size_type parts = impl::pow2_thread_count(thread_count, len);
+            const size_type part_len = len / parts;
 
-                const size_type par = get_parent_idx(i + 1);
-                node[par] = M::op(node[par], node[i + 1]);
+            // a node inside a block other than its last one has its parent in the same block
+            impl::parallel_for(parts, [&](size_type p) {
+                const size_type lo = p * part_len, hi = lo + part_len;
+
+                if (lo < src.size()) {
+                    auto first = src.begin(), last = src.begin();
+                    std::advance(first, lo);
+                    std::advance(last, std::min(hi, src.size()));
+
+                    auto it = node.begin();
+                    std::advance(it, lo + 1);
+
+                    std::copy(first, last, it);
+                }
+
+                for (size_type i = lo + 1; i < hi; ++i) {
+                    const size_type par = get_parent_idx(i);
+                    node[par] = M::op(node[par], node[i]);
+                }
+            });
+
+            for (size_type i = part_len; i < len; i += part_len) {
+                const size_type par = get_parent_idx(i);
+                node[par] = M::op(node[par], node[i]);
             }
-            if (len == src.size())
-                node[len] = M::op(node[len], src.back());
         }
 
         size_type size() const noexcept {
@@ -80,14 +162,98 @@ namespace adsl {
             return size() == 0;
         }
 
+        // the counts kept by Stats since construction or the last reset_stats()
+        tree_stats stats() const noexcept {
+            return statistics.snapshot();
+        }
+
+        void reset_stats() noexcept {
+            statistics.reset();
+        }
+
         // update i-th value by applying inc
         // time complexity: Θ(logN)
         void append_at(size_type idx, const_reference inc) noexcept(is_nothrow_op) {
             if (idx >= size())
                 return;
 
-            for (size_type i = idx + 1; i < node.size(); i = get_parent_idx(i))
-                node[i] = M::op(node[i], inc);
+            statistics.begin_operation();
+            append_impl(idx, inc);
+        }
+
+        // update the value at idx by applying inc for every (idx, inc) in incs; invalid indices are skipped
+        // the increments meeting at a node are combined first, so each node is written once
+        // a batch large enough to touch most nodes pushes a dense array of increments up in one pass;
+        // a smaller one is sorted, then each index climbs only below the next one, leaving its sum at the node it stopped at,
+        // which lies on the path of the next index since it covers both
+        // time complexity: Θ(min(KlogN, N + K)) for K increments
+        void append_at_batch(std::span<const std::pair<size_type, value_type>> incs) {
+            if (is_empty())
+                return;
+
+            const size_type len = node.size() - 1;
+
+            if (incs.size() * static_cast<size_type>(std::bit_width(len)) >= len) {
+                std::vector<value_type> delta(len + 1, M::unit());
+                for (const auto& [idx, inc] : incs) {
+                    if (idx < size()) {
+                        statistics.begin_operation();
+                        delta[idx + 1] = op(delta[idx + 1], inc);
+                    }
+                }
+
+                statistics.count(tree_stat::node_read, len);
+                statistics.count(tree_stat::node_write, len);
+                for (size_type i = 1; i <= len; ++i) {
+                    node[i] = op(node[i], delta[i]);
+
+                    const size_type par = get_parent_idx(i);
+                    if (par <= len)
+                        delta[par] = op(delta[par], delta[i]);
+                }
+
+                return;
+            }
+
+            // the positions in incs of the valid increments, ordered by node index
+            std::vector<size_type> order;
+            order.reserve(incs.size());
+            for (size_type k = 0; k < incs.size(); ++k) {
+                if (incs[k].first < size()) {
+                    statistics.begin_operation();
+                    order.push_back(k);
+                }
+            }
+            impl::radix_sort(order, static_cast<int>(std::bit_width(len)), [&](size_type k) noexcept { return incs[k].first; });
+
+            // the sums left behind, all on the path of the current index, the lowest node at the back
+            std::vector<std::pair<size_type, value_type>> carry;
+
+            for (size_type m = 0; m < order.size(); ) {
+                size_type i = incs[order[m]].first + 1;
+                value_type inc = incs[order[m]].second;
+                for (++m; m < order.size() && incs[order[m]].first + 1 == i; ++m)
+                    inc = op(inc, incs[order[m]].second);
+
+                const size_type next = (m < order.size() ? incs[order[m]].first + 1 : len + 1);
+                for (; i < next; i = get_parent_idx(i)) {
+                    if (!carry.empty() && carry.back().first == i) {
+                        inc = op(inc, carry.back().second);
+                        carry.pop_back();
+                    }
+
+                    statistics.count(tree_stat::node_read);
+                    statistics.count(tree_stat::node_write);
+                    node[i] = op(node[i], inc);
+                }
+
+                if (i <= len) {
+                    if (!carry.empty() && carry.back().first == i)
+                        carry.back().second = op(carry.back().second, inc);
+                    else
+                        carry.emplace_back(i, std::move(inc));
+                }
+            }
         }
 
         // accumulate [0, idx], return std::nullopt if the given index is invalid
@@ -96,6 +262,7 @@ namespace adsl {
             if (idx >= size())
                 return std::nullopt;
 
+            statistics.begin_operation();
             return accumulate_impl(idx);
         }
         
@@ -109,7 +276,8 @@ namespace adsl {
             if (l >= size() || r > size() || l >= r)
                 return std::nullopt;
 
-            return M::op(accumulate_impl(r - 1), (l == 0 ? M::unit() : M::inv(accumulate_impl(l - 1))));
+            statistics.begin_operation();
+            return op(accumulate_impl(r - 1), (l == 0 ? M::unit() : M::inv(accumulate_impl(l - 1))));
         }
 
         // calculate i-th value
@@ -133,22 +301,52 @@ namespace adsl {
         {
             if (idx >= size())
                 return;
-            
-            const value_type cur_val = M::op(accumulate_impl(idx), (idx == 0 ? M::unit() : M::inv(accumulate_impl(idx - 1))));
+
+            statistics.begin_operation();
+            const value_type cur_val = op(accumulate_impl(idx), (idx == 0 ? M::unit() : M::inv(accumulate_impl(idx - 1))));
             const value_type new_val = updater(cur_val);
 
-            append_at(idx, M::op(new_val, M::inv(cur_val)));
+            append_impl(idx, op(new_val, M::inv(cur_val)));
         }
 
         // time complexity: Θ(logN)
         // requires: commutative
         void set(size_type idx, const_reference v)
-        noexcept(noexcept(this->update(idx, [=, &v](auto&&) noexcept { return v; })))
+        noexcept(noexcept(this->update(idx, [](const value_type& x) noexcept { return x; })))
         requires CommutativeGroup<M>
         {
             update(idx, [=, &v](auto&&) noexcept { return v; });
         }
 
+        // return the smallest idx such that accumulate(idx) is not less than value, or size() if there is none
+        // contracts: accumulate(0), accumulate(1), ... is sorted with respect to comp, e.g. sums of non-negative values
+        // time complexity: Θ(logN)
+        template <typename Compare = std::less<>>
+        requires std::strict_weak_order<Compare&, const value_type&, const value_type&>
+        size_type lower_bound(const value_type& value, Compare comp = {}) const {
+            statistics.begin_operation();
+
+            if (node.size() <= 1)
+                return size();
+
+            // node[pos + step] covers (pos, pos + step], so each step decides one bit of the answer
+            size_type pos = 0;
+            value_type acc = M::unit();
+            for (size_type step = std::bit_floor(node.size() - 1); step > 0; step >>= 1) {
+                if (pos + step > size())
+                    continue;
+
+                statistics.count(tree_stat::node_read);
+                value_type next = op(acc, node[pos + step]);
+                if (comp(std::as_const(next), value)) {
+                    acc = std::move(next);
+                    pos += step;
+                }
+            }
+
+            return pos;
+        }
+
     };
 
 }
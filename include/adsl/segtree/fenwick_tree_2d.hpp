@@ -0,0 +1,300 @@
+#ifndef ADSL_SEGTREE_FENWICK_TREE_2D_HPP
+#define ADSL_SEGTREE_FENWICK_TREE_2D_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <optional>
+#include <algorithm>
+#include <concepts>
+#include <utility>
+#include <span>
+#include <ranges>
+#include "../algebra/data_type.hpp"
+#include "../algebra/type_util.hpp"
+#include "../utility/concepts.hpp"
+#include "../utility/compressor.hpp"
+
+namespace adsl {
+
+    // a fenwick tree over a rows x cols grid, stored row-major in one contiguous block of (rows + 1) * (cols + 1) nodes
+    template <CommutativeMonoid M>
+    requires std::copyable<typename M::value_type>
+    class fenwick_tree_2d {
+    public:
+        using value_type = M::value_type;
+        using size_type = std::size_t;
+
+    private:
+        std::vector<value_type> node;
+        size_type row_count = 0, col_count = 0;
+
+        static constexpr bool is_nothrow_op = noexcept(M::op(std::declval<value_type>(), std::declval<value_type>()));
+
+        value_type& at(size_type i, size_type j) noexcept {
+            return node[i * (col_count + 1) + j];
+        }
+        const value_type& at(size_type i, size_type j) const noexcept {
+            return node[i * (col_count + 1) + j];
+        }
+
+        // accumulate [0, r) x [0, c)
+        value_type accumulate_impl(size_type r, size_type c) const noexcept(is_nothrow_op) {
+            value_type res = M::unit();
+            for (size_type i = r; i > 0; i &= i - 1)
+                for (size_type j = c; j > 0; j &= j - 1)
+                    res = M::op(res, at(i, j));
+
+            return res;
+        }
+
+        static size_type get_parent_idx(size_type idx) noexcept {
+            return idx + (idx & (~idx + 1));
+        }
+
+    public:
+        fenwick_tree_2d() = default;
+        fenwick_tree_2d(const fenwick_tree_2d&) = default;
+        fenwick_tree_2d(fenwick_tree_2d&&) = default;
+        fenwick_tree_2d& operator=(const fenwick_tree_2d&) = default;
+        fenwick_tree_2d& operator=(fenwick_tree_2d&&) = default;
+
+        fenwick_tree_2d(size_type _rows, size_type _cols) : node((_rows + 1) * (_cols + 1), M::unit()), row_count(_rows), col_count(_cols) {}
+        // src holds the grid row-major
+        // contracts: src.size() == _rows * _cols
+        fenwick_tree_2d(size_type _rows, size_type _cols, std::span<const value_type> src) : fenwick_tree_2d(_rows, _cols) {
+            for (size_type i = 0; i < rows(); ++i)
+                std::copy_n(src.begin() + i * cols(), cols(), node.begin() + (i + 1) * (cols() + 1) + 1);
+
+            // fold each row into its parent row, then each column into its parent column
+            for (size_type i = 1; i <= rows(); ++i) {
+                const size_type par = get_parent_idx(i);
+                if (par <= rows())
+                    for (size_type j = 1; j <= cols(); ++j)
+                        at(par, j) = M::op(at(par, j), at(i, j));
+            }
+            for (size_type i = 1; i <= rows(); ++i) {
+                for (size_type j = 1; j <= cols(); ++j) {
+                    const size_type par = get_parent_idx(j);
+                    if (par <= cols())
+                        at(i, par) = M::op(at(i, par), at(i, j));
+                }
+            }
+        }
+
+        size_type rows() const noexcept {
+            return row_count;
+        }
+
+        size_type cols() const noexcept {
+            return col_count;
+        }
+
+        bool is_empty() const noexcept {
+            return rows() == 0 || cols() == 0;
+        }
+
+        // update (r, c) by applying inc
+        // time complexity: Θ(logR logC)
+        void append_at(size_type r, size_type c, const value_type& inc) noexcept(is_nothrow_op) {
+            if (r >= rows() || c >= cols())
+                return;
+
+            for (size_type i = r + 1; i <= rows(); i = get_parent_idx(i))
+                for (size_type j = c + 1; j <= cols(); j = get_parent_idx(j))
+                    at(i, j) = M::op(at(i, j), inc);
+        }
+
+        // accumulate [0, r] x [0, c], return std::nullopt if the given cell is invalid
+        // time complexity: Θ(logR logC)
+        std::optional<value_type> accumulate(size_type r, size_type c) const noexcept(is_nothrow_op) {
+            if (r >= rows() || c >= cols())
+                return std::nullopt;
+
+            return accumulate_impl(r + 1, c + 1);
+        }
+
+        // accumulate [r1, r2) x [c1, c2), return std::nullopt if the given rectangle is invalid
+        // time complexity: Θ(logR logC)
+        // requires: commutative
+        std::optional<value_type> accumulate(size_type r1, size_type c1, size_type r2, size_type c2) const
+        requires CommutativeGroup<M>
+        {
+            if (r1 >= rows() || r2 > rows() || r1 >= r2 || c1 >= cols() || c2 > cols() || c1 >= c2)
+                return std::nullopt;
+
+            const value_type pos = M::op(accumulate_impl(r2, c2), accumulate_impl(r1, c1));
+            const value_type neg = M::op(accumulate_impl(r1, c2), accumulate_impl(r2, c1));
+
+            return M::op(pos, M::inv(neg));
+        }
+
+        // calculate the value at (r, c)
+        // time complexity: Θ(logR logC)
+        // requires: commutative
+        std::optional<value_type> calc(size_type r, size_type c) const requires CommutativeGroup<M> {
+            return accumulate(r, c, r + 1, c + 1);
+        }
+
+        // update the value at (r, c) with updater(value at (r, c))
+        // time complexity: Θ(logR logC)
+        // requires: commutative
+        template <typename F>
+        void update(size_type r, size_type c, F&& updater)
+        requires CommutativeGroup<M> && requires { {updater(M::unit())} -> std::convertible_to<value_type>; }
+        {
+            if (r >= rows() || c >= cols())
+                return;
+
+            const value_type cur_val = *calc(r, c);
+            const value_type new_val = updater(cur_val);
+
+            append_at(r, c, M::op(new_val, M::inv(cur_val)));
+        }
+
+        // time complexity: Θ(logR logC)
+        // requires: commutative
+        void set(size_type r, size_type c, const value_type& v) requires CommutativeGroup<M> {
+            update(r, c, [&v](auto&&) noexcept { return v; });
+        }
+    };
+
+    // a fenwick tree over points known in advance, for grids too large or too sparse to store whole
+    // each node of the fenwick tree over the x keys holds a fenwick tree over the sorted y keys of its points;
+    // all of them share one flat array, so memory is Θ(P logP) for P points
+    // only the given points may be updated, while queries may use any keys
+    template <CommutativeMonoid M, std::totally_ordered Key = std::int64_t>
+    requires std::copyable<typename M::value_type>
+    class offline_fenwick_tree_2d {
+    public:
+        using value_type = M::value_type;
+        using key_type = Key;
+        using size_type = std::size_t;
+
+    private:
+        compressor<key_type> xs;
+        std::vector<size_type> offset; // the inner tree of x node i is [offset[i - 1], offset[i]) of ys and node
+        std::vector<key_type> ys;
+        std::vector<value_type> node;
+
+        static size_type get_parent_idx(size_type idx) noexcept {
+            return idx + (idx & (~idx + 1));
+        }
+
+        // the number of y keys of inner tree i less than y
+        size_type inner_bound(size_type i, const key_type& y) const {
+            return static_cast<size_type>(std::lower_bound(ys.begin() + offset[i - 1], ys.begin() + offset[i], y) - (ys.begin() + offset[i - 1]));
+        }
+
+        // accumulate the points among the x smallest x keys with py < y
+        value_type accumulate_impl(size_type x, const key_type& y) const {
+            value_type res = M::unit();
+            for (size_type i = x; i > 0; i &= i - 1) {
+                const value_type* inner = node.data() + offset[i - 1];
+                for (size_type j = inner_bound(i, y); j > 0; j &= j - 1)
+                    res = M::op(res, inner[j - 1]);
+            }
+
+            return res;
+        }
+
+    public:
+        offline_fenwick_tree_2d() = default;
+        offline_fenwick_tree_2d(const offline_fenwick_tree_2d&) = default;
+        offline_fenwick_tree_2d(offline_fenwick_tree_2d&&) = default;
+        offline_fenwick_tree_2d& operator=(const offline_fenwick_tree_2d&) = default;
+        offline_fenwick_tree_2d& operator=(offline_fenwick_tree_2d&&) = default;
+
+        // every point starts at M::unit(); duplicates are allowed
+        // time complexity: Θ(P logP)
+        explicit offline_fenwick_tree_2d(std::span<const std::pair<key_type, key_type>> points)
+            : xs(points | std::views::transform([](const auto& p) { return p.first; })) {
+            const size_type n = xs.size();
+
+            // gather the y keys of each x node, then sort and dedup them in place
+            std::vector<size_type> count(n + 1, 0);
+            for (const auto& [x, y] : points)
+                for (size_type i = xs.lower_bound(x) + 1; i <= n; i = get_parent_idx(i))
+                    ++count[i];
+
+            offset.assign(n + 1, 0);
+            for (size_type i = 1; i <= n; ++i)
+                offset[i] = offset[i - 1] + count[i];
+
+            ys.resize(offset[n]);
+            std::vector<size_type> fill(offset.begin(), offset.end() - 1);
+            for (const auto& [x, y] : points)
+                for (size_type i = xs.lower_bound(x) + 1; i <= n; i = get_parent_idx(i))
+                    ys[fill[i - 1]++] = y;
+
+            size_type out = 0;
+            for (size_type i = 1; i <= n; ++i) {
+                const auto first = ys.begin() + offset[i - 1], last = ys.begin() + offset[i];
+                std::sort(first, last);
+                const auto end = std::unique(first, last);
+
+                offset[i - 1] = out;
+                out = static_cast<size_type>(std::move(first, end, ys.begin() + out) - ys.begin());
+            }
+            offset[n] = out;
+            ys.resize(out);
+            ys.shrink_to_fit();
+
+            node.assign(ys.size(), M::unit());
+        }
+
+        // the number of distinct x keys
+        size_type size() const noexcept {
+            return xs.size();
+        }
+
+        bool is_empty() const noexcept {
+            return size() == 0;
+        }
+
+        // update the point (x, y) by applying inc
+        // (x, y) should be one of the points given to the constructor; the others may be ignored
+        // time complexity: Θ(log²P)
+        void append_at(const key_type& x, const key_type& y, const value_type& inc) {
+            const auto xi = xs.index(x);
+            if (!xi)
+                return;
+
+            for (size_type i = *xi + 1; i <= size(); i = get_parent_idx(i)) {
+                const size_type len = offset[i] - offset[i - 1];
+                const size_type j0 = inner_bound(i, y);
+                if (j0 == len || ys[offset[i - 1] + j0] != y)
+                    return;
+
+                value_type* inner = node.data() + offset[i - 1];
+                for (size_type j = j0 + 1; j <= len; j = get_parent_idx(j))
+                    inner[j - 1] = M::op(inner[j - 1], inc);
+            }
+        }
+
+        // accumulate the points with px < x and py < y
+        // time complexity: Θ(log²P)
+        value_type accumulate(const key_type& x, const key_type& y) const {
+            return accumulate_impl(xs.lower_bound(x), y);
+        }
+
+        // accumulate the points in [x1, x2) x [y1, y2), return std::nullopt if the given rectangle is empty
+        // time complexity: Θ(log²P)
+        // requires: commutative
+        std::optional<value_type> accumulate(const key_type& x1, const key_type& y1, const key_type& x2, const key_type& y2) const
+        requires CommutativeGroup<M>
+        {
+            if (!(x1 < x2) || !(y1 < y2))
+                return std::nullopt;
+
+            const size_type l = xs.lower_bound(x1), r = xs.lower_bound(x2);
+            const value_type pos = M::op(accumulate_impl(r, y2), accumulate_impl(l, y1));
+            const value_type neg = M::op(accumulate_impl(l, y2), accumulate_impl(r, y1));
+
+            return M::op(pos, M::inv(neg));
+        }
+    };
+
+}
+
+#endif // !ADSL_SEGTREE_FENWICK_TREE_2D_HPP
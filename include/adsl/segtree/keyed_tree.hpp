@@ -0,0 +1,127 @@
+#ifndef ADSL_SEGTREE_KEYED_TREE_HPP
+#define ADSL_SEGTREE_KEYED_TREE_HPP
+
+#include <cstddef>
+#include <functional>
+#include <utility>
+#include <optional>
+#include <type_traits>
+#include "../utility/compressor.hpp"
+
+namespace adsl {
+
+    // any of segtree, fenwick_tree, lazy_segtree and dual_segtree indexed by keys known in advance
+    // the key of index i is key_compressor().key(i); an operation is offered when Tree has its dense-index counterpart
+    // point operations on a key that is not one of the keys do nothing or return std::nullopt,
+    // range operations cover the keys [l, r) of the set and return std::nullopt when no key lies in it
+    template <typename Tree, typename Key, typename Compare = std::less<>>
+    class keyed_tree {
+    public:
+        using tree_type = Tree;
+        using compressor_type = compressor<Key, Compare>;
+        using key_type = Key;
+        using value_type = Tree::value_type;
+        using size_type = std::size_t;
+
+    private:
+        compressor_type comp;
+        tree_type seg;
+
+        std::pair<size_type, size_type> to_range(const key_type& l, const key_type& r) const {
+            return { comp.lower_bound(l), comp.lower_bound(r) };
+        }
+
+    public:
+        keyed_tree() = default;
+
+        // a tree of size comp.size() holding units
+        explicit keyed_tree(compressor_type _comp) : comp(std::move(_comp)), seg(comp.size()) {}
+        // a tree built by the caller, whose i-th value belongs to the i-th smallest key
+        // contracts: _seg.size() == _comp.size()
+        keyed_tree(compressor_type _comp, tree_type _seg) : comp(std::move(_comp)), seg(std::move(_seg)) {}
+
+        size_type size() const noexcept {
+            return comp.size();
+        }
+
+        bool is_empty() const noexcept {
+            return size() == 0;
+        }
+
+        const compressor_type& key_compressor() const noexcept {
+            return comp;
+        }
+
+        tree_type& tree() noexcept {
+            return seg;
+        }
+        const tree_type& tree() const noexcept {
+            return seg;
+        }
+
+        template <typename F>
+        void update(const key_type& key, F&& updater)
+        requires requires (tree_type& t) { t.update(size_type{}, std::forward<F>(updater)); }
+        {
+            if (const auto idx = comp.index(key))
+                seg.update(*idx, std::forward<F>(updater));
+        }
+
+        void set(const key_type& key, const value_type& v)
+        requires requires (tree_type& t) { t.set(size_type{}, v); }
+        {
+            if (const auto idx = comp.index(key))
+                seg.set(*idx, v);
+        }
+
+        // fenwick_tree: update the value of key by applying inc
+        void append_at(const key_type& key, const value_type& inc)
+        requires requires (tree_type& t) { t.append_at(size_type{}, inc); }
+        {
+            if (const auto idx = comp.index(key))
+                seg.append_at(*idx, inc);
+        }
+
+        // lazy_segtree, dual_segtree: update the keys [l, r) by applying inc
+        template <typename O>
+        void append(const key_type& l, const key_type& r, const O& inc)
+        requires requires (tree_type& t) { t.append(size_type{}, size_type{}, inc); }
+        {
+            const auto [lo, hi] = to_range(l, r);
+            seg.append(lo, hi, inc);
+        }
+
+        // accumulate the keys [l, r)
+        auto accumulate(const key_type& l, const key_type& r)
+        requires requires (tree_type& t) { t.accumulate(size_type{}, size_type{}); }
+        {
+            const auto [lo, hi] = to_range(l, r);
+            return seg.accumulate(lo, hi);
+        }
+        auto accumulate(const key_type& l, const key_type& r) const
+        requires requires (const tree_type& t) { t.accumulate(size_type{}, size_type{}); }
+        {
+            const auto [lo, hi] = to_range(l, r);
+            return seg.accumulate(lo, hi);
+        }
+
+        // fenwick_tree: accumulate the keys not greater than key
+        auto accumulate(const key_type& key) const
+        requires requires (const tree_type& t) { t.accumulate(size_type{}); }
+        {
+            const size_type idx = comp.upper_bound(key);
+            return (idx == 0 ? decltype(seg.accumulate(idx))(std::nullopt) : seg.accumulate(idx - 1));
+        }
+
+        // calculate the value of key
+        auto calc(const key_type& key)
+        requires requires (tree_type& t) { t.calc(size_type{}); }
+        {
+            const auto idx = comp.index(key);
+            return (idx ? seg.calc(*idx) : decltype(seg.calc(*idx))(std::nullopt));
+        }
+    };
+
+}
+
+#endif // !ADSL_SEGTREE_KEYED_TREE_HPP
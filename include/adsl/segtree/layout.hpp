@@ -0,0 +1,265 @@
+#ifndef ADSL_SEGTREE_LAYOUT_HPP
+#define ADSL_SEGTREE_LAYOUT_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <concepts>
+#include <bit>
+#include <array>
+#include <limits>
+#include <vector>
+#include <algorithm>
+#include "../utility/radix_sort.hpp"
+
+namespace adsl {
+
+    // a layout maps the heap index of a node (root = 1, children of i = 2i, 2i + 1) to its position in storage
+    // the n leaves of L(n) are the heap indices [leaf_offset(), leaf_offset() + n) and
+    // every other heap index reached from them by halving is an inner node
+    template <typename L>
+    concept SegtreeLayout = std::default_initializable<L> && std::copyable<L> && requires(const L& layout, std::size_t idx) {
+        requires std::constructible_from<L, std::size_t>;
+
+        // perfect: leaf_offset() = 2^height() and node i covers a contiguous range of leaves
+        // otherwise the tree is the bottom-up tree of leaf_offset() = n leaves, in which some nodes cover
+        // leaves from both ends and only the ranges reached by the bottom-up loops are meaningful
+        { L::perfect } -> std::convertible_to<bool>;
+
+        // contiguous_leaves: each level of a perfect tree, or each band [ceil(i / 2), i) of a bottom-up tree,
+        // is stored contiguously in heap order
+        { L::contiguous_leaves } -> std::convertible_to<bool>;
+
+        { layout.height() } -> std::convertible_to<std::size_t>;
+        { layout.leaf_offset() } -> std::convertible_to<std::size_t>;
+        { layout.storage_size() } -> std::convertible_to<std::size_t>;
+        { layout.pos(idx) } -> std::convertible_to<std::size_t>;
+    };
+
+    // the implicit binary heap: node i is stored at i
+    class binary_heap_layout {
+    public:
+        using size_type = std::size_t;
+
+        static constexpr bool perfect = true;
+        static constexpr bool contiguous_leaves = true;
+
+    private:
+        size_type _height = 0;
+
+    public:
+        constexpr binary_heap_layout() noexcept = default;
+        constexpr explicit binary_heap_layout(size_type n) noexcept {
+            while ((size_type{1} << _height) < n)
+                ++_height;
+        }
+
+        constexpr size_type height() const noexcept {
+            return _height;
+        }
+
+        constexpr size_type leaf_offset() const noexcept {
+            return size_type{1} << _height;
+        }
+
+        constexpr size_type storage_size() const noexcept {
+            return leaf_offset() * 2;
+        }
+
+        constexpr size_type pos(size_type idx) const noexcept {
+            return idx;
+        }
+    };
+
+    // the implicit binary heap without the nodes whose subtrees hold no leaf: node i is stored at i
+    // storage: 2^height() + N rounded up to even, instead of 2^(height() + 1)
+    class truncated_heap_layout {
+    public:
+        using size_type = std::size_t;
+
+        static constexpr bool perfect = true;
+        static constexpr bool contiguous_leaves = true;
+
+    private:
+        size_type _height = 0;
+        size_type _storage_size = 0;
+
+    public:
+        constexpr truncated_heap_layout() noexcept = default;
+        constexpr explicit truncated_heap_layout(size_type n) noexcept {
+            while ((size_type{1} << _height) < n)
+                ++_height;
+
+            // the sibling of the last leaf is kept, so that every child of an inner node on a leaf's path exists
+            if (n != 0)
+                _storage_size = ((leaf_offset() + n - 1) | 1) + 1;
+        }
+
+        constexpr size_type height() const noexcept {
+            return _height;
+        }
+
+        constexpr size_type leaf_offset() const noexcept {
+            return size_type{1} << _height;
+        }
+
+        constexpr size_type storage_size() const noexcept {
+            return _storage_size;
+        }
+
+        constexpr size_type pos(size_type idx) const noexcept {
+            return idx;
+        }
+    };
+
+    // the bottom-up tree with its leaves at [N, 2N): node i is stored at i
+    // storage: exactly 2N; node 0 is outside the tree and only ever holds the unit
+    // every range query and update keeps its order of operands, but a node may cover the last leaves and the first ones together,
+    // so algorithms that descend from the root, such as binary searches over the tree, need a perfect layout
+    class compact_heap_layout {
+    public:
+        using size_type = std::size_t;
+
+        static constexpr bool perfect = false;
+        static constexpr bool contiguous_leaves = true;
+
+    private:
+        size_type n = 0;
+
+    public:
+        constexpr compact_heap_layout() noexcept = default;
+        constexpr explicit compact_heap_layout(size_type _n) noexcept : n(_n) {}
+
+        // every leaf i satisfies (i >> height()) <= 1
+        constexpr size_type height() const noexcept {
+            return (n == 0 ? 0 : static_cast<size_type>(std::bit_width(n - 1)));
+        }
+
+        constexpr size_type leaf_offset() const noexcept {
+            return n;
+        }
+
+        constexpr size_type storage_size() const noexcept {
+            return n * 2;
+        }
+
+        constexpr size_type pos(size_type idx) const noexcept {
+            return idx;
+        }
+    };
+
+    // subtrees of height BlockHeight are stored contiguously in blocks of 2^BlockHeight slots,
+    // so that a walk between the root and a leaf touches about log_{2^BlockHeight} N blocks instead of log_2 N lines
+    // pick BlockHeight so that a block fills a cache line, e.g. 3 for 8-byte values on 64-byte lines
+    // blocks are aligned to the leaves; only the single block holding the root may be partially filled
+    template <std::size_t BlockHeight = 3>
+    requires (BlockHeight >= 2 && BlockHeight < 16)
+    class blocked_heap_layout {
+    public:
+        using size_type = std::size_t;
+
+        static constexpr bool perfect = true;
+        static constexpr bool contiguous_leaves = false;
+
+    private:
+        static constexpr size_type block_size = size_type{1} << BlockHeight;
+        static constexpr size_type max_depth = std::numeric_limits<size_type>::digits;
+
+        size_type _height = 0;
+        size_type _storage_size = block_size;
+
+        // for each depth, the depth of the node inside its block and
+        // the number to add to the index of the block root to get the index of the block
+        std::array<std::uint8_t, max_depth> local_depth{};
+        std::array<size_type, max_depth> block_base{};
+
+    public:
+        constexpr blocked_heap_layout() noexcept : blocked_heap_layout(0) {}
+        constexpr explicit blocked_heap_layout(size_type n) noexcept {
+            while ((size_type{1} << _height) < n)
+                ++_height;
+
+            // number of levels missing from the root block
+            const size_type skew = (BlockHeight - (_height + 1) % BlockHeight) % BlockHeight;
+
+            size_type blocks = 0;
+            for (size_type depth = 0; depth <= _height; ++depth) {
+                const size_type b = (depth + skew) / BlockHeight;
+                const size_type root_depth = (b == 0 ? 0 : b * BlockHeight - skew);
+
+                if (depth == root_depth) {
+                    block_base[depth] = blocks - (size_type{1} << root_depth);
+                    blocks += size_type{1} << root_depth;
+                }
+                else
+                    block_base[depth] = block_base[depth - 1];
+
+                local_depth[depth] = static_cast<std::uint8_t>(depth - root_depth);
+            }
+
+            _storage_size = blocks * block_size;
+        }
+
+        constexpr size_type height() const noexcept {
+            return _height;
+        }
+
+        constexpr size_type leaf_offset() const noexcept {
+            return size_type{1} << _height;
+        }
+
+        constexpr size_type storage_size() const noexcept {
+            return _storage_size;
+        }
+
+        // contracts: idx <- [1, leaf_offset() * 2)
+        constexpr size_type pos(size_type idx) const noexcept {
+            const size_type depth = static_cast<size_type>(std::bit_width(idx)) - 1;
+            const size_type shift = local_depth[depth];
+
+            const size_type local = (size_type{1} << shift) | (idx & ((size_type{1} << shift) - 1));
+            return ((block_base[depth] + (idx >> shift)) << BlockHeight) | local;
+        }
+    };
+
+    namespace impl {
+        // call f(i) for every ancestor i of the heap index x below the lowest one it shares with y, lowest first,
+        // or for every ancestor of x if y = 0
+        // contracts: x and y are on the level of depth
+        template <std::unsigned_integral S, typename F>
+        void for_each_ancestor_below(S x, S y, int depth, F&& f) {
+            const int top = (y == 0 ? depth + 1 : static_cast<int>(std::bit_width(static_cast<S>(x ^ y))));
+            for (int s = 1; s < top; ++s)
+                f(static_cast<S>(x >> s));
+        }
+
+        // call recalc(i) exactly once for every inner node i, i.e. i < leaf_offset, above the leaves in dirty,
+        // whose heap indices are given, and only after the inner nodes below it
+        // the leaves are shifted to the deepest level, where the ones under a node form a contiguous run, and sorted;
+        // each then climbs only to below the lowest ancestor it shares with the next one, which climbs on from there,
+        // so the children of a node are still in cache when it is recalculated
+        // dirty is used as scratch space and may hold duplicates
+        // time complexity: Θ(K) for K = dirty.size(), plus one call per such node
+        template <std::unsigned_integral S, typename F>
+        void recalc_ancestors(std::vector<S>& dirty, S leaf_offset, F&& recalc) {
+            if (dirty.empty())
+                return;
+
+            const int depth = static_cast<int>(std::bit_width(*std::max_element(dirty.begin(), dirty.end()))) - 1;
+            for (auto&& x : dirty)
+                x <<= depth + 1 - static_cast<int>(std::bit_width(x));
+
+            impl::radix_sort(dirty, depth + 1);
+            dirty.erase(std::unique(dirty.begin(), dirty.end()), dirty.end());
+
+            for (std::size_t i = 0; i < dirty.size(); ++i) {
+                for_each_ancestor_below(dirty[i], (i + 1 < dirty.size() ? dirty[i + 1] : S{0}), depth, [&](S a) {
+                    if (a < leaf_offset)
+                        recalc(a);
+                });
+            }
+        }
+    }
+
+}
+
+#endif // !ADSL_SEGTREE_LAYOUT_HPP
@@ -3,18 +3,38 @@
 
 #include "../algebra/data_type.hpp"
 #include "../algebra/type_util.hpp"
+#include "../utility/prefetch.hpp"
+#include "../utility/parallel.hpp"
+#include "../utility/radix_sort.hpp"
+#include "../utility/stats.hpp"
+#include "layout.hpp"
 #include <cstddef>
+#include <concepts>
+#include <algorithm>
 #include <utility>
 #include <vector>
 #include <memory>
 #include <utility>
+#include <optional>
+#include <tuple>
+#include <iterator>
+#include <span>
+#include <ranges>
+#include <bit>
+#include <type_traits>
 
 namespace adsl {
 
+    namespace impl {
+        struct snapshot_access;
+    }
+
     template <typename A>
     concept LazySegtreeAct = MonoidAction<A> && Monoid<typename A::space> && MonoidEndomorphism<decltype(A::act(std::declval<typename A::domain::value_type>())), typename A::space>;
 
-    template <LazySegtreeAct Act, template <typename T, typename Allocator = std::allocator<T>> typename Container = std::vector>
+    // Stats is told of every monoid op, act, composition, node access and propagation made by the operations,
+    // which stats() reports; the default null_stats compiles all of it away
+    template <LazySegtreeAct Act, template <typename T, typename Allocator = std::allocator<T>> typename Container = std::vector, SegtreeLayout Layout = binary_heap_layout, StatsPolicy Stats = null_stats>
     requires (
         std::copyable<typename Act::domain::value_type> &&
         std::copyable<typename Act::space::value_type> )
@@ -23,88 +43,338 @@ namespace adsl {
         using operator_type = Act::domain::value_type;
         using value_type = Act::space::value_type;
         using reference = value_type&;
-        using const_reference = const reference;
+        using const_reference = const value_type&;
         using size_type = std::size_t;
         using operator_container_type = Container<operator_type>;
         using value_container_type = Container<value_type>;
+        using layout_type = Layout;
+        using stats_type = Stats;
 
     private:
+        friend struct impl::snapshot_access;
+
         using domain = Act::domain;
         using space = Act::space;
         
         operator_container_type lazy;
         value_container_type node;
+        layout_type layout;
 
         size_type actual_size = 0;
-        size_type height = 0;
 
-        void append_op_at(size_type idx, const operator_type& o) {
-            lazy[idx] = domain::op(lazy[idx], o);
+        [[no_unique_address]] stats_type statistics;
+
+        // access a lazy tag or a node by its heap index
+        // contracts for lazy_at: idx is an inner node
+        operator_type& lazy_at(size_type idx) {
+            return lazy[layout.pos(idx)];
+        }
+        const operator_type& lazy_at(size_type idx) const {
+            return lazy[layout.pos(idx)];
+        }
+        value_type& node_at(size_type idx) {
+            return node[layout.pos(idx)];
+        }
+        const value_type& node_at(size_type idx) const {
+            return node[layout.pos(idx)];
+        }
+
+        // leaves carry no tag, so only the inner nodes get one when they are stored before the leaves
+        static size_type lazy_storage_size(const layout_type& layout) noexcept {
+            if constexpr (Layout::contiguous_leaves)
+                return layout.leaf_offset();
+            else
+                return layout.storage_size();
+        }
+
+        // the largest shift of idx that is still a node
+        size_type top_shift(size_type idx) const noexcept {
+            if constexpr (Layout::perfect)
+                return layout.height();
+            else
+                return static_cast<size_type>(std::bit_width(idx)) - 1;
+        }
+
+        value_type act(const operator_type& o, const value_type& v) const {
+            statistics.count(tree_stat::act);
+
+            if constexpr (DirectAction<Act>)
+                return Act::act(o, v);
+            else
+                return Act::act(o)(v);
+        }
+
+        value_type op(const value_type& x, const value_type& y) const {
+            statistics.count(tree_stat::op);
+            return space::op(x, y);
+        }
+
+        operator_type compose(const operator_type& f, const operator_type& g) const {
+            statistics.count(tree_stat::composition);
+            return domain::op(f, g);
+        }
+
+        // apply o to the whole subtree of idx: the value of idx is updated at once and o is kept for its children
+        // contracts: idx <- [1, layout.leaf_offset())
+        void all_apply(size_type idx, const operator_type& o) {
+            statistics.count(tree_stat::node_read);
+            statistics.count(tree_stat::node_write);
+
+            node_at(idx) = act(o, node_at(idx));
+            lazy_at(idx) = compose(lazy_at(idx), o);
+        }
+
+        // hand the tag of idx to its children
+        // contracts: idx <- [1, layout.leaf_offset())
+        void push(size_type idx) {
+            const operator_type& o = lazy_at(idx);
+
+            // most tags on the upper levels are the unit, since every query pushes them down
+            if constexpr (std::equality_comparable<operator_type>) {
+                if (o == domain::unit())
+                    return;
+            }
+
+            const size_type l = idx << 1, r = l + 1;
+
+            statistics.count(tree_stat::propagation);
+            statistics.count(tree_stat::node_read, 2);
+            statistics.count(tree_stat::node_write, 2);
+
+            node_at(l) = act(o, node_at(l));
+            node_at(r) = act(o, node_at(r));
+
+            // in a perfect layout both children are leaves or neither is
+            if (l < layout.leaf_offset())
+                lazy_at(l) = compose(lazy_at(l), o);
+            if ((Layout::perfect ? l : r) < layout.leaf_offset())
+                lazy_at(r) = compose(lazy_at(r), o);
+
+            lazy_at(idx) = domain::unit();
+        }
+
+        // contracts: idx <- [1, layout.leaf_offset()), lazy_at(idx) = domain::unit()
+        void pull(size_type idx) {
+            statistics.count(tree_stat::node_read, 2);
+            statistics.count(tree_stat::node_write);
+
+            node_at(idx) = op(node_at(idx << 1), node_at((idx << 1) + 1));
         }
 
-        // contracts: idx <- [0, node.size() / 2)
-        void prop_at(size_type idx) {
-            append_op_at(idx << 1, lazy[idx]);
-            append_op_at((idx << 1) + 1, lazy[idx]);
+        // recompute idx from its children and its own tag
+        // contracts: idx <- [1, layout.leaf_offset())
+        void pull_tagged(size_type idx) {
+            statistics.count(tree_stat::node_read, 2);
+            statistics.count(tree_stat::node_write);
 
-            lazy[idx] = domain::unit();
+            node_at(idx) = act(lazy_at(idx), op(node_at(idx << 1), node_at((idx << 1) + 1)));
         }
 
-        void prop_to(size_type idx) noexcept(noexcept(prop_at(idx))) {
-            for (size_type i = height; i >= 1; --i)
-                prop_at(idx >> i);
+        // push the tags down along the paths from the root to l and to r - 1
+        void push_bounds(size_type l, size_type r) {
+            for (size_type i = top_shift(l); i >= 1; --i)
+                push(l >> i);
+            for (size_type i = top_shift(r - 1); i >= 1; --i)
+                push((r - 1) >> i);
         }
 
-        value_type calc_at(size_type idx) const {
-            return Act::act(lazy[idx])(node[idx]);
+        // recompute the ancestors of l and r - 1 from their children and their own tags
+        // after push_bounds(l, r), the only tags left on these paths are those given by the latest append
+        // skipping either the tags or the nodes holding one would cost a branch that mispredicts on random ranges
+        void pull_bounds(size_type l, size_type r) {
+            for (size_type i = l >> 1; i > 0; i >>= 1)
+                pull_tagged(i);
+            for (size_type i = (r - 1) >> 1; i > 0; i >>= 1)
+                pull_tagged(i);
         }
 
-        void reflect(size_type idx) {
-            for (size_type i = idx >> 1; i > 0; i >>= 1)
-                node[i] = space::op(calc_at(i << 1), calc_at((i << 1) + 1));
+        // apply inc to the nodes covering [l, r) exactly, given in heap indices, without touching their ancestors
+        // contracts: push_bounds(l, r) was called
+        void apply_range(size_type l, size_type r, const operator_type& inc) {
+            // only the first level holds leaves, which carry no tag
+            if (l & 1) {
+                statistics.count(tree_stat::node_read);
+                statistics.count(tree_stat::node_write);
+
+                node_at(l) = act(inc, node_at(l));
+                ++l;
+            }
+            if (r & 1) {
+                --r;
+
+                statistics.count(tree_stat::node_read);
+                statistics.count(tree_stat::node_write);
+
+                node_at(r) = act(inc, node_at(r));
+            }
+
+            for (l >>= 1, r >>= 1; l < r; l >>= 1, r >>= 1) {
+                if (l & 1)
+                    all_apply(l++, inc);
+                if (r & 1)
+                    all_apply(--r, inc);
+            }
+        }
+
+        // contracts: every lazy tag in [first, last) is domain::unit()
+        void build_range(size_type first, size_type last) {
+            for (size_type i = last; i-- > first; )
+                node_at(i) = space::op(node_at(i << 1), node_at((i << 1) + 1));
+        }
+
+        // build the levels [depth, bottom) of the subtree rooted at root, whose depth is depth, from the level bottom
+        // nodes covering no leaf are skipped and keep the unit
+        // contracts: Layout::perfect, every lazy tag in the subtree is domain::unit()
+        void build_subtree(size_type root, size_type depth, size_type bottom) {
+            const size_type last_leaf = layout.leaf_offset() + size() - 1;
+
+            for (size_type d = bottom; d-- > depth; ) {
+                const size_type first = root << (d - depth);
+                build_range(first, std::min(first + (size_type{1} << (d - depth)), (last_leaf >> (layout.height() - d)) + 1));
+            }
+        }
+
+        // build every inner node from the leaves
+        // contracts: every lazy tag is domain::unit()
+        void build() {
+            if constexpr (Layout::perfect)
+                build_subtree(1, 0, layout.height());
+            else {
+                // the children of the band [ceil(last / 2), last) are at or after last
+                for (size_type last = layout.leaf_offset(); last > 1; last = (last + 1) >> 1)
+                    build_range((last + 1) >> 1, last);
+            }
+        }
+
+        // push every tag down to the leaves, parents before children, skipping the nodes that cover no leaf
+        void push_all() {
+            if constexpr (Layout::perfect) {
+                const size_type last_leaf = layout.leaf_offset() + size() - 1;
+
+                for (size_type d = 0; d < layout.height(); ++d) {
+                    const size_type last = (last_leaf >> (layout.height() - d)) + 1;
+                    for (size_type i = size_type{1} << d; i < last; ++i)
+                        push(i);
+                }
+            }
+            else {
+                for (size_type i = 1; i < layout.leaf_offset(); ++i)
+                    push(i);
+            }
+        }
+
+        // read the value at it, moving it out when R is an owning range passed as an rvalue
+        template <typename R, typename It>
+        static decltype(auto) take(const It& it) {
+            if constexpr (std::is_lvalue_reference_v<R> || std::ranges::view<std::remove_cvref_t<R>>)
+                return *it;
+            else
+                return std::ranges::iter_move(it);
         }
 
-        void evaluate_at(size_type idx) {
-            node[idx] = calc_at(idx);
-            prop_at(idx);
+        // copy or move the values of an input range into a vector, which the range need not be able to build
+        // itself: its sentinel may differ from its iterator, as for std::views::istream
+        template <typename R>
+        static std::vector<value_type> buffer(R&& src) {
+            std::vector<value_type> res;
+            for (auto it = std::ranges::begin(src); it != std::ranges::end(src); ++it)
+                res.push_back(take<R>(it));
+
+            return res;
         }
 
-        void evaluate(size_type idx) {
-            for (size_type i = height; i >= 1; --i)
-                evaluate_at(idx >> i);
+        // number of queries looked ahead by accumulate_batch when prefetching
+        static constexpr size_type batch_prefetch_distance = 8;
+
+        // number of levels above the leaves prefetched for each boundary of a query
+        static constexpr size_type batch_prefetch_levels = 12;
+
+        // touch the lower parts of both boundary paths of [l, r) so that their misses overlap
+        void prefetch_path(const std::pair<size_type, size_type>& query) const noexcept {
+            const auto [l, r] = query;
+            if (l >= r || r > size())
+                return;
+
+            size_type _l = l + layout.leaf_offset(), _r = r - 1 + layout.leaf_offset();
+            for (size_type i = 0; i < batch_prefetch_levels && _l != _r; ++i, _l >>= 1, _r >>= 1) {
+                prefetch(std::addressof(node_at(_l)));
+                prefetch(std::addressof(node_at(_r)));
+
+                if (i != 0) {
+                    prefetch(std::addressof(lazy_at(_l)));
+                    prefetch(std::addressof(lazy_at(_r)));
+                }
+            }
         }
 
     public:
         lazy_segtree() = default;
         lazy_segtree(const lazy_segtree&) = default;
+        lazy_segtree(lazy_segtree&&) = default;
+        lazy_segtree& operator=(const lazy_segtree&) = default;
+        lazy_segtree& operator=(lazy_segtree&&) = default;
 
-        explicit lazy_segtree(size_type _size) : actual_size(_size) {
+        explicit lazy_segtree(size_type _size) : layout(_size), actual_size(_size) {
             static_assert(sizeof(size_type) <= sizeof(typename operator_container_type::size_type));
             static_assert(sizeof(size_type) <= sizeof(typename value_container_type::size_type));
 
             if (_size == 0)
                 return;
 
-            size_type len = 1;
-            while (len < _size) {
-                len <<= 1;
-                ++height;
-            }
+            lazy = operator_container_type(lazy_storage_size(layout), domain::unit());
+            node = value_container_type(layout.storage_size(), space::unit());
+        }
+        // build from the values of src
+        // the values are moved out of src when it is an owning range passed as an rvalue
+        // time complexity: Θ(N)
+        template <std::ranges::forward_range R>
+        requires std::convertible_to<std::ranges::range_reference_t<R>, value_type>
+        lazy_segtree(R&& src) : lazy_segtree(static_cast<size_type>(std::ranges::distance(src))) {
+            if (size() == 0)
+                return;
 
-            lazy = operator_container_type(len * 2, domain::unit());
-            node = value_container_type(len * 2, space::unit());
+            size_type i = layout.leaf_offset();
+            for (auto it = std::ranges::begin(src); it != std::ranges::end(src); ++it, ++i)
+                node_at(i) = take<R>(it);
+
+            build();
         }
-        lazy_segtree(const value_container_type& src) : lazy_segtree(src.size()) {
-            if (src.size() == 0)
+        template <std::ranges::input_range R>
+        requires (!std::ranges::forward_range<R> && std::convertible_to<std::ranges::range_reference_t<R>, value_type>)
+        lazy_segtree(R&& src) : lazy_segtree(buffer(std::forward<R>(src))) {}
+
+        // build from the values of src, the subtrees below the top log2(thread_count) levels on separate threads
+        // thread_count = 0 means std::thread::hardware_concurrency()
+        // a layout that is not perfect is built on the calling thread
+        // time complexity: Θ(N / thread_count + thread_count)
+        template <std::ranges::random_access_range R>
+        requires std::ranges::sized_range<R> && std::convertible_to<std::ranges::range_reference_t<R>, value_type>
+        lazy_segtree(R&& src, size_type thread_count) : lazy_segtree(static_cast<size_type>(std::ranges::size(src))) {
+            if (size() == 0)
+                return;
+
+            if constexpr (!Layout::perfect) {
+                auto it = std::ranges::begin(src);
+                for (size_type i = 0; i < size(); ++i, ++it)
+                    node_at(layout.leaf_offset() + i) = take<R>(it);
+
+                build();
                 return;
-            
-            auto it = node.begin();
-            std::advance(it, src.size() / 2);
-            
-            std::copy(src.begin(), src.end(), it);
+            }
+
+            const size_type parts = impl::pow2_thread_count(thread_count, layout.leaf_offset());
+            const size_type part_depth = static_cast<size_type>(std::countr_zero(parts));
+            const size_type part_len = layout.leaf_offset() / parts;
+
+            impl::parallel_for(parts, [&, first = std::ranges::begin(src)](size_type p) {
+                const size_type lo = std::min(p * part_len, size()), hi = std::min(lo + part_len, size());
+                for (size_type i = lo; i < hi; ++i)
+                    node_at(layout.leaf_offset() + i) = take<R>(first + i);
+
+                build_subtree(parts + p, part_depth, layout.height());
+            });
 
-            for (size_type i = src.size() / 2 - 1; i > 0; ++i)
-                node[i] = space::op(node[i << 1], node[(i << 1) + 1]);
+            build_subtree(1, 0, part_depth);
         }
 
         size_type size() const noexcept {
@@ -115,29 +385,102 @@ namespace adsl {
             return size() == 0;
         }
 
+        // the counts kept by Stats since construction or the last reset_stats()
+        tree_stats stats() const noexcept {
+            return statistics.snapshot();
+        }
+
+        void reset_stats() noexcept {
+            statistics.reset();
+        }
+
+        // apply inc to every value in [l, r)
+        // time complexity: Θ(logN)
         void append(size_type l, size_type r, const operator_type& inc) {
             if (l >= size() || r > size() || l >= r)
                 return;
 
-            l += lazy.size() / 2;
-            r += lazy.size() / 2;
+            statistics.begin_operation();
 
-            prop_to(l);
-            prop_to(r - 1);
+            l += layout.leaf_offset();
+            r += layout.leaf_offset();
 
-            for (size_type _l = l, _r = r; _l < _r; _l >>= 1, _r >>= 1) {
-                if (_l & 1) {
-                    append_op_at(_l, inc);
-                    ++_l;
+            push_bounds(l, r);
+            apply_range(l, r, inc);
+            pull_bounds(l, r);
+        }
+
+        // apply inc to every [l, r) in ranges; invalid ranges are skipped
+        // in a perfect layout, disjoint ranges are taken in order of l and each is pushed, tagged and pulled at once,
+        // except for the ancestors it shares with the next range, which are pulled once by the last range below them
+        // other ranges are applied in the given order and may overlap; their tags are placed first, then every ancestor
+        // of their ends is pulled once
+        // either way the upper levels shared by the ranges are not recomputed once per range
+        // time complexity: Θ(KlogN) for K ranges, with the recomputation Θ(K + min(KlogN, N))
+        void append_batch(std::span<const std::tuple<size_type, size_type, operator_type>> ranges) {
+            auto is_valid = [this](size_type l, size_type r) noexcept {
+                return l < size() && r <= size() && l < r;
+            };
+
+            if constexpr (Layout::perfect) {
+                std::vector<size_type> order;
+                order.reserve(ranges.size());
+                for (size_type k = 0; k < ranges.size(); ++k) {
+                    if (is_valid(std::get<0>(ranges[k]), std::get<1>(ranges[k])))
+                        order.push_back(k);
+                }
+                impl::radix_sort(order, static_cast<int>(layout.height()), [&](size_type k) noexcept { return std::get<0>(ranges[k]); });
+
+                const bool disjoint = std::ranges::adjacent_find(order, [&](size_type j, size_type k) noexcept {
+                    return std::get<1>(ranges[j]) > std::get<0>(ranges[k]);
+                }) == order.end();
+
+                if (disjoint) {
+                    const int depth = static_cast<int>(layout.height());
+                    auto pull = [this](size_type i) { pull_tagged(i); };
+
+                    for (size_type m = 0; m < order.size(); ++m) {
+                        const auto& [l, r, inc] = ranges[order[m]];
+                        const size_type _l = l + layout.leaf_offset(), _r = r + layout.leaf_offset();
+
+                        statistics.begin_operation();
+
+                        push_bounds(_l, _r);
+                        apply_range(_l, _r, inc);
+
+                        const size_type next = (m + 1 < order.size() ? std::get<0>(ranges[order[m + 1]]) + layout.leaf_offset() : 0);
+                        impl::for_each_ancestor_below(_l, _r - 1, depth, pull);
+                        impl::for_each_ancestor_below(_r - 1, next, depth, pull);
+                    }
+
+                    return;
                 }
-                if (_r & 1)
-                    append_op_at(_r - 1, inc);
             }
 
-            reflect(l);
-            reflect(r - 1);
+            std::vector<size_type> dirty;
+            dirty.reserve(ranges.size() * 2);
+
+            for (const auto& [l, r, inc] : ranges) {
+                if (!is_valid(l, r))
+                    continue;
+
+                statistics.begin_operation();
+
+                const size_type _l = l + layout.leaf_offset(), _r = r + layout.leaf_offset();
+
+                // pushing through a node left stale by an earlier range only moves its tag down, and it is recomputed below
+                push_bounds(_l, _r);
+                apply_range(_l, _r, inc);
+
+                dirty.push_back(_l);
+                dirty.push_back(_r - 1);
+            }
+
+            impl::recalc_ancestors(dirty, layout.leaf_offset(), [this](size_type i) { pull_tagged(i); });
         }
 
+        // update i-th value with updater(i-th value)
+        // time complexity: Θ(logN)
         template <typename F>
         void update(size_type idx, F&& updater)
         requires requires{ {updater(std::declval<value_type>())} -> std::convertible_to<value_type>; }
@@ -145,44 +488,188 @@ namespace adsl {
             if (idx >= size())
                 return;
 
-            idx += node.size() / 2;
+            statistics.begin_operation();
+
+            idx += layout.leaf_offset();
 
-            prop_to(idx);
+            const size_type top = top_shift(idx);
+            for (size_type i = top; i >= 1; --i)
+                push(idx >> i);
 
-            node[idx] = updater(calc_at(idx));
-            lazy[idx] = domain::unit();
+            statistics.count(tree_stat::node_read);
+            statistics.count(tree_stat::node_write);
 
-            reflect(idx);
+            node_at(idx) = updater(node_at(idx));
+
+            for (size_type i = 1; i <= top; ++i)
+                pull(idx >> i);
         }
 
+        // time complexity: Θ(logN)
         void set(size_type idx, const_reference v) {
             update(idx, [=, &v](auto&&) noexcept { return v; });
         }
 
+        // accumulate [l, r), return std::nullopt if the given range is invalid
+        // time complexity: Θ(logN)
         std::optional<value_type> accumulate(size_type l, size_type r) {
             if (l >= size() || r > size() || l >= r)
                 return std::nullopt;
 
-            l += node.size() / 2;
-            r += node.size() / 2;
-            
-            evaluate(l);
-            evaluate(r - 1);
+            statistics.begin_operation();
+
+            l += layout.leaf_offset();
+            r += layout.leaf_offset();
+
+            push_bounds(l, r);
 
             value_type res_l = space::unit(), res_r = space::unit();
             while (l < r) {
                 if (l & 1) {
-                    res_l = space::op(res_l, calc_at(l));
+                    statistics.count(tree_stat::node_read);
+                    res_l = op(res_l, node_at(l));
                     ++l;
                 }
-                if (r & 1)
-                    res_r = space::op(calc_at(r - 1), res_r);
+                if (r & 1) {
+                    statistics.count(tree_stat::node_read);
+                    res_r = op(node_at(r - 1), res_r);
+                }
 
                 l >>= 1;
                 r >>= 1;
             }
 
-            return space::op(res_l, res_r);
+            return op(res_l, res_r);
+        }
+
+        // write every value to out in index order, after pushing all the tags down to the leaves in one sweep
+        // time complexity: Θ(N)
+        template <std::output_iterator<const value_type&> OutputIt>
+        OutputIt materialize(OutputIt out) {
+            statistics.begin_operation();
+
+            if (is_empty())
+                return out;
+
+            push_all();
+
+            statistics.count(tree_stat::node_read, size());
+            for (size_type i = 0; i < size(); ++i, ++out)
+                *out = node_at(layout.leaf_offset() + i);
+
+            return out;
+        }
+
+        // accumulate every [l, r) in queries and write the results to out in the given order
+        // time complexity: Θ(QlogN)
+        template <std::output_iterator<std::optional<value_type>> OutputIt>
+        OutputIt accumulate_batch(std::span<const std::pair<size_type, size_type>> queries, OutputIt out) {
+            for (size_type i = 0; i < queries.size(); ++i, ++out) {
+                if (i + batch_prefetch_distance < queries.size())
+                    prefetch_path(queries[i + batch_prefetch_distance]);
+
+                *out = accumulate(queries[i].first, queries[i].second);
+            }
+
+            return out;
+        }
+
+        // return the largest r such that pred holds for the fold of [l, r), where the fold of [l, l) is the unit
+        // return std::nullopt if l > size()
+        // contracts: pred(unit) holds and pred is monotone, i.e. once it fails on [l, r), it fails on every longer range
+        // time complexity: Θ(logN)
+        template <std::predicate<const value_type&> Pred>
+        std::optional<size_type> max_right(size_type l, Pred pred) requires Layout::perfect {
+            if (l > size())
+                return std::nullopt;
+
+            statistics.begin_operation();
+            if (l == size())
+                return size();
+
+            size_type idx = l + layout.leaf_offset();
+            for (size_type i = layout.height(); i >= 1; --i)
+                push(idx >> i);
+
+            value_type acc = space::unit();
+
+            // climb while the node starting at idx fits, then descend into the first one that does not
+            do {
+                while (!(idx & 1))
+                    idx >>= 1;
+
+                statistics.count(tree_stat::node_read);
+                value_type next = op(acc, node_at(idx));
+                if (!pred(std::as_const(next))) {
+                    while (idx < layout.leaf_offset()) {
+                        push(idx);
+                        idx <<= 1;
+
+                        statistics.count(tree_stat::node_read);
+                        next = op(acc, node_at(idx));
+                        if (pred(std::as_const(next))) {
+                            acc = std::move(next);
+                            ++idx;
+                        }
+                    }
+
+                    // the leaves past the end stay the unit only if acting on the unit keeps it, which range assignment does not
+                    return std::min(idx - layout.leaf_offset(), size());
+                }
+
+                acc = std::move(next);
+                ++idx;
+            } while (!std::has_single_bit(idx));
+
+            return size();
+        }
+
+        // return the smallest l such that pred holds for the fold of [l, r), where the fold of [r, r) is the unit
+        // return std::nullopt if r > size()
+        // contracts: pred(unit) holds and pred is monotone, i.e. once it fails on [l, r), it fails on every longer range
+        // time complexity: Θ(logN)
+        template <std::predicate<const value_type&> Pred>
+        std::optional<size_type> min_left(size_type r, Pred pred) requires Layout::perfect {
+            if (r > size())
+                return std::nullopt;
+
+            statistics.begin_operation();
+            if (r == 0)
+                return 0;
+
+            size_type idx = r + layout.leaf_offset();
+            for (size_type i = layout.height(); i >= 1; --i)
+                push((idx - 1) >> i);
+
+            value_type acc = space::unit();
+
+            do {
+                --idx;
+                while (idx > 1 && (idx & 1))
+                    idx >>= 1;
+
+                statistics.count(tree_stat::node_read);
+                value_type next = op(node_at(idx), acc);
+                if (!pred(std::as_const(next))) {
+                    while (idx < layout.leaf_offset()) {
+                        push(idx);
+                        idx = (idx << 1) + 1;
+
+                        statistics.count(tree_stat::node_read);
+                        next = op(node_at(idx), acc);
+                        if (pred(std::as_const(next))) {
+                            acc = std::move(next);
+                            --idx;
+                        }
+                    }
+
+                    return idx + 1 - layout.leaf_offset();
+                }
+
+                acc = std::move(next);
+            } while (!std::has_single_bit(idx));
+
+            return 0;
         }
 
     };
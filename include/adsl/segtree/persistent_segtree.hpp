@@ -0,0 +1,241 @@
+#ifndef ADSL_SEGTREE_PERSISTENT_SEGTREE_HPP
+#define ADSL_SEGTREE_PERSISTENT_SEGTREE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <array>
+#include <concepts>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <limits>
+#include <stdexcept>
+#include "../algebra/data_type.hpp"
+#include "../algebra/type_util.hpp"
+
+namespace adsl {
+
+    // a segment tree that keeps every version: set / update copy only the Θ(logN) nodes on the path to the leaf
+    // and share the rest with the version they started from, so a version costs Θ(logN) nodes instead of Θ(N)
+    // nodes live in one arena and are reference counted; release(version) returns the nodes no other version uses
+    // a version is a small integer handle, valid until it is released
+    template <Monoid M>
+    requires std::copyable<typename M::value_type>
+    class persistent_segtree {
+    public:
+        using value_type = M::value_type;
+        using size_type = std::size_t;
+        using version_type = std::size_t;
+
+    private:
+        // 32-bit links keep a node small; the arena holds at most 2^32 - 2 nodes, the indices below the two sentinels,
+        // and growing it further throws std::length_error
+        using index_type = std::uint32_t;
+
+        static constexpr index_type null_index = std::numeric_limits<index_type>::max();
+        static constexpr index_type released_index = null_index - 1;
+        static constexpr size_type max_depth = std::numeric_limits<size_type>::digits + 1;
+
+        // [lo, hi) of an inner node splits at (lo + hi) / 2; a leaf has no children
+        // a free node keeps the next free one in left
+        struct node_type {
+            value_type value;
+            index_type left, right;
+            index_type refs;
+        };
+
+        std::vector<node_type> node;
+        index_type free_head = null_index;
+        size_type live_nodes = 0;
+        std::vector<index_type> root; // null_index for an empty tree, released_index once released
+        size_type actual_size = 0;
+
+        index_type alloc(const value_type& v, index_type l, index_type r) {
+            if (free_head != null_index) {
+                ++live_nodes;
+                const index_type i = free_head;
+                free_head = node[i].left;
+                node[i] = node_type{v, l, r, 1};
+                return i;
+            }
+
+            if (node.size() >= released_index)
+                throw std::length_error("adsl::persistent_segtree: too many nodes for 32-bit indices");
+
+            node.push_back(node_type{v, l, r, 1});
+            ++live_nodes;
+            return static_cast<index_type>(node.size() - 1);
+        }
+
+        // contracts: lo < hi
+        template <typename F>
+        index_type build(size_type lo, size_type hi, F& leaf) {
+            if (hi - lo == 1)
+                return alloc(leaf(lo), null_index, null_index);
+
+            const size_type mid = (lo + hi) >> 1;
+            const index_type l = build(lo, mid, leaf), r = build(mid, hi, leaf);
+
+            return alloc(M::op(node[l].value, node[r].value), l, r);
+        }
+
+        // contracts: [l, r) and [lo, hi) overlap
+        value_type fold(index_type i, size_type lo, size_type hi, size_type l, size_type r) const {
+            if (l <= lo && hi <= r)
+                return node[i].value;
+
+            const size_type mid = (lo + hi) >> 1;
+            if (r <= mid)
+                return fold(node[i].left, lo, mid, l, r);
+            if (mid <= l)
+                return fold(node[i].right, mid, hi, l, r);
+
+            return M::op(fold(node[i].left, lo, mid, l, r), fold(node[i].right, mid, hi, l, r));
+        }
+
+        void unref(index_type i) noexcept {
+            // each level leaves at most one sibling waiting
+            std::array<index_type, max_depth * 2> stack;
+            size_type top = 0;
+
+            stack[top++] = i;
+            while (top > 0) {
+                i = stack[--top];
+
+                if (--node[i].refs > 0)
+                    continue;
+
+                if (node[i].left != null_index) {
+                    stack[top++] = node[i].right;
+                    stack[top++] = node[i].left;
+                }
+
+                node[i].left = free_head;
+                free_head = i;
+                --live_nodes;
+            }
+        }
+
+        version_type add_version(index_type r) {
+            root.push_back(r);
+            return root.size() - 1;
+        }
+
+    public:
+        persistent_segtree() = default;
+        persistent_segtree(const persistent_segtree&) = default;
+        persistent_segtree(persistent_segtree&&) = default;
+        persistent_segtree& operator=(const persistent_segtree&) = default;
+        persistent_segtree& operator=(persistent_segtree&&) = default;
+
+        // version 0 holds _size units
+        explicit persistent_segtree(size_type _size) : actual_size(_size) {
+            auto leaf = [](size_type) { return M::unit(); };
+            add_version(_size == 0 ? null_index : build(0, _size, leaf));
+        }
+        // version 0 holds src
+        persistent_segtree(const std::vector<value_type>& src) : actual_size(src.size()) {
+            node.reserve(src.size() * 2);
+
+            auto leaf = [&src](size_type i) { return src[i]; };
+            add_version(src.empty() ? null_index : build(0, src.size(), leaf));
+        }
+
+        size_type size() const noexcept {
+            return actual_size;
+        }
+
+        bool is_empty() const noexcept {
+            return size() == 0;
+        }
+
+        // the number of versions ever created, released or not; the newest one is version_count() - 1
+        size_type version_count() const noexcept {
+            return root.size();
+        }
+
+        bool is_live(version_type version) const noexcept {
+            return version < root.size() && root[version] != released_index;
+        }
+
+        // the number of nodes in use by the live versions, to observe the memory cost of the history
+        size_type node_count() const noexcept {
+            return live_nodes;
+        }
+
+        // create a version equal to version but with i-th value replaced by updater(i-th value), and return it
+        // return std::nullopt if the version is not live or the index is invalid
+        // throw std::length_error if the arena is full; the existing versions stay valid
+        // time complexity: Θ(logN), allocating Θ(logN) nodes
+        template <typename F>
+        std::optional<version_type> update(version_type version, size_type idx, F&& updater)
+        requires requires { {updater(std::declval<value_type>())} -> std::convertible_to<value_type>; }
+        {
+            if (!is_live(version) || idx >= size())
+                return std::nullopt;
+
+            // the path from the root to the leaf and whether it went right below each node
+            std::array<index_type, max_depth> path;
+            std::array<bool, max_depth> right;
+
+            size_type depth = 0, lo = 0, hi = size();
+            path[0] = root[version];
+            while (hi - lo > 1) {
+                const size_type mid = (lo + hi) >> 1;
+                right[depth] = (mid <= idx);
+                if (right[depth]) {
+                    path[depth + 1] = node[path[depth]].right;
+                    lo = mid;
+                }
+                else {
+                    path[depth + 1] = node[path[depth]].left;
+                    hi = mid;
+                }
+                ++depth;
+            }
+
+            index_type cur = alloc(updater(std::as_const(node[path[depth]].value)), null_index, null_index);
+            while (depth-- > 0) {
+                const index_type old = path[depth];
+                const index_type l = (right[depth] ? node[old].left : cur);
+                const index_type r = (right[depth] ? cur : node[old].right);
+
+                // the untouched child gains the new node as a parent
+                ++node[right[depth] ? l : r].refs;
+                cur = alloc(M::op(node[l].value, node[r].value), l, r);
+            }
+
+            return add_version(cur);
+        }
+
+        // time complexity: Θ(logN), allocating Θ(logN) nodes
+        std::optional<version_type> set(version_type version, size_type idx, const value_type& v) {
+            return update(version, idx, [&v](auto&&) { return v; });
+        }
+
+        // accumulate [l, r) as of the given version
+        // return std::nullopt if the version is not live or the given range is invalid
+        // time complexity: Θ(logN)
+        std::optional<value_type> accumulate(version_type version, size_type l, size_type r) const {
+            if (!is_live(version) || l >= size() || r > size() || l >= r)
+                return std::nullopt;
+
+            return fold(root[version], 0, size(), l, r);
+        }
+
+        // drop a version; the nodes it shared with live versions stay
+        // time complexity: Θ(number of nodes freed + 1)
+        void release(version_type version) noexcept {
+            if (!is_live(version))
+                return;
+
+            if (root[version] != null_index)
+                unref(root[version]);
+            root[version] = released_index;
+        }
+    };
+
+}
+
+#endif // !ADSL_SEGTREE_PERSISTENT_SEGTREE_HPP
@@ -0,0 +1,160 @@
+#ifndef ADSL_SEGTREE_RANGE_FENWICK_TREE_HPP
+#define ADSL_SEGTREE_RANGE_FENWICK_TREE_HPP
+
+#include <cstddef>
+#include <vector>
+#include <optional>
+#include <concepts>
+#include <utility>
+#include "../algebra/data_type.hpp"
+#include "../algebra/type_util.hpp"
+
+namespace adsl {
+
+    // a fenwick tree with range updates and range queries over a commutative group that can scale by an index
+    // it keeps the differences d[i] = a[i] - a[i - 1] in two trees, b1 over d[i] and b2 over d[i] * i, so that
+    //   a[0] + ... + a[p - 1] = b1(p) * p - b2(p)
+    // where b(p) is the prefix over [0, p); the two trees are interleaved so that a step loads one pair
+    template <ScalableGroup G>
+    requires std::copyable<typename G::value_type>
+    class range_fenwick_tree {
+    public:
+        using value_type = G::value_type;
+        using size_type = std::size_t;
+
+    private:
+        // node[i] = { b1 node i, b2 node i }, 1-indexed
+        std::vector<std::pair<value_type, value_type>> node;
+        size_type actual_size = 0;
+
+        static value_type scale(const value_type& v, size_type n) {
+            if constexpr (requires { G::scale(v, n); })
+                return G::scale(v, n);
+            else
+                return v * static_cast<value_type>(n);
+        }
+
+        static size_type get_parent_idx(size_type idx) noexcept {
+            return idx + (idx & (~idx + 1));
+        }
+
+        // d[p] += inc
+        void add_diff(size_type p, const value_type& inc) {
+            if (p >= size())
+                return;
+
+            const value_type inc_p = scale(inc, p);
+            for (size_type i = p + 1; i <= size(); i = get_parent_idx(i)) {
+                node[i].first = G::op(node[i].first, inc);
+                node[i].second = G::op(node[i].second, inc_p);
+            }
+        }
+
+        // accumulate [0, p)
+        value_type prefix(size_type p) const {
+            value_type s1 = G::unit(), s2 = G::unit();
+            for (size_type i = p; i > 0; i &= i - 1) {
+                s1 = G::op(s1, node[i].first);
+                s2 = G::op(s2, node[i].second);
+            }
+
+            return G::op(scale(s1, p), G::inv(s2));
+        }
+
+    public:
+        range_fenwick_tree() = default;
+        range_fenwick_tree(const range_fenwick_tree&) = default;
+        range_fenwick_tree(range_fenwick_tree&&) = default;
+        range_fenwick_tree& operator=(const range_fenwick_tree&) = default;
+        range_fenwick_tree& operator=(range_fenwick_tree&&) = default;
+
+        explicit range_fenwick_tree(size_type _size) : node(_size + 1, { G::unit(), G::unit() }), actual_size(_size) {}
+        // time complexity: Θ(N)
+        range_fenwick_tree(const std::vector<value_type>& src) : range_fenwick_tree(src.size()) {
+            for (size_type i = 0; i < size(); ++i) {
+                const value_type d = (i == 0 ? src[0] : G::op(src[i], G::inv(src[i - 1])));
+                node[i + 1] = { d, scale(d, i) };
+            }
+
+            for (size_type i = 1; i <= size(); ++i) {
+                const size_type par = get_parent_idx(i);
+                if (par <= size()) {
+                    node[par].first = G::op(node[par].first, node[i].first);
+                    node[par].second = G::op(node[par].second, node[i].second);
+                }
+            }
+        }
+
+        size_type size() const noexcept {
+            return actual_size;
+        }
+
+        bool is_empty() const noexcept {
+            return size() == 0;
+        }
+
+        // update [l, r) by applying inc
+        // time complexity: Θ(logN)
+        void append(size_type l, size_type r, const value_type& inc) {
+            if (l >= size() || r > size() || l >= r)
+                return;
+
+            add_diff(l, inc);
+            add_diff(r, G::inv(inc));
+        }
+
+        // accumulate [0, idx], return std::nullopt if the given index is invalid
+        // time complexity: Θ(logN)
+        std::optional<value_type> accumulate(size_type idx) const {
+            if (idx >= size())
+                return std::nullopt;
+
+            return prefix(idx + 1);
+        }
+
+        // accumulate [l, r), return std::nullopt if the given range is invalid
+        // time complexity: Θ(logN)
+        std::optional<value_type> accumulate(size_type l, size_type r) const {
+            if (l >= size() || r > size() || l >= r)
+                return std::nullopt;
+
+            return G::op(prefix(r), G::inv(prefix(l)));
+        }
+
+        // calculate i-th value
+        // time complexity: Θ(logN)
+        std::optional<value_type> calc(size_type idx) const {
+            if (idx >= size())
+                return std::nullopt;
+
+            value_type res = G::unit();
+            for (size_type i = idx + 1; i > 0; i &= i - 1)
+                res = G::op(res, node[i].first);
+
+            return res;
+        }
+
+        // update i-th value with updater(i-th value)
+        // time complexity: Θ(logN)
+        template <typename F>
+        void update(size_type idx, F&& updater)
+        requires requires { {updater(G::unit())} -> std::convertible_to<value_type>; }
+        {
+            if (idx >= size())
+                return;
+
+            const value_type cur_val = *calc(idx);
+            const value_type new_val = updater(cur_val);
+
+            append(idx, idx + 1, G::op(new_val, G::inv(cur_val)));
+        }
+
+        // time complexity: Θ(logN)
+        void set(size_type idx, const value_type& v) {
+            update(idx, [&v](auto&&) noexcept { return v; });
+        }
+    };
+
+}
+
+#endif // !ADSL_SEGTREE_RANGE_FENWICK_TREE_HPP
@@ -0,0 +1,418 @@
+#ifndef ADSL_SEGTREE_REPLAY_HPP
+#define ADSL_SEGTREE_REPLAY_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <cmath>
+#include <array>
+#include <algorithm>
+#include <span>
+#include <chrono>
+#include <optional>
+#include <fstream>
+#include <filesystem>
+#include <memory>
+#include <bit>
+#include <type_traits>
+#include "../utility/mmap_container.hpp"
+#include "segtree.hpp"
+#include "dual_segtree.hpp"
+#include "lazy_segtree.hpp"
+#include "fenwick_tree.hpp"
+
+namespace adsl {
+
+    enum class replay_kind : std::uint32_t {
+        set = 1,        // assign value to l
+        update = 2,     // combine value into the value at l
+        append = 3,     // apply value to every value in [l, r)
+        accumulate = 4, // fold [l, r)
+    };
+
+    // one operation of a replay log; value is converted to the value or operator type of the tree
+    struct replay_op {
+        replay_kind kind;
+        std::uint32_t reserved;
+        std::uint64_t l;
+        std::uint64_t r;
+        std::int64_t value;
+    };
+
+    // the file starts with this header, followed by op_count replay_op records
+    // all fields are in the byte order of the machine that wrote the file
+    struct replay_header {
+        static constexpr char expected_magic[8] = { 'A', 'D', 'S', 'L', 'R', 'P', 'L', 'Y' };
+        static constexpr std::uint32_t current_version = 1;
+
+        char magic[8];
+        std::uint32_t version;
+        std::uint32_t op_size;
+        std::uint64_t size; // the number of values of the tree the log was recorded against
+        std::uint64_t op_count;
+    };
+
+    static_assert(std::is_trivially_copyable_v<replay_op> && sizeof(replay_op) == 32);
+    static_assert(std::is_trivially_copyable_v<replay_header> && sizeof(replay_header) == 32);
+
+    // a replay log mapped read-only into memory, so that replaying it reads no stream and copies nothing
+    class replay_log {
+        std::shared_ptr<impl::mmap_region> region;
+        std::uint64_t actual_size = 0;
+        std::size_t op_count = 0;
+
+        replay_log(std::shared_ptr<impl::mmap_region> _region, std::uint64_t _size, std::size_t _op_count) noexcept
+            : region(std::move(_region)), actual_size(_size), op_count(_op_count) {}
+
+    public:
+        replay_log() = default;
+        replay_log(const replay_log&) = default;
+        replay_log(replay_log&&) = default;
+        replay_log& operator=(const replay_log&) = default;
+        replay_log& operator=(replay_log&&) = default;
+
+        // return std::nullopt if the file cannot be mapped, is no replay log or is truncated
+        static std::optional<replay_log> open(const std::filesystem::path& path) {
+            auto region = impl::mmap_region::file(path.c_str(), false);
+            if (region == nullptr || region->size() < sizeof(replay_header))
+                return std::nullopt;
+
+            replay_header h;
+            std::memcpy(&h, region->data(), sizeof(h));
+
+            if (std::memcmp(h.magic, replay_header::expected_magic, sizeof(h.magic)) != 0 ||
+                h.version != replay_header::current_version ||
+                h.op_size != sizeof(replay_op) ||
+                h.op_count > (region->size() - sizeof(replay_header)) / sizeof(replay_op))
+                return std::nullopt;
+
+            // the records are read once from front to back
+            ::madvise(region->data(), region->size(), MADV_SEQUENTIAL);
+
+            return replay_log(std::move(region), h.size, static_cast<std::size_t>(h.op_count));
+        }
+
+        std::uint64_t size() const noexcept {
+            return actual_size;
+        }
+
+        std::span<const replay_op> ops() const noexcept {
+            if (region == nullptr)
+                return {};
+
+            return std::span<const replay_op>(reinterpret_cast<const replay_op*>(region->data() + sizeof(replay_header)), op_count);
+        }
+    };
+
+    // write a replay log of ops recorded against a tree of size values, return false on I/O failure
+    inline bool save_replay_log(const std::filesystem::path& path, std::uint64_t size, std::span<const replay_op> ops) {
+        replay_header h{};
+        std::memcpy(h.magic, replay_header::expected_magic, sizeof(h.magic));
+        h.version = replay_header::current_version;
+        h.op_size = sizeof(replay_op);
+        h.size = size;
+        h.op_count = ops.size();
+
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        if (!out)
+            return false;
+
+        out.write(reinterpret_cast<const char*>(&h), sizeof(h));
+        out.write(reinterpret_cast<const char*>(ops.data()), static_cast<std::streamsize>(ops.size_bytes()));
+        out.flush();
+
+        return static_cast<bool>(out);
+    }
+
+    // a histogram of latencies in nanoseconds with buckets of 1/16 of a power of two, so that every percentile
+    // is reported within about 6% of the exact one while recording stays a few instructions
+    class latency_histogram {
+        static constexpr std::size_t sub_bits = 4;
+        static constexpr std::size_t sub_count = std::size_t{1} << sub_bits;
+        static constexpr std::size_t bucket_count = (64 - sub_bits + 1) * sub_count;
+
+        std::array<std::uint64_t, bucket_count> bucket{};
+        std::uint64_t total = 0;
+        std::uint64_t largest = 0;
+        std::uint64_t sum = 0;
+
+        // the values below sub_count * 2 get a bucket each, the ones above share it with the values of the same top sub_bits + 1 bits
+        static std::size_t bucket_of(std::uint64_t ns) noexcept {
+            const std::size_t width = static_cast<std::size_t>(std::bit_width(ns));
+            if (width <= sub_bits + 1)
+                return static_cast<std::size_t>(ns);
+
+            const std::size_t shift = width - sub_bits - 1;
+            return (shift + 1) * sub_count + static_cast<std::size_t>((ns >> shift) - sub_count);
+        }
+
+        // the largest value that falls in bucket k
+        // the lowest value of the next bucket would not fit in 64 bits for the last one, so add the width of k instead
+        static std::uint64_t upper_bound_of(std::size_t k) noexcept {
+            if (k < sub_count * 2)
+                return k;
+
+            const std::size_t shift = k / sub_count - 1;
+            return (static_cast<std::uint64_t>(k % sub_count + sub_count) << shift) + ((std::uint64_t{1} << shift) - 1);
+        }
+
+    public:
+        void record(std::uint64_t ns) noexcept {
+            ++bucket[bucket_of(ns)];
+            ++total;
+            sum += ns;
+            largest = std::max(largest, ns);
+        }
+
+        void merge(const latency_histogram& other) noexcept {
+            for (std::size_t k = 0; k < bucket_count; ++k)
+                bucket[k] += other.bucket[k];
+
+            total += other.total;
+            sum += other.sum;
+            largest = std::max(largest, other.largest);
+        }
+
+        std::uint64_t count() const noexcept {
+            return total;
+        }
+
+        std::uint64_t max() const noexcept {
+            return largest;
+        }
+
+        double mean() const noexcept {
+            return (total == 0 ? 0.0 : static_cast<double>(sum) / static_cast<double>(total));
+        }
+
+        // an upper bound of the q-quantile, e.g. q = 0.99 for p99, capped by the largest value recorded
+        // time complexity: Θ(number of buckets)
+        std::uint64_t percentile(double q) const noexcept {
+            if (total == 0)
+                return 0;
+
+            const double clamped = std::min(std::max(q, 0.0), 1.0);
+            const std::uint64_t rank = std::max<std::uint64_t>(1, static_cast<std::uint64_t>(std::ceil(clamped * static_cast<double>(total))));
+
+            std::uint64_t seen = 0;
+            for (std::size_t k = 0; k < bucket_count; ++k) {
+                seen += bucket[k];
+                if (seen >= rank)
+                    return std::min(upper_bound_of(k), largest);
+            }
+
+            return largest;
+        }
+    };
+
+    // how each tree carries out the operations of a replay log; an operation a tree cannot express returns false and is skipped
+    // accumulate folds its result into checksum, so that two replays of the same log can be compared
+    template <typename Tree>
+    struct replay_traits {};
+
+    namespace impl {
+        template <typename T>
+        void mix_replay_checksum(std::uint64_t& checksum, const std::optional<T>& res) noexcept {
+            const std::uint64_t v = (res ? static_cast<std::uint64_t>(static_cast<std::int64_t>(*res)) : 0x9e3779b97f4a7c15);
+            checksum = (checksum ^ v) * 0x100000001b3;
+        }
+    }
+
+    template <typename M, typename C, typename L>
+    requires std::is_arithmetic_v<typename M::value_type>
+    struct replay_traits<segtree<M, C, L>> {
+        using tree_type = segtree<M, C, L>;
+        using value_type = M::value_type;
+
+        static bool set(tree_type& tree, std::uint64_t idx, std::int64_t v) {
+            tree.set(idx, static_cast<value_type>(v));
+            return true;
+        }
+
+        static bool update(tree_type& tree, std::uint64_t idx, std::int64_t v) {
+            tree.update(idx, [x = static_cast<value_type>(v)](const value_type& cur) { return M::op(cur, x); });
+            return true;
+        }
+
+        // only a range of one value
+        static bool append(tree_type& tree, std::uint64_t l, std::uint64_t r, std::int64_t v) {
+            return r == l + 1 && update(tree, l, v);
+        }
+
+        static bool accumulate(tree_type& tree, std::uint64_t l, std::uint64_t r, std::uint64_t& checksum) {
+            impl::mix_replay_checksum(checksum, tree.accumulate(l, r));
+            return true;
+        }
+    };
+
+    template <typename M, typename C, typename L, typename S>
+    requires std::is_arithmetic_v<typename M::value_type>
+    struct replay_traits<dual_segtree<M, C, L, S>> {
+        using tree_type = dual_segtree<M, C, L, S>;
+        using value_type = M::value_type;
+
+        static bool set(tree_type&, std::uint64_t, std::int64_t) noexcept {
+            return false;
+        }
+
+        static bool update(tree_type& tree, std::uint64_t idx, std::int64_t v) {
+            tree.append(idx, idx + 1, static_cast<value_type>(v));
+            return true;
+        }
+
+        static bool append(tree_type& tree, std::uint64_t l, std::uint64_t r, std::int64_t v) {
+            tree.append(l, r, static_cast<value_type>(v));
+            return true;
+        }
+
+        // only a range of one value
+        static bool accumulate(tree_type& tree, std::uint64_t l, std::uint64_t r, std::uint64_t& checksum) {
+            if (r != l + 1)
+                return false;
+
+            impl::mix_replay_checksum(checksum, tree.calc(l));
+            return true;
+        }
+    };
+
+    template <typename A, template <typename T, typename Allocator> typename C, typename L, typename S>
+    requires std::is_arithmetic_v<typename A::space::value_type> && std::is_arithmetic_v<typename A::domain::value_type>
+    struct replay_traits<lazy_segtree<A, C, L, S>> {
+        using tree_type = lazy_segtree<A, C, L, S>;
+        using value_type = A::space::value_type;
+        using operator_type = A::domain::value_type;
+
+        static bool set(tree_type& tree, std::uint64_t idx, std::int64_t v) {
+            tree.set(idx, static_cast<value_type>(v));
+            return true;
+        }
+
+        static bool update(tree_type& tree, std::uint64_t idx, std::int64_t v) {
+            tree.update(idx, [x = static_cast<value_type>(v)](const value_type& cur) { return A::space::op(cur, x); });
+            return true;
+        }
+
+        static bool append(tree_type& tree, std::uint64_t l, std::uint64_t r, std::int64_t v) {
+            tree.append(l, r, static_cast<operator_type>(v));
+            return true;
+        }
+
+        static bool accumulate(tree_type& tree, std::uint64_t l, std::uint64_t r, std::uint64_t& checksum) {
+            impl::mix_replay_checksum(checksum, tree.accumulate(l, r));
+            return true;
+        }
+    };
+
+    template <typename M, typename C, typename S>
+    requires std::is_arithmetic_v<typename M::value_type>
+    struct replay_traits<fenwick_tree<M, C, S>> {
+        using tree_type = fenwick_tree<M, C, S>;
+        using value_type = M::value_type;
+
+        // only for a group
+        static bool set(tree_type& tree, std::uint64_t idx, std::int64_t v) {
+            if constexpr (CommutativeGroup<M>) {
+                tree.set(idx, static_cast<value_type>(v));
+                return true;
+            }
+            else
+                return false;
+        }
+
+        static bool update(tree_type& tree, std::uint64_t idx, std::int64_t v) {
+            tree.append_at(idx, static_cast<value_type>(v));
+            return true;
+        }
+
+        // only a range of one value
+        static bool append(tree_type& tree, std::uint64_t l, std::uint64_t r, std::int64_t v) {
+            return r == l + 1 && update(tree, l, v);
+        }
+
+        // any range for a group, only a prefix otherwise
+        static bool accumulate(tree_type& tree, std::uint64_t l, std::uint64_t r, std::uint64_t& checksum) {
+            if constexpr (CommutativeGroup<M>)
+                impl::mix_replay_checksum(checksum, tree.accumulate(l, r));
+            else {
+                if (l != 0 || r == 0)
+                    return false;
+
+                impl::mix_replay_checksum(checksum, tree.accumulate(r - 1));
+            }
+
+            return true;
+        }
+    };
+
+    template <typename Tree>
+    concept Replayable = requires { &replay_traits<Tree>::accumulate; };
+
+    struct replay_result {
+        std::uint64_t executed = 0;
+        std::uint64_t skipped = 0; // the operations the tree cannot express
+        std::uint64_t checksum = 0xcbf29ce484222325;
+        std::chrono::nanoseconds elapsed{0};
+
+        double ops_per_second() const noexcept {
+            return (elapsed.count() <= 0 ? 0.0 : static_cast<double>(executed) * 1e9 / static_cast<double>(elapsed.count()));
+        }
+    };
+
+    // run ops against tree in order
+    // with a histogram, each operation is timed on its own, which adds the cost of reading the clock twice to every operation
+    // and to elapsed; replay once without one to measure the throughput
+    template <Replayable Tree>
+    replay_result replay(Tree& tree, std::span<const replay_op> ops, latency_histogram* latencies = nullptr) {
+        using traits = replay_traits<Tree>;
+        using clock = std::chrono::steady_clock;
+
+        replay_result res;
+
+        auto run = [&](const replay_op& op) {
+            switch (op.kind) {
+                case replay_kind::set:
+                    return traits::set(tree, op.l, op.value);
+                case replay_kind::update:
+                    return traits::update(tree, op.l, op.value);
+                case replay_kind::append:
+                    return traits::append(tree, op.l, op.r, op.value);
+                case replay_kind::accumulate:
+                    return traits::accumulate(tree, op.l, op.r, res.checksum);
+            }
+
+            return false;
+        };
+
+        const auto start = clock::now();
+
+        if (latencies == nullptr) {
+            for (const replay_op& op : ops)
+                ++(run(op) ? res.executed : res.skipped);
+        }
+        else {
+            for (const replay_op& op : ops) {
+                const auto op_start = clock::now();
+                const bool done = run(op);
+                const auto op_end = clock::now();
+
+                if (done) {
+                    ++res.executed;
+                    latencies->record(static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(op_end - op_start).count()));
+                }
+                else
+                    ++res.skipped;
+            }
+        }
+
+        res.elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - start);
+        return res;
+    }
+
+    template <Replayable Tree>
+    replay_result replay(Tree& tree, const replay_log& log, latency_histogram* latencies = nullptr) {
+        return replay(tree, log.ops(), latencies);
+    }
+
+}
+
+#endif // !ADSL_SEGTREE_REPLAY_HPP
@@ -8,12 +8,25 @@
 #include <utility>
 #include <optional>
 #include <type_traits>
+#include <span>
+#include <memory>
+#include <ranges>
+#include <bit>
 #include "../algebra/data_type.hpp"
 #include "../algebra/type_util.hpp"
+#include "../utility/prefetch.hpp"
+#include "../utility/simd.hpp"
+#include "../utility/parallel.hpp"
+#include "../utility/radix_sort.hpp"
+#include "layout.hpp"
 
 namespace adsl {
 
-    template <Monoid M, typename Container = std::vector<typename M::value_type>>
+    namespace impl {
+        struct snapshot_access;
+    }
+
+    template <Monoid M, typename Container = std::vector<typename M::value_type>, SegtreeLayout Layout = binary_heap_layout>
     requires (
         std::copyable<typename M::value_type> &&
         std::same_as<typename Container::value_type, typename M::value_type> )
@@ -24,44 +37,158 @@ namespace adsl {
         using reference = Container::reference;
         using const_reference = Container::const_reference;
         using container_type = Container;
+        using layout_type = Layout;
         
     private:
+        friend struct impl::snapshot_access;
+
         container_type node;
+        layout_type layout;
         size_type actual_size = 0;
 
-        // contracts: idx <- [0, node.size() / 2)
+        // access a node by its heap index
+        reference at(size_type idx) noexcept(noexcept(node[idx])) {
+            return node[layout.pos(idx)];
+        }
+        const_reference at(size_type idx) const noexcept(noexcept(node[idx])) {
+            return node[layout.pos(idx)];
+        }
+
+        // contracts: idx <- [0, layout.leaf_offset())
         void recalc_at(size_type idx) noexcept(noexcept(M::op(std::declval<value_type>(), std::declval<value_type>()))) {
-            node[idx] = M::op(node[idx << 1], node[(idx << 1) + 1]);
+            at(idx) = M::op(at(idx << 1), at((idx << 1) + 1));
+        }
+
+        // each heap level is a plain array that can be handed to the SIMD kernels
+        static constexpr bool use_simd = VectorizableMonoid<M> && Layout::contiguous_leaves && std::ranges::contiguous_range<container_type>;
+
+        // ranges of at most two cache lines of leaves are scanned instead of walked
+        static constexpr size_type simd_scan_length = impl::simd_lanes<value_type> * 2;
+
+        // recalc the nodes [first, last), whose children are [first * 2, last * 2)
+        void recalc_range(size_type first, size_type last) {
+            if constexpr (use_simd)
+                impl::simd_fold_pairs<M>(std::ranges::data(node) + layout.pos(first << 1), std::ranges::data(node) + layout.pos(first), last - first);
+            else {
+                for (size_type i = last; i-- > first; )
+                    recalc_at(i);
+            }
+        }
+
+        // one past the last node of depth d that covers a leaf, in a perfect layout
+        size_type level_end(size_type d) const noexcept {
+            return ((layout.leaf_offset() + size() - 1) >> (layout.height() - d)) + 1;
+        }
+
+        // copy src[lo, hi) into the leaves
+        void fill_leaves(const container_type& src, size_type lo, size_type hi) {
+            if constexpr (Layout::contiguous_leaves) {
+                auto first = src.begin(), last = src.begin();
+                std::advance(first, lo);
+                std::advance(last, hi);
+
+                auto it = node.begin();
+                std::advance(it, layout.pos(layout.leaf_offset() + lo));
+
+                std::copy(first, last, it);
+            }
+            else {
+                for (size_type i = lo; i < hi; ++i)
+                    at(layout.leaf_offset() + i) = src[i];
+            }
+        }
+
+        // build the levels [depth, bottom) of the subtree rooted at root, whose depth is depth, from the level bottom
+        // nodes covering no leaf are skipped and keep the unit
+        // contracts: Layout::perfect
+        void build_subtree(size_type root, size_type depth, size_type bottom) {
+            for (size_type d = bottom; d-- > depth; ) {
+                const size_type first = root << (d - depth), last = std::min(first + (size_type{1} << (d - depth)), level_end(d));
+
+                if (first < last)
+                    recalc_range(first, last);
+            }
+        }
+
+        // build every inner node from the leaves
+        void build() {
+            if constexpr (Layout::perfect)
+                build_subtree(1, 0, layout.height());
+            else {
+                // the children of the band [ceil(last / 2), last) are at or after last, so each band depends only on the previous ones
+                for (size_type last = layout.leaf_offset(); last > 1; last = (last + 1) >> 1)
+                    recalc_range((last + 1) >> 1, last);
+            }
+        }
+
+        // number of queries looked ahead by accumulate_batch when prefetching
+        static constexpr size_type batch_prefetch_distance = 8;
+
+        // number of levels above the leaves prefetched for each boundary of a query
+        static constexpr size_type batch_prefetch_levels = 12;
+
+        // touch the lower parts of both boundary paths of [l, r) so that their misses overlap
+        void prefetch_path(const std::pair<size_type, size_type>& query) const noexcept {
+            if constexpr (std::is_lvalue_reference_v<const_reference>) {
+                const auto [l, r] = query;
+                if (l >= r || r > size())
+                    return;
+
+                size_type _l = l + layout.leaf_offset(), _r = r - 1 + layout.leaf_offset();
+                for (size_type i = 0; i < batch_prefetch_levels && _l != _r; ++i, _l >>= 1, _r >>= 1) {
+                    prefetch(std::addressof(at(_l)));
+                    prefetch(std::addressof(at(_r)));
+                }
+            }
         }
 
     public:
         segtree() = default;
         segtree(const segtree&) = default;
+        segtree(segtree&&) = default;
+        segtree& operator=(const segtree&) = default;
+        segtree& operator=(segtree&&) = default;
 
-        explicit segtree(size_type _size) : actual_size(_size) {
-            size_type len = 1;
-            while (len < _size)
-                len <<= 1;
-            
-            node = container_type(len * 2, M::unit());
+        explicit segtree(size_type _size) : layout(_size), actual_size(_size) {
+            node = container_type(layout.storage_size(), M::unit());
         }
-        segtree(const container_type& src) : actual_size(src.size()) {
+        segtree(const container_type& src) : layout(src.size()), actual_size(src.size()) {
             if (src.size() == 0)
                 return;
             
-            size_type len = 1;
-            while (len < src.size())
-                len <<= 1;
-            
-            node = container_type(len * 2, M::unit());
+            node = container_type(layout.storage_size(), M::unit());
 
-            auto it = node.begin();
-            std::advance(it, len);
-            
-            std::copy(src.begin(), src.end(), it);
+            fill_leaves(src, 0, src.size());
+            build();
+        }
+        // build the subtrees below the top log2(thread_count) levels on separate threads
+        // thread_count = 0 means std::thread::hardware_concurrency()
+        // a layout that is not perfect is built on the calling thread
+        // time complexity: Θ(N / thread_count + thread_count)
+        segtree(const container_type& src, size_type thread_count) : layout(src.size()), actual_size(src.size()) {
+            if (src.size() == 0)
+                return;
+
+            node = container_type(layout.storage_size(), M::unit());
 
-            for (size_type i = len - 1; i > 0; --i)
-                recalc_at(i);
+            if constexpr (!Layout::perfect) {
+                fill_leaves(src, 0, src.size());
+                build();
+                return;
+            }
+
+            const size_type parts = impl::pow2_thread_count(thread_count, layout.leaf_offset());
+            const size_type part_depth = static_cast<size_type>(std::countr_zero(parts));
+            const size_type part_len = layout.leaf_offset() / parts;
+
+            impl::parallel_for(parts, [&](size_type p) {
+                const size_type lo = std::min(p * part_len, size()), hi = std::min(lo + part_len, size());
+
+                fill_leaves(src, lo, hi);
+                build_subtree(parts + p, part_depth, layout.height());
+            });
+
+            build_subtree(1, 0, part_depth);
         }
 
         size_type size() const noexcept {
@@ -82,9 +209,9 @@ namespace adsl {
             if (idx >= size())
                 return;
             
-            idx += node.size() / 2;
+            idx += layout.leaf_offset();
 
-            node[idx] = updater(node[idx]);
+            at(idx) = updater(at(idx));
             while (idx >>= 1)
                 recalc_at(idx);
         }
@@ -94,23 +221,94 @@ namespace adsl {
             update(idx, [=, &v](auto&&) noexcept { return v; });
         }
 
+        // update the value at idx with updater(value at idx, arg) for every (idx, arg) in updates, in the given order
+        // invalid indices are skipped
+        // every inner node above the updated leaves is recalculated once, after the leaves below it, instead of once per update:
+        // in a perfect layout the updates are taken in order of idx, and each leaf climbs only to below the lowest ancestor
+        // it shares with the next one; otherwise all the leaves are written first
+        // time complexity: Θ(K + min(KlogN, N)) for K updates
+        template <std::ranges::random_access_range R, typename F>
+        requires std::ranges::sized_range<R> && requires (std::ranges::range_reference_t<R> u, F& updater, value_type v) {
+            { std::get<0>(u) } -> std::convertible_to<size_type>;
+            { updater(v, std::get<1>(u)) } -> std::convertible_to<value_type>;
+        }
+        void update_batch(R&& updates, F&& updater) {
+            const size_type count = static_cast<size_type>(std::ranges::size(updates));
+            auto nth = [&](size_type k) -> decltype(auto) { return std::ranges::begin(updates)[k]; };
+            auto index_of = [&](size_type k) { return static_cast<size_type>(std::get<0>(nth(k))); };
+
+            if constexpr (Layout::perfect) {
+                std::vector<size_type> order;
+                order.reserve(count);
+                for (size_type k = 0; k < count; ++k) {
+                    if (index_of(k) < size())
+                        order.push_back(k);
+                }
+
+                // stable, so the updates of an index keep their order
+                impl::radix_sort(order, static_cast<int>(layout.height()), index_of);
+
+                const int depth = static_cast<int>(layout.height());
+                for (size_type m = 0; m < order.size(); ) {
+                    const size_type idx = index_of(order[m]);
+                    const size_type leaf = idx + layout.leaf_offset();
+
+                    for (; m < order.size() && index_of(order[m]) == idx; ++m)
+                        at(leaf) = updater(at(leaf), std::get<1>(nth(order[m])));
+
+                    const size_type next = (m < order.size() ? index_of(order[m]) + layout.leaf_offset() : 0);
+                    impl::for_each_ancestor_below(leaf, next, depth, [this](size_type i) { recalc_at(i); });
+                }
+            }
+            else {
+                std::vector<size_type> dirty;
+                dirty.reserve(count);
+
+                for (size_type k = 0; k < count; ++k) {
+                    const size_type idx = index_of(k);
+                    if (idx >= size())
+                        continue;
+
+                    const size_type leaf = idx + layout.leaf_offset();
+                    at(leaf) = updater(at(leaf), std::get<1>(nth(k)));
+                    dirty.push_back(leaf);
+                }
+
+                impl::recalc_ancestors(dirty, layout.leaf_offset(), [this](size_type i) { recalc_at(i); });
+            }
+        }
+
+        // set the value at idx to v for every (idx, v) in updates; the last one wins for a repeated index
+        // time complexity: Θ(K + min(KlogN, N)) for K updates
+        void set_batch(std::span<const std::pair<size_type, value_type>> updates) {
+            update_batch(updates, [](auto&&, const value_type& v) { return v; });
+        }
+
         // accumulate [l, r), return std::nullopt if the given range is invalid
+        // for a VectorizableMonoid a short range is folded by a SIMD scan of its leaves
         // time complexity: Θ(logN)
        std::optional<value_type> accumulate(size_type l, size_type r) const noexcept(noexcept(std::optional<value_type>(M::op(M::unit(), M::unit()))) && std::is_nothrow_copy_assignable_v<value_type>) {
             if (l >= size() || r > size() || l >= r)
                 return std::nullopt;
+
+            if constexpr (use_simd) {
+                if (r - l <= simd_scan_length) {
+                    const value_type* leaf = std::ranges::data(node) + layout.pos(layout.leaf_offset());
+                    return impl::simd_fold<M>(leaf + l, leaf + r);
+                }
+            }
             
-            l += node.size() / 2;
-            r += node.size() / 2;
+            l += layout.leaf_offset();
+            r += layout.leaf_offset();
 
             value_type res_l = M::unit(), res_r = M::unit();
             while (l < r) {
                 if (l & 1) {
-                    res_l = M::op(res_l, node[l]);
+                    res_l = M::op(res_l, at(l));
                     ++l;
                 }
                 if (r & 1)
-                    res_r = M::op(node[r - 1], res_r);
+                    res_r = M::op(at(r - 1), res_r);
 
                 l >>= 1;
                 r >>= 1;
@@ -118,6 +316,124 @@ namespace adsl {
 
             return M::op(res_l, res_r);
         }
+
+        // a read-only view of the values in index order, which stays valid until the tree is destroyed or reassigned
+        // it is a std::span over the leaves when they are stored contiguously
+        auto leaves() const {
+            if constexpr (Layout::contiguous_leaves && std::ranges::contiguous_range<const container_type>) {
+                if (is_empty())
+                    return std::span<const value_type>();
+
+                return std::span<const value_type>(std::ranges::data(node) + layout.pos(layout.leaf_offset()), size());
+            }
+            else {
+                return std::views::iota(size_type{0}, size()) | std::views::transform([this](size_type i) -> const_reference {
+                    return at(layout.leaf_offset() + i);
+                });
+            }
+        }
+
+        // write every value to out in index order
+        // time complexity: Θ(N)
+        template <std::output_iterator<const value_type&> OutputIt>
+        OutputIt materialize(OutputIt out) const {
+            return std::ranges::copy(leaves(), std::move(out)).out;
+        }
+
+        // accumulate every [l, r) in queries and write the results to out in the given order
+        // time complexity: Θ(QlogN)
+        template <std::output_iterator<std::optional<value_type>> OutputIt>
+        OutputIt accumulate_batch(std::span<const std::pair<size_type, size_type>> queries, OutputIt out) const {
+            for (size_type i = 0; i < queries.size(); ++i, ++out) {
+                if (i + batch_prefetch_distance < queries.size())
+                    prefetch_path(queries[i + batch_prefetch_distance]);
+
+                *out = accumulate(queries[i].first, queries[i].second);
+            }
+
+            return out;
+        }
+
+        // return the largest r such that pred holds for the fold of [l, r), where the fold of [l, l) is M::unit()
+        // return std::nullopt if l > size()
+        // contracts: pred(M::unit()) holds and pred is monotone, i.e. once it fails on [l, r), it fails on every longer range
+        // time complexity: Θ(logN)
+        template <std::predicate<const value_type&> Pred>
+        std::optional<size_type> max_right(size_type l, Pred pred) const requires Layout::perfect {
+            if (l > size())
+                return std::nullopt;
+            if (l == size())
+                return size();
+
+            size_type idx = l + layout.leaf_offset();
+            value_type acc = M::unit();
+
+            // climb while the node starting at idx fits, then descend into the first one that does not
+            do {
+                while (!(idx & 1))
+                    idx >>= 1;
+
+                value_type next = M::op(acc, at(idx));
+                if (!pred(std::as_const(next))) {
+                    while (idx < layout.leaf_offset()) {
+                        idx <<= 1;
+
+                        next = M::op(acc, at(idx));
+                        if (pred(std::as_const(next))) {
+                            acc = std::move(next);
+                            ++idx;
+                        }
+                    }
+
+                    return idx - layout.leaf_offset();
+                }
+
+                acc = std::move(next);
+                ++idx;
+            } while (!std::has_single_bit(idx));
+
+            return size();
+        }
+
+        // return the smallest l such that pred holds for the fold of [l, r), where the fold of [r, r) is M::unit()
+        // return std::nullopt if r > size()
+        // contracts: pred(M::unit()) holds and pred is monotone, i.e. once it fails on [l, r), it fails on every longer range
+        // time complexity: Θ(logN)
+        template <std::predicate<const value_type&> Pred>
+        std::optional<size_type> min_left(size_type r, Pred pred) const requires Layout::perfect {
+            if (r > size())
+                return std::nullopt;
+            if (r == 0)
+                return 0;
+
+            size_type idx = r + layout.leaf_offset();
+            value_type acc = M::unit();
+
+            do {
+                --idx;
+                while (idx > 1 && (idx & 1))
+                    idx >>= 1;
+
+                value_type next = M::op(at(idx), acc);
+                if (!pred(std::as_const(next))) {
+                    while (idx < layout.leaf_offset()) {
+                        idx = (idx << 1) + 1;
+
+                        next = M::op(at(idx), acc);
+                        if (pred(std::as_const(next))) {
+                            acc = std::move(next);
+                            --idx;
+                        }
+                    }
+
+                    return idx + 1 - layout.leaf_offset();
+                }
+
+                acc = std::move(next);
+            } while (!std::has_single_bit(idx));
+
+            return 0;
+        }
     };
 
 }
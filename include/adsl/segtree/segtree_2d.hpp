@@ -0,0 +1,143 @@
+#ifndef ADSL_SEGTREE_SEGTREE_2D_HPP
+#define ADSL_SEGTREE_SEGTREE_2D_HPP
+
+#include <cstddef>
+#include <vector>
+#include <optional>
+#include <algorithm>
+#include <concepts>
+#include <utility>
+#include <span>
+#include "../algebra/data_type.hpp"
+#include "../algebra/type_util.hpp"
+
+namespace adsl {
+
+    // a segment tree of segment trees over a rows x cols grid, for monoids without inverses such as min
+    // node (i, j) is column node j of row node i, both heap indices over [rows, 2 rows) and [cols, 2 cols);
+    // all 4 * rows * cols nodes lie in one row-major block, so a row node's column tree is contiguous
+    template <CommutativeMonoid M>
+    requires std::copyable<typename M::value_type>
+    class segtree_2d {
+    public:
+        using value_type = M::value_type;
+        using size_type = std::size_t;
+
+    private:
+        std::vector<value_type> node;
+        size_type row_count = 0, col_count = 0;
+
+        value_type& at(size_type i, size_type j) noexcept {
+            return node[i * (col_count << 1) + j];
+        }
+        const value_type& at(size_type i, size_type j) const noexcept {
+            return node[i * (col_count << 1) + j];
+        }
+
+        // fold the columns [l, r) of row node i
+        value_type accumulate_row(size_type i, size_type l, size_type r) const {
+            value_type res = M::unit();
+            for (l += cols(), r += cols(); l < r; l >>= 1, r >>= 1) {
+                if (l & 1)
+                    res = M::op(res, at(i, l++));
+                if (r & 1)
+                    res = M::op(res, at(i, r - 1));
+            }
+
+            return res;
+        }
+
+        // recompute row node i from its children over every column
+        void recalc_row(size_type i) {
+            value_type* dst = &at(i, 0);
+            const value_type* lhs = &at(i << 1, 0);
+            const value_type* rhs = &at((i << 1) + 1, 0);
+
+            for (size_type j = 1; j < (cols() << 1); ++j)
+                dst[j] = M::op(lhs[j], rhs[j]);
+        }
+
+    public:
+        segtree_2d() = default;
+        segtree_2d(const segtree_2d&) = default;
+        segtree_2d(segtree_2d&&) = default;
+        segtree_2d& operator=(const segtree_2d&) = default;
+        segtree_2d& operator=(segtree_2d&&) = default;
+
+        segtree_2d(size_type _rows, size_type _cols) : node(4 * _rows * _cols, M::unit()), row_count(_rows), col_count(_cols) {}
+        // src holds the grid row-major
+        // contracts: src.size() == _rows * _cols
+        // time complexity: Θ(RC)
+        segtree_2d(size_type _rows, size_type _cols, std::span<const value_type> src) : segtree_2d(_rows, _cols) {
+            if (is_empty())
+                return;
+
+            for (size_type i = 0; i < rows(); ++i) {
+                std::copy_n(src.begin() + i * cols(), cols(), node.begin() + (i + rows()) * (cols() << 1) + cols());
+                for (size_type j = cols() - 1; j > 0; --j)
+                    at(i + rows(), j) = M::op(at(i + rows(), j << 1), at(i + rows(), (j << 1) + 1));
+            }
+
+            for (size_type i = rows() - 1; i > 0; --i)
+                recalc_row(i);
+        }
+
+        size_type rows() const noexcept {
+            return row_count;
+        }
+
+        size_type cols() const noexcept {
+            return col_count;
+        }
+
+        bool is_empty() const noexcept {
+            return rows() == 0 || cols() == 0;
+        }
+
+        // update the value at (r, c) with updater(value at (r, c))
+        // time complexity: Θ(logR logC)
+        template <typename F>
+        void update(size_type r, size_type c, F&& updater)
+        requires requires { {updater(std::declval<value_type>())} -> std::convertible_to<value_type>; }
+        {
+            if (r >= rows() || c >= cols())
+                return;
+
+            size_type i = r + rows();
+            const size_type leaf = c + cols();
+
+            at(i, leaf) = updater(std::as_const(at(i, leaf)));
+            for (size_type j = leaf >> 1; j > 0; j >>= 1)
+                at(i, j) = M::op(at(i, j << 1), at(i, (j << 1) + 1));
+
+            for (i >>= 1; i > 0; i >>= 1)
+                for (size_type j = leaf; j > 0; j >>= 1)
+                    at(i, j) = M::op(at(i << 1, j), at((i << 1) + 1, j));
+        }
+
+        // time complexity: Θ(logR logC)
+        void set(size_type r, size_type c, const value_type& v) {
+            update(r, c, [&v](auto&&) noexcept { return v; });
+        }
+
+        // accumulate [r1, r2) x [c1, c2), return std::nullopt if the given rectangle is invalid
+        // time complexity: Θ(logR logC)
+        std::optional<value_type> accumulate(size_type r1, size_type c1, size_type r2, size_type c2) const {
+            if (r1 >= rows() || r2 > rows() || r1 >= r2 || c1 >= cols() || c2 > cols() || c1 >= c2)
+                return std::nullopt;
+
+            value_type res = M::unit();
+            for (r1 += rows(), r2 += rows(); r1 < r2; r1 >>= 1, r2 >>= 1) {
+                if (r1 & 1)
+                    res = M::op(res, accumulate_row(r1++, c1, c2));
+                if (r2 & 1)
+                    res = M::op(res, accumulate_row(r2 - 1, c1, c2));
+            }
+
+            return res;
+        }
+    };
+
+}
+
+#endif // !ADSL_SEGTREE_SEGTREE_2D_HPP
@@ -0,0 +1,294 @@
+#ifndef ADSL_SEGTREE_SNAPSHOT_HPP
+#define ADSL_SEGTREE_SNAPSHOT_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+#include <optional>
+#include <fstream>
+#include <filesystem>
+#include <memory>
+#include <ranges>
+#include <type_traits>
+#include "../utility/mmap_container.hpp"
+#include "layout.hpp"
+#include "segtree.hpp"
+#include "dual_segtree.hpp"
+#include "lazy_segtree.hpp"
+#include "fenwick_tree.hpp"
+
+namespace adsl {
+
+    // identifies the monoid, action or layout stored in a snapshot
+    // the default hashes the compiler's spelling of T, which differs between compilers and
+    // cannot tell apart two lambdas of the same signature; specialize it to share snapshots safely
+    template <typename T>
+    struct snapshot_type_tag {
+    private:
+        static constexpr std::string_view name() noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+            return __PRETTY_FUNCTION__;
+#elif defined(_MSC_VER)
+            return __FUNCSIG__;
+#else
+            return "";
+#endif
+        }
+
+    public:
+        static constexpr std::uint64_t value = [] {
+            std::uint64_t h = 0xcbf29ce484222325;
+            for (char c : name())
+                h = (h ^ static_cast<unsigned char>(c)) * 0x100000001b3;
+
+            return h;
+        }();
+    };
+
+    enum class snapshot_kind : std::uint32_t {
+        segtree = 1,
+        dual_segtree = 2,
+        lazy_segtree = 3,
+        fenwick_tree = 4,
+    };
+
+    // the file starts with this header, followed by the node array and the lazy array at page-aligned offsets
+    // all fields are in the byte order of the machine that wrote the file
+    struct snapshot_header {
+        static constexpr char expected_magic[8] = { 'A', 'D', 'S', 'L', 'S', 'N', 'A', 'P' };
+        // version 2: lazy_segtree keeps tags for the inner nodes only and its node values include their own tags
+        static constexpr std::uint32_t current_version = 2;
+
+        char magic[8];
+        std::uint32_t version;
+        snapshot_kind kind;
+        std::uint64_t type_tag;
+        std::uint64_t size;
+        std::uint64_t height;
+        std::uint64_t value_size;
+        std::uint64_t operator_size;
+        std::uint64_t node_offset;
+        std::uint64_t node_count;
+        std::uint64_t lazy_offset;
+        std::uint64_t lazy_count;
+    };
+
+    template <typename Tree>
+    struct snapshot_traits {};
+
+    template <typename M, typename C, typename L>
+    struct snapshot_traits<segtree<M, C, L>> {
+        static constexpr snapshot_kind kind = snapshot_kind::segtree;
+        static constexpr std::uint64_t type_tag = snapshot_type_tag<M>::value ^ (snapshot_type_tag<L>::value << 1);
+    };
+
+    template <typename M, typename C, typename L, typename S>
+    struct snapshot_traits<dual_segtree<M, C, L, S>> {
+        static constexpr snapshot_kind kind = snapshot_kind::dual_segtree;
+        static constexpr std::uint64_t type_tag = snapshot_type_tag<M>::value ^ (snapshot_type_tag<L>::value << 1);
+    };
+
+    template <typename A, template <typename T, typename Allocator> typename C, typename L, typename S>
+    struct snapshot_traits<lazy_segtree<A, C, L, S>> {
+        static constexpr snapshot_kind kind = snapshot_kind::lazy_segtree;
+        static constexpr std::uint64_t type_tag = snapshot_type_tag<A>::value ^ (snapshot_type_tag<L>::value << 1);
+    };
+
+    template <typename M, typename C, typename S>
+    struct snapshot_traits<fenwick_tree<M, C, S>> {
+        static constexpr snapshot_kind kind = snapshot_kind::fenwick_tree;
+        static constexpr std::uint64_t type_tag = snapshot_type_tag<M>::value;
+    };
+
+    template <typename Tree>
+    concept Snapshottable = requires { snapshot_traits<Tree>::kind; };
+
+    namespace impl {
+        inline constexpr std::uint64_t snapshot_alignment = 4096;
+
+        inline constexpr std::uint64_t align_snapshot_offset(std::uint64_t offset) noexcept {
+            return (offset + snapshot_alignment - 1) / snapshot_alignment * snapshot_alignment;
+        }
+
+        struct snapshot_access {
+            template <typename Tree>
+            static constexpr bool has_lazy = (snapshot_traits<Tree>::kind == snapshot_kind::lazy_segtree);
+
+            template <typename Tree>
+            static constexpr bool has_layout = (snapshot_traits<Tree>::kind != snapshot_kind::fenwick_tree);
+
+            template <typename Tree>
+            static std::uint64_t height(const Tree& tree) noexcept {
+                if constexpr (has_layout<Tree>)
+                    return tree.layout.height();
+                else
+                    return tree.node.size() == 0 ? 0 : static_cast<std::uint64_t>(std::countr_zero(tree.node.size() - 1));
+            }
+
+            template <typename Tree>
+            static snapshot_header header(const Tree& tree) noexcept {
+                snapshot_header h{};
+                std::memcpy(h.magic, snapshot_header::expected_magic, sizeof(h.magic));
+                h.version = snapshot_header::current_version;
+                h.kind = snapshot_traits<Tree>::kind;
+                h.type_tag = snapshot_traits<Tree>::type_tag;
+                h.size = tree.actual_size;
+                h.height = height(tree);
+                h.value_size = sizeof(typename Tree::value_type);
+                h.node_offset = align_snapshot_offset(sizeof(snapshot_header));
+                h.node_count = tree.node.size();
+
+                if constexpr (has_lazy<Tree>) {
+                    h.operator_size = sizeof(typename Tree::operator_type);
+                    h.lazy_offset = align_snapshot_offset(h.node_offset + h.node_count * h.value_size);
+                    h.lazy_count = tree.lazy.size();
+                }
+
+                return h;
+            }
+
+            template <typename Container>
+            static bool write_array(std::ofstream& out, std::uint64_t offset, const Container& c) {
+                using T = Container::value_type;
+
+                out.seekp(static_cast<std::streamoff>(offset));
+                if constexpr (std::ranges::contiguous_range<const Container&>)
+                    out.write(reinterpret_cast<const char*>(std::ranges::data(c)), static_cast<std::streamsize>(c.size() * sizeof(T)));
+                else {
+                    for (const T& v : c)
+                        out.write(reinterpret_cast<const char*>(&v), sizeof(T));
+                }
+
+                return static_cast<bool>(out);
+            }
+
+            template <typename Tree>
+            static bool save(const Tree& tree, const std::filesystem::path& path) {
+                const snapshot_header h = header(tree);
+
+                std::ofstream out(path, std::ios::binary | std::ios::trunc);
+                if (!out)
+                    return false;
+
+                out.write(reinterpret_cast<const char*>(&h), sizeof(h));
+                if (!write_array(out, h.node_offset, tree.node))
+                    return false;
+
+                if constexpr (has_lazy<Tree>) {
+                    if (!write_array(out, h.lazy_offset, tree.lazy))
+                        return false;
+                }
+
+                out.flush();
+                return static_cast<bool>(out);
+            }
+
+            // whether count elements of elem_size bytes at offset lie within file_size bytes, without overflowing
+            static constexpr bool fits(std::uint64_t offset, std::uint64_t count, std::uint64_t elem_size, std::uint64_t file_size) noexcept {
+                return offset <= file_size && count <= (file_size - offset) / elem_size;
+            }
+
+            template <typename Tree>
+            static bool valid_shape(const snapshot_header& h) noexcept {
+                if constexpr (has_layout<Tree>) {
+                    const typename Tree::layout_type layout(h.size);
+                    const std::uint64_t storage = layout.storage_size();
+
+                    if constexpr (has_lazy<Tree>) {
+                        if (h.lazy_count != Tree::lazy_storage_size(layout))
+                            return false;
+                    }
+
+                    return layout.height() == h.height && h.node_count == storage;
+                }
+                else {
+                    std::uint64_t len = 1;
+                    while (len < h.size)
+                        len <<= 1;
+
+                    // an empty tree built from an empty container has no storage at all
+                    return h.node_count == len + 1 || (h.size == 0 && h.node_count == 0);
+                }
+            }
+
+            template <typename Tree>
+            static std::optional<Tree> open(const std::filesystem::path& path, bool writable) {
+                using value_type = Tree::value_type;
+
+                auto region = mmap_region::file(path.c_str(), writable);
+                if (region == nullptr || region->size() < sizeof(snapshot_header))
+                    return std::nullopt;
+
+                snapshot_header h;
+                std::memcpy(&h, region->data(), sizeof(h));
+
+                if (std::memcmp(h.magic, snapshot_header::expected_magic, sizeof(h.magic)) != 0 ||
+                    h.version != snapshot_header::current_version ||
+                    h.kind != snapshot_traits<Tree>::kind ||
+                    h.type_tag != snapshot_traits<Tree>::type_tag ||
+                    h.value_size != sizeof(value_type) ||
+                    // every value has a leaf in the file, which bounds the size before a layout is built from it
+                    h.size > region->size() / h.value_size ||
+                    !valid_shape<Tree>(h) ||
+                    h.node_offset % alignof(value_type) != 0 ||
+                    !fits(h.node_offset, h.node_count, h.value_size, region->size()))
+                    return std::nullopt;
+
+                Tree tree;
+                tree.actual_size = h.size;
+                tree.node = decltype(tree.node)(region, h.node_offset, h.node_count);
+
+                if constexpr (has_layout<Tree>)
+                    tree.layout = typename Tree::layout_type(h.size);
+
+                if constexpr (has_lazy<Tree>) {
+                    using operator_type = Tree::operator_type;
+
+                    if (h.operator_size != sizeof(operator_type) ||
+                        h.lazy_offset % alignof(operator_type) != 0 ||
+                        !fits(h.lazy_offset, h.lazy_count, h.operator_size, region->size()))
+                        return std::nullopt;
+
+                    tree.lazy = decltype(tree.lazy)(region, h.lazy_offset, h.lazy_count);
+                }
+
+                return tree;
+            }
+
+            template <typename Tree>
+            static bool sync(const Tree& tree) noexcept {
+                bool ok = tree.node.sync();
+                if constexpr (has_lazy<Tree>)
+                    ok = tree.lazy.sync() && ok;
+
+                return ok;
+            }
+        };
+    }
+
+    // write the whole tree to path, return false on I/O failure
+    // the value and operator types must be trivially copyable
+    template <Snapshottable Tree>
+    bool save_snapshot(const Tree& tree, const std::filesystem::path& path) {
+        return impl::snapshot_access::save(tree, path);
+    }
+
+    // open a snapshot written by save_snapshot without copying or rebuilding it
+    // Tree must store its nodes in mmap_container; when writable, updates to the tree go to the file,
+    // otherwise they are copy-on-write and the file is left unchanged
+    // return std::nullopt if the file cannot be mapped or was written for another tree type, monoid or layout
+    template <Snapshottable Tree>
+    std::optional<Tree> open_snapshot(const std::filesystem::path& path, bool writable = true) {
+        return impl::snapshot_access::open<Tree>(path, writable);
+    }
+
+    // flush the updates made to a tree opened by open_snapshot to its file with msync
+    template <Snapshottable Tree>
+    bool sync_snapshot(const Tree& tree) noexcept {
+        return impl::snapshot_access::sync(tree);
+    }
+
+}
+
+#endif // !ADSL_SEGTREE_SNAPSHOT_HPP
\ No newline at end of file
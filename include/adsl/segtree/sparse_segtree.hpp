@@ -0,0 +1,162 @@
+#ifndef ADSL_SEGTREE_SPARSE_SEGTREE_HPP
+#define ADSL_SEGTREE_SPARSE_SEGTREE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <array>
+#include <concepts>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <limits>
+#include <stdexcept>
+#include <bit>
+#include "../algebra/data_type.hpp"
+#include "../algebra/type_util.hpp"
+
+namespace adsl {
+
+    // a segment tree over 64-bit keys [0, size) that creates nodes only on the paths to keys that were written,
+    // so a huge key space such as timestamps or ids needs no coordinate compression
+    // keys never written hold M::unit(); memory is Θ(touched keys * log(size)) nodes, taken from one arena
+    template <Monoid M>
+    requires std::copyable<typename M::value_type>
+    class sparse_segtree {
+    public:
+        using value_type = M::value_type;
+        using key_type = std::uint64_t;
+        using size_type = std::uint64_t;
+
+    private:
+        // 32-bit links keep a node small; the arena holds at most 2^32 - 1 nodes, the indices below the sentinel,
+        // and growing it further throws std::length_error
+        using index_type = std::uint32_t;
+
+        static constexpr index_type null_index = std::numeric_limits<index_type>::max();
+
+        // a node at height h covers the 2^h keys [lo, lo + 2^h) with lo a multiple of 2^h; leaves are at height 0
+        struct node_type {
+            value_type value;
+            std::array<index_type, 2> child;
+        };
+
+        std::vector<node_type> node; // node[0] is the root when the tree is not empty
+        size_type actual_size = 0;
+        unsigned height = 0;
+
+        index_type alloc() {
+            if (node.size() >= null_index)
+                throw std::length_error("adsl::sparse_segtree: too many nodes for 32-bit indices");
+
+            node.push_back(node_type{M::unit(), {null_index, null_index}});
+            return static_cast<index_type>(node.size() - 1);
+        }
+
+        value_type value_of(index_type i) const {
+            return (i == null_index ? M::unit() : node[i].value);
+        }
+
+        // the keys covered by a node at height h are [lo, lo + span(h)]
+        static constexpr key_type span(unsigned h) noexcept {
+            return (h >= std::numeric_limits<key_type>::digits ? std::numeric_limits<key_type>::max() : (key_type{1} << h) - 1);
+        }
+
+        // fold the keys [l, r] within the node i covering [lo, lo + span(h)]
+        value_type fold(index_type i, unsigned h, key_type lo, key_type l, key_type r) const {
+            if (i == null_index)
+                return M::unit();
+            if (l <= lo && lo + span(h) <= r)
+                return node[i].value;
+
+            const key_type mid = lo + span(h - 1) + 1;
+            if (r < mid)
+                return fold(node[i].child[0], h - 1, lo, l, r);
+            if (mid <= l)
+                return fold(node[i].child[1], h - 1, mid, l, r);
+
+            return M::op(fold(node[i].child[0], h - 1, lo, l, r), fold(node[i].child[1], h - 1, mid, l, r));
+        }
+
+    public:
+        sparse_segtree() : sparse_segtree(std::numeric_limits<size_type>::max()) {}
+        sparse_segtree(const sparse_segtree&) = default;
+        sparse_segtree(sparse_segtree&&) = default;
+        sparse_segtree& operator=(const sparse_segtree&) = default;
+        sparse_segtree& operator=(sparse_segtree&&) = default;
+
+        // keys [0, _size); the default covers every key but the largest one
+        explicit sparse_segtree(size_type _size) : actual_size(_size) {
+            if (_size == 0)
+                return;
+
+            height = static_cast<unsigned>(std::bit_width(_size - 1));
+            alloc();
+        }
+
+        size_type size() const noexcept {
+            return actual_size;
+        }
+
+        bool is_empty() const noexcept {
+            return size() == 0;
+        }
+
+        // the number of nodes created so far
+        std::size_t node_count() const noexcept {
+            return node.size();
+        }
+
+        // make room for n nodes, about touched keys * log2(size)
+        void reserve(std::size_t n) {
+            node.reserve(n);
+        }
+
+        // update the value at key with updater(value at key)
+        // throw std::length_error if the arena is full; the nodes created before that hold M::unit(), so the tree stays valid
+        // time complexity: Θ(log(size)), creating at most one node per level
+        template <typename F>
+        void update(key_type key, F&& updater)
+        requires requires { {updater(std::declval<value_type>())} -> std::convertible_to<value_type>; }
+        {
+            if (key >= size())
+                return;
+
+            std::array<index_type, std::numeric_limits<key_type>::digits + 1> path;
+            path[0] = 0;
+            for (unsigned d = 0, h = height; h > 0; ++d, --h) {
+                const unsigned b = static_cast<unsigned>((key >> (h - 1)) & 1);
+                index_type next = node[path[d]].child[b];
+                if (next == null_index) {
+                    next = alloc();
+                    node[path[d]].child[b] = next;
+                }
+
+                path[d + 1] = next;
+            }
+
+            node[path[height]].value = updater(std::as_const(node[path[height]].value));
+            for (unsigned d = height; d-- > 0; ) {
+                const auto& c = node[path[d]].child;
+                node[path[d]].value = M::op(value_of(c[0]), value_of(c[1]));
+            }
+        }
+
+        // time complexity: Θ(log(size))
+        void set(key_type key, const value_type& v) {
+            update(key, [&v](auto&&) { return v; });
+        }
+
+        // accumulate the keys [l, r), return std::nullopt if the given range is invalid
+        // time complexity: Θ(log(size)), skipping subtrees that were never written
+        std::optional<value_type> accumulate(key_type l, key_type r) const {
+            if (l >= size() || r > size() || l >= r)
+                return std::nullopt;
+
+            return fold(0, height, 0, l, r - 1);
+        }
+    };
+
+}
+
+#endif // !ADSL_SEGTREE_SPARSE_SEGTREE_HPP
@@ -0,0 +1,175 @@
+#ifndef ADSL_SEGTREE_STATIC_SEGTREE_HPP
+#define ADSL_SEGTREE_STATIC_SEGTREE_HPP
+
+#include "../algebra/data_type.hpp"
+#include "../algebra/type_util.hpp"
+#include <cstddef>
+#include <concepts>
+#include <utility>
+#include <array>
+#include <span>
+#include <optional>
+#include <bit>
+#include <type_traits>
+
+namespace adsl {
+
+    namespace impl {
+        template <typename F, std::size_t... I>
+        constexpr void unroll_impl(F& f, std::index_sequence<I...>) {
+            (f(std::integral_constant<std::size_t, I>{}), ...);
+        }
+
+        // call f(std::integral_constant<std::size_t, i>{}) for i = 0, 1, ..., Count - 1, expanded at compile time
+        template <std::size_t Count, typename F>
+        constexpr void unroll(F&& f) {
+            unroll_impl(f, std::make_index_sequence<Count>{});
+        }
+    }
+
+    // a segtree over exactly N values whose shape is fixed at compile time, for small trees in hot loops
+    // the nodes live in a std::array, every loop over the levels is unrolled to the fixed height, and everything is constexpr,
+    // so a tree can be built and queried while compiling, e.g. to bake a lookup table
+    // the *_unchecked operations skip the index checks and leave them to the contracts
+    template <Monoid M, std::size_t N>
+    requires (std::copyable<typename M::value_type> && std::default_initializable<typename M::value_type> && N > 0)
+    class static_segtree {
+    public:
+        using value_type = M::value_type;
+        using size_type = std::size_t;
+        using reference = value_type&;
+        using const_reference = const value_type&;
+
+        static constexpr size_type leaf_offset = std::bit_ceil(N);
+        static constexpr size_type height = static_cast<size_type>(std::countr_zero(leaf_offset));
+
+    private:
+        // heap-indexed, the leaves past N hold M::unit()
+        std::array<value_type, leaf_offset * 2> node{};
+
+        constexpr void recalc_at(size_type idx) noexcept(noexcept(M::op(std::declval<value_type>(), std::declval<value_type>()))) {
+            node[idx] = M::op(node[idx << 1], node[(idx << 1) + 1]);
+        }
+
+        constexpr void build() {
+            for (size_type i = leaf_offset; i-- > 1; )
+                recalc_at(i);
+        }
+
+    public:
+        constexpr static_segtree() {
+            node.fill(M::unit());
+        }
+        constexpr static_segtree(const static_segtree&) = default;
+        constexpr static_segtree(static_segtree&&) = default;
+        constexpr static_segtree& operator=(const static_segtree&) = default;
+        constexpr static_segtree& operator=(static_segtree&&) = default;
+
+        // time complexity: Θ(N)
+        constexpr static_segtree(const std::array<value_type, N>& src) : static_segtree() {
+            for (size_type i = 0; i < N; ++i)
+                node[leaf_offset + i] = src[i];
+
+            build();
+        }
+
+        static constexpr size_type size() noexcept {
+            return N;
+        }
+
+        static constexpr bool is_empty() noexcept {
+            return false;
+        }
+
+        // update i-th value with updater(i-th value)
+        // contracts: idx < N
+        // time complexity: Θ(logN)
+        template <typename F>
+        constexpr void update_unchecked(size_type idx, F&& updater)
+        noexcept(noexcept(updater(std::declval<value_type>()), recalc_at(idx)) && std::is_nothrow_copy_assignable_v<value_type>)
+        requires requires { {updater(std::declval<value_type>())} -> std::convertible_to<value_type>; }
+        {
+            idx += leaf_offset;
+
+            node[idx] = updater(node[idx]);
+            impl::unroll<height>([&](auto) {
+                idx >>= 1;
+                recalc_at(idx);
+            });
+        }
+
+        // update i-th value with updater(i-th value)
+        // time complexity: Θ(logN)
+        template <typename F>
+        constexpr void update(size_type idx, F&& updater)
+        noexcept(noexcept(this->update_unchecked(idx, std::forward<F>(updater))))
+        requires requires { {updater(std::declval<value_type>())} -> std::convertible_to<value_type>; }
+        {
+            if (idx >= size())
+                return;
+
+            update_unchecked(idx, std::forward<F>(updater));
+        }
+
+        // contracts: idx < N
+        // time complexity: Θ(logN)
+        constexpr void set_unchecked(size_type idx, const_reference v) noexcept(noexcept(recalc_at(idx)) && std::is_nothrow_copy_assignable_v<value_type>) {
+            update_unchecked(idx, [&v](auto&&) noexcept { return v; });
+        }
+
+        // time complexity: Θ(logN)
+        constexpr void set(size_type idx, const_reference v) noexcept(noexcept(recalc_at(idx)) && std::is_nothrow_copy_assignable_v<value_type>) {
+            if (idx >= size())
+                return;
+
+            set_unchecked(idx, v);
+        }
+
+        // accumulate [l, r)
+        // contracts: l < r <= N
+        // time complexity: Θ(logN)
+        constexpr value_type accumulate_unchecked(size_type l, size_type r) const noexcept(noexcept(M::op(M::unit(), M::unit())) && std::is_nothrow_copy_assignable_v<value_type>) {
+            l += leaf_offset;
+            r += leaf_offset;
+
+            // l < r holds until the two ends meet, after which they stay equal, so the levels above need no check of their own
+            value_type res_l = M::unit(), res_r = M::unit();
+            impl::unroll<height + 1>([&](auto) {
+                if (l < r) {
+                    if (l & 1)
+                        res_l = M::op(res_l, node[l++]);
+                    if (r & 1)
+                        res_r = M::op(node[--r], res_r);
+                }
+
+                l >>= 1;
+                r >>= 1;
+            });
+
+            return M::op(res_l, res_r);
+        }
+
+        // accumulate [l, r), return std::nullopt if the given range is invalid
+        // time complexity: Θ(logN)
+        constexpr std::optional<value_type> accumulate(size_type l, size_type r) const noexcept(noexcept(std::optional<value_type>(accumulate_unchecked(l, r)))) {
+            if (l >= size() || r > size() || l >= r)
+                return std::nullopt;
+
+            return accumulate_unchecked(l, r);
+        }
+
+        // the fold of every value
+        // time complexity: Θ(1)
+        constexpr const_reference accumulate_all() const noexcept {
+            return node[1];
+        }
+
+        // a read-only view of the values in index order
+        constexpr std::span<const value_type, N> leaves() const noexcept {
+            return std::span<const value_type, N>(node.data() + leaf_offset, N);
+        }
+    };
+
+}
+
+#endif // !ADSL_SEGTREE_STATIC_SEGTREE_HPP
@@ -0,0 +1,40 @@
+#ifndef ADSL_UTILITY_CACHE_ALIGNED_ALLOCATOR_HPP
+#define ADSL_UTILITY_CACHE_ALIGNED_ALLOCATOR_HPP
+
+#include <cstddef>
+#include <new>
+#include <algorithm>
+
+namespace adsl {
+
+    namespace impl {
+        inline constexpr std::size_t cache_line_size = 64;
+
+        // an allocator whose blocks start on a cache line
+        template <typename T>
+        struct cache_aligned_allocator {
+            using value_type = T;
+
+            static constexpr std::align_val_t alignment{std::max<std::size_t>(cache_line_size, alignof(T))};
+
+            cache_aligned_allocator() = default;
+            template <typename U>
+            cache_aligned_allocator(const cache_aligned_allocator<U>&) noexcept {}
+
+            T* allocate(std::size_t n) {
+                return static_cast<T*>(::operator new(n * sizeof(T), alignment));
+            }
+            void deallocate(T* p, std::size_t) noexcept {
+                ::operator delete(p, alignment);
+            }
+
+            template <typename U>
+            bool operator==(const cache_aligned_allocator<U>&) const noexcept {
+                return true;
+            }
+        };
+    }
+
+}
+
+#endif // !ADSL_UTILITY_CACHE_ALIGNED_ALLOCATOR_HPP
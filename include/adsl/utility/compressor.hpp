@@ -0,0 +1,191 @@
+#ifndef ADSL_UTILITY_COMPRESSOR_HPP
+#define ADSL_UTILITY_COMPRESSOR_HPP
+
+#include <cstddef>
+#include <vector>
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <concepts>
+#include <optional>
+#include <ranges>
+#include <span>
+#include <bit>
+#include "cache_aligned_allocator.hpp"
+#include "parallel.hpp"
+#include "prefetch.hpp"
+
+namespace adsl {
+
+    // maps a set of keys known in advance onto the dense indices [0, size()) in sorted order
+    // lookups search an Eytzinger (BFS-ordered) copy of the keys without branches, so the top levels share
+    // a few cache lines and the loads of the next levels can be prefetched, unlike a binary search over the sorted keys
+    // the copy is padded with the largest key to a perfect tree, whose in-order ranks follow from the node index alone
+    template <std::copyable Key, typename Compare = std::less<>>
+    requires std::strict_weak_order<Compare&, const Key&, const Key&>
+    class compressor {
+    public:
+        using key_type = Key;
+        using size_type = std::size_t;
+
+        // inputs shorter than this are sorted on the calling thread
+        static constexpr size_type parallel_threshold = size_type{1} << 16;
+
+    private:
+        // the children of the block of nodes [k * B, k * B + B) share a cache line
+        static constexpr size_type block = std::max<size_type>(1, 64 / sizeof(key_type));
+
+        std::vector<key_type> sorted;
+        std::vector<key_type, impl::cache_aligned_allocator<key_type>> eytzinger; // 1-indexed, eytzinger[0] is unused
+        size_type height = 0;
+        [[no_unique_address]] Compare comp;
+
+        void sort_keys(size_type thread_count) {
+            const size_type parts = (sorted.size() < parallel_threshold ? 1 : impl::pow2_thread_count(thread_count, sorted.size() / parallel_threshold));
+            const size_type part_len = (sorted.size() + parts - 1) / parts;
+
+            auto bound = [&](size_type p) {
+                auto it = sorted.begin();
+                std::advance(it, std::min(p * part_len, sorted.size()));
+                return it;
+            };
+
+            impl::parallel_for(parts, [&](size_type p) {
+                std::sort(bound(p), bound(p + 1), comp);
+            });
+            for (size_type width = 1; width < parts; width <<= 1) {
+                impl::parallel_for(parts / (width << 1), [&](size_type p) {
+                    const size_type first = p * (width << 1);
+                    std::inplace_merge(bound(first), bound(first + width), bound(first + (width << 1)), comp);
+                });
+            }
+
+            auto last = std::unique(sorted.begin(), sorted.end(), [this](const key_type& x, const key_type& y) {
+                return !comp(x, y) && !comp(y, x);
+            });
+            sorted.erase(last, sorted.end());
+        }
+
+        // lay out sorted, padded to 2^height - 1 keys, in the in-order of the implicit tree rooted at 1
+        void build_eytzinger() {
+            if (sorted.empty())
+                return;
+
+            height = static_cast<size_type>(std::bit_width(sorted.size()));
+            const size_type n = (size_type{1} << height) - 1;
+            eytzinger.assign(n + 1, sorted.back());
+
+            size_type i = 0;
+            auto fill = [&](auto&& self, size_type k) -> void {
+                if (k > n)
+                    return;
+
+                self(self, k << 1);
+                if (i < sorted.size())
+                    eytzinger[k] = sorted[i];
+                ++i;
+                self(self, (k << 1) + 1);
+            };
+            fill(fill, 1);
+        }
+
+        // the in-order rank of node k of the perfect tree
+        size_type rank(size_type k) const noexcept {
+            const size_type depth = static_cast<size_type>(std::bit_width(k)) - 1;
+            return ((((k - (size_type{1} << depth)) << 1) + 1) << (height - 1 - depth)) - 1;
+        }
+
+        // descend to past a leaf, going right while pred(eytzinger[k]) holds, then undo the final run of right turns
+        // the node left at is the first one for which pred does not hold, or 0 if there is none
+        template <typename Pred>
+        size_type search(Pred pred) const {
+            const key_type* e = eytzinger.data();
+            const size_type n = eytzinger.size() - 1;
+
+            size_type k = 1;
+            while (k <= n) {
+                prefetch(e + std::min(k * block, n));
+                k = (k << 1) + static_cast<size_type>(pred(e[k]));
+            }
+
+            return k >> (std::countr_one(k) + 1);
+        }
+
+    public:
+        compressor() = default;
+
+        // thread_count = 0 means std::thread::hardware_concurrency(); inputs below parallel_threshold use one thread
+        // time complexity: Θ(N logN / thread_count + N)
+        template <std::ranges::input_range R>
+        requires std::convertible_to<std::ranges::range_reference_t<R>, key_type>
+        explicit compressor(R&& keys, size_type thread_count = 0, Compare _comp = {}) : comp(std::move(_comp)) {
+            if constexpr (std::ranges::sized_range<R>)
+                sorted.reserve(static_cast<size_type>(std::ranges::size(keys)));
+            for (auto&& k : keys)
+                sorted.push_back(k);
+
+            sort_keys(thread_count);
+            build_eytzinger();
+        }
+
+        // the number of distinct keys
+        size_type size() const noexcept {
+            return sorted.size();
+        }
+
+        bool is_empty() const noexcept {
+            return size() == 0;
+        }
+
+        // the distinct keys in sorted order, key(i) is the key of index i
+        std::span<const key_type> keys() const noexcept {
+            return sorted;
+        }
+
+        const key_type& key(size_type idx) const noexcept {
+            return sorted[idx];
+        }
+
+        // the index of the first key not less than key, or size() if there is none
+        // time complexity: Θ(logN)
+        size_type lower_bound(const key_type& key) const {
+            if (is_empty())
+                return 0;
+
+            const size_type k = search([&](const key_type& x) { return comp(x, key); });
+            return (k == 0 ? size() : rank(k));
+        }
+
+        // the index of the first key greater than key, or size() if there is none
+        // time complexity: Θ(logN)
+        size_type upper_bound(const key_type& key) const {
+            if (is_empty())
+                return 0;
+
+            const size_type k = search([&](const key_type& x) { return !comp(key, x); });
+            return (k == 0 ? size() : rank(k));
+        }
+
+        // the index of key, return std::nullopt if it is not one of the keys
+        // time complexity: Θ(logN)
+        std::optional<size_type> index(const key_type& key) const {
+            if (is_empty())
+                return std::nullopt;
+
+            const size_type k = search([&](const key_type& x) { return comp(x, key); });
+            if (k == 0 || comp(key, eytzinger[k]))
+                return std::nullopt;
+
+            return rank(k);
+        }
+    };
+
+    template <std::ranges::input_range R>
+    compressor(R&&) -> compressor<std::ranges::range_value_t<R>>;
+
+    template <std::ranges::input_range R>
+    compressor(R&&, std::size_t) -> compressor<std::ranges::range_value_t<R>>;
+
+}
+
+#endif // !ADSL_UTILITY_COMPRESSOR_HPP
@@ -0,0 +1,216 @@
+#ifndef ADSL_UTILITY_MMAP_CONTAINER_HPP
+#define ADSL_UTILITY_MMAP_CONTAINER_HPP
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <utility>
+#include <algorithm>
+#include <type_traits>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace adsl {
+
+    namespace impl {
+        // an owned memory mapping, either anonymous or of a whole file
+        class mmap_region {
+            void* addr = nullptr;
+            std::size_t length = 0;
+            bool file_backed = false;
+
+            mmap_region(void* _addr, std::size_t _length, bool _file_backed) noexcept : addr(_addr), length(_length), file_backed(_file_backed) {}
+
+            static std::shared_ptr<mmap_region> adopt(void* p, std::size_t length, bool file_backed) noexcept {
+                mmap_region* region = new (std::nothrow) mmap_region(p, length, file_backed);
+                if (region == nullptr) {
+                    ::munmap(p, length);
+                    return nullptr;
+                }
+
+                // the shared_ptr constructor deletes region, and so unmaps it, if it fails to allocate
+                try {
+                    return std::shared_ptr<mmap_region>(region);
+                }
+                catch (...) {
+                    return nullptr;
+                }
+            }
+
+        public:
+            mmap_region(const mmap_region&) = delete;
+            mmap_region& operator=(const mmap_region&) = delete;
+
+            ~mmap_region() {
+                if (addr != nullptr)
+                    ::munmap(addr, length);
+            }
+
+            // return nullptr on failure
+            static std::shared_ptr<mmap_region> anonymous(std::size_t length) noexcept {
+                void* p = ::mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+                if (p == MAP_FAILED)
+                    return nullptr;
+
+                return adopt(p, length, false);
+            }
+
+            // map the whole file; a writable mapping is shared, so that writes through it reach the file,
+            // otherwise the mapping is private and copy-on-write, so that writes stay in memory
+            // return nullptr on failure
+            static std::shared_ptr<mmap_region> file(const char* path, bool writable) noexcept {
+                const int fd = ::open(path, writable ? O_RDWR : O_RDONLY);
+                if (fd < 0)
+                    return nullptr;
+
+                struct stat st;
+                if (::fstat(fd, &st) != 0 || st.st_size <= 0) {
+                    ::close(fd);
+                    return nullptr;
+                }
+
+                const std::size_t length = static_cast<std::size_t>(st.st_size);
+                void* p = ::mmap(nullptr, length, PROT_READ | PROT_WRITE, writable ? MAP_SHARED : MAP_PRIVATE, fd, 0);
+                ::close(fd);
+
+                if (p == MAP_FAILED)
+                    return nullptr;
+
+                return adopt(p, length, writable);
+            }
+
+            std::byte* data() const noexcept {
+                return static_cast<std::byte*>(addr);
+            }
+
+            std::size_t size() const noexcept {
+                return length;
+            }
+
+            // flush the dirty pages of [offset, offset + len) to the file
+            bool sync(std::size_t offset, std::size_t len) const noexcept {
+                if (!file_backed)
+                    return true;
+
+                const std::size_t page = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+                const std::size_t begin = offset / page * page;
+
+                return ::msync(data() + begin, offset + len - begin, MS_SYNC) == 0;
+            }
+        };
+    }
+
+    // a fixed-size array stored in a memory mapping
+    // a default-filled container lives in anonymous memory; a container opened from a file views a shared mapping of it
+    // copies are always deep and anonymous, so a copy never writes to the file
+    // Allocator is ignored; it only makes the template usable as the Container of lazy_segtree
+    template <typename T, typename Allocator = std::allocator<T>>
+    requires std::is_trivially_copyable_v<T>
+    class mmap_container {
+    public:
+        using value_type = T;
+        using size_type = std::size_t;
+        using difference_type = std::ptrdiff_t;
+        using reference = T&;
+        using const_reference = const T&;
+        using pointer = T*;
+        using const_pointer = const T*;
+        using iterator = T*;
+        using const_iterator = const T*;
+
+    private:
+        std::shared_ptr<impl::mmap_region> region;
+        std::size_t offset = 0;
+        size_type count = 0;
+
+        void allocate(size_type n) {
+            count = n;
+            if (n == 0)
+                return;
+
+            region = impl::mmap_region::anonymous(n * sizeof(T));
+            if (region == nullptr)
+                throw std::bad_alloc();
+        }
+
+    public:
+        mmap_container() = default;
+        mmap_container(size_type n, const T& v) {
+            allocate(n);
+            std::fill(begin(), end(), v);
+        }
+        // view n elements placed at byte offset _offset of _region
+        // contracts: the elements fit in _region and _offset is aligned for T
+        mmap_container(std::shared_ptr<impl::mmap_region> _region, std::size_t _offset, size_type n) noexcept
+            : region(std::move(_region)), offset(_offset), count(n) {}
+
+        mmap_container(const mmap_container& other) {
+            allocate(other.size());
+            std::copy(other.begin(), other.end(), begin());
+        }
+        mmap_container(mmap_container&& other) noexcept
+            : region(std::move(other.region)), offset(std::exchange(other.offset, 0)), count(std::exchange(other.count, 0)) {}
+
+        mmap_container& operator=(const mmap_container& other) {
+            if (this != &other)
+                *this = mmap_container(other);
+
+            return *this;
+        }
+        mmap_container& operator=(mmap_container&& other) noexcept {
+            region = std::move(other.region);
+            offset = std::exchange(other.offset, 0);
+            count = std::exchange(other.count, 0);
+
+            return *this;
+        }
+
+        T* data() noexcept {
+            return (region == nullptr ? nullptr : reinterpret_cast<T*>(region->data() + offset));
+        }
+        const T* data() const noexcept {
+            return (region == nullptr ? nullptr : reinterpret_cast<const T*>(region->data() + offset));
+        }
+
+        iterator begin() noexcept {
+            return data();
+        }
+        const_iterator begin() const noexcept {
+            return data();
+        }
+        iterator end() noexcept {
+            return data() + count;
+        }
+        const_iterator end() const noexcept {
+            return data() + count;
+        }
+
+        size_type size() const noexcept {
+            return count;
+        }
+
+        bool empty() const noexcept {
+            return count == 0;
+        }
+
+        reference operator[](size_type idx) noexcept {
+            return data()[idx];
+        }
+        const_reference operator[](size_type idx) const noexcept {
+            return data()[idx];
+        }
+
+        // flush the elements to the backing file with msync, which trivially succeeds for anonymous memory
+        bool sync() const noexcept {
+            if (region == nullptr || count == 0)
+                return true;
+
+            return region->sync(offset, count * sizeof(T));
+        }
+    };
+
+}
+
+#endif // !ADSL_UTILITY_MMAP_CONTAINER_HPP
\ No newline at end of file
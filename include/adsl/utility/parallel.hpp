@@ -0,0 +1,52 @@
+#ifndef ADSL_UTILITY_PARALLEL_HPP
+#define ADSL_UTILITY_PARALLEL_HPP
+
+#include <cstddef>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <bit>
+
+namespace adsl {
+
+    namespace impl {
+        // the number of threads to use when the caller passes 0
+        inline std::size_t default_thread_count() noexcept {
+            const std::size_t n = std::thread::hardware_concurrency();
+            return (n == 0 ? 1 : n);
+        }
+
+        // the largest power of two not exceeding thread_count (or the hardware concurrency if it is 0), capped by limit
+        inline std::size_t pow2_thread_count(std::size_t thread_count, std::size_t limit) noexcept {
+            if (thread_count == 0)
+                thread_count = default_thread_count();
+
+            return std::bit_floor(std::min(thread_count, std::max<std::size_t>(limit, 1)));
+        }
+
+        // run f(i) for every i <- [0, n), each on its own thread, and wait for all of them
+        // the calling thread runs f(0); f must not throw
+        template <typename F>
+        void parallel_for(std::size_t n, F&& f) {
+            std::vector<std::jthread> workers;
+            workers.reserve(n > 0 ? n - 1 : 0);
+
+            for (std::size_t i = 1; i < n; ++i)
+                workers.emplace_back([&f, i] { f(i); });
+
+            if (n > 0)
+                f(std::size_t{0});
+        }
+
+        // a small number identifying the calling thread, handed out in order of first use
+        inline std::size_t thread_slot() noexcept {
+            static std::atomic<std::size_t> next{0};
+            thread_local const std::size_t slot = next.fetch_add(1, std::memory_order_relaxed);
+
+            return slot;
+        }
+    }
+
+}
+
+#endif // !ADSL_UTILITY_PARALLEL_HPP
\ No newline at end of file
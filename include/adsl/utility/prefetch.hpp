@@ -0,0 +1,18 @@
+#ifndef ADSL_UTILITY_PREFETCH_HPP
+#define ADSL_UTILITY_PREFETCH_HPP
+
+namespace adsl {
+
+    // hint that the cache line containing p will be read soon
+    // this is a no-op on compilers without a prefetch builtin
+    inline void prefetch(const void* p) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+        __builtin_prefetch(p);
+#else
+        (void)p;
+#endif
+    }
+
+}
+
+#endif // !ADSL_UTILITY_PREFETCH_HPP
\ No newline at end of file
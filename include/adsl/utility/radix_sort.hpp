@@ -0,0 +1,53 @@
+#ifndef ADSL_UTILITY_RADIX_SORT_HPP
+#define ADSL_UTILITY_RADIX_SORT_HPP
+
+#include <cstddef>
+#include <vector>
+#include <array>
+#include <algorithm>
+#include <concepts>
+#include <utility>
+#include <functional>
+#include <type_traits>
+
+namespace adsl {
+
+    namespace impl {
+        // the widest digit of radix_sort, whose counters then fit in L1
+        inline constexpr int radix_bits = 11;
+
+        // sort v stably by key(e) < 2^bits, in passes of at most radix_bits bits from the lowest ones
+        // unlike a comparison sort it takes no branch on the keys, which mispredicts on random ones,
+        // so it suits the bounded node indices sorted by the batched updates
+        // time complexity: Θ((N + 2^radix_bits) * bits / radix_bits)
+        template <typename T, typename Key = std::identity>
+        requires std::default_initializable<T> && std::unsigned_integral<std::remove_cvref_t<std::invoke_result_t<Key&, const T&>>>
+        void radix_sort(std::vector<T>& v, int bits, Key key = {}) {
+            if (v.size() <= 1)
+                return;
+
+            const int passes = (bits + radix_bits - 1) / radix_bits;
+            const int width = (passes == 0 ? 0 : (bits + passes - 1) / passes);
+            const std::size_t mask = (std::size_t{1} << width) - 1;
+
+            std::vector<T> buf(v.size());
+            std::array<std::size_t, (std::size_t{1} << radix_bits) + 1> count;
+
+            for (int p = 0, shift = 0; p < passes; ++p, shift += width) {
+                std::fill_n(count.begin(), mask + 2, 0);
+                for (const T& e : v)
+                    ++count[((static_cast<std::size_t>(key(e)) >> shift) & mask) + 1];
+                for (std::size_t d = 1; d <= mask; ++d)
+                    count[d] += count[d - 1];
+
+                for (T& e : v)
+                    buf[count[(static_cast<std::size_t>(key(e)) >> shift) & mask]++] = std::move(e);
+
+                std::swap(v, buf);
+            }
+        }
+    }
+
+}
+
+#endif // !ADSL_UTILITY_RADIX_SORT_HPP
@@ -0,0 +1,95 @@
+#ifndef ADSL_UTILITY_SEQLOCK_HPP
+#define ADSL_UTILITY_SEQLOCK_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <atomic>
+#include <array>
+#include <bit>
+#include <type_traits>
+
+namespace adsl {
+
+    namespace impl {
+        // the widest word that tiles T and is aligned within it
+        template <typename T>
+        using racy_word_t =
+            std::conditional_t<sizeof(T) % 8 == 0 && alignof(T) % 8 == 0, std::uint64_t,
+            std::conditional_t<sizeof(T) % 4 == 0 && alignof(T) % 4 == 0, std::uint32_t,
+            std::conditional_t<sizeof(T) % 2 == 0 && alignof(T) % 2 == 0, std::uint16_t, std::uint8_t>>>;
+
+        // copy a value that another thread may be storing with racy_store, word by word with relaxed atomics
+        // the copy may be torn; a seqlock tells the reader whether to retry
+        template <typename T>
+        requires std::is_trivially_copyable_v<T>
+        T racy_load(const T& src) noexcept {
+            using word = racy_word_t<T>;
+            constexpr std::size_t count = sizeof(T) / sizeof(word);
+
+            std::array<word, count> buf;
+            const word* p = reinterpret_cast<const word*>(&src);
+            for (std::size_t i = 0; i < count; ++i)
+                buf[i] = std::atomic_ref<word>(const_cast<word&>(p[i])).load(std::memory_order_relaxed);
+
+            return std::bit_cast<T>(buf);
+        }
+
+        template <typename T>
+        requires std::is_trivially_copyable_v<T>
+        void racy_store(T& dst, const T& v) noexcept {
+            using word = racy_word_t<T>;
+            constexpr std::size_t count = sizeof(T) / sizeof(word);
+
+            const auto buf = std::bit_cast<std::array<word, count>>(v);
+            word* p = reinterpret_cast<word*>(&dst);
+            for (std::size_t i = 0; i < count; ++i)
+                std::atomic_ref<word>(p[i]).store(buf[i], std::memory_order_relaxed);
+        }
+
+        // a sequence lock: the counter is odd while a write is in progress
+        // writers must exclude each other by other means; readers never block them
+        // the fences follow Boehm, "Can Seqlocks Get Along With Programming Language Memory Models?"
+        class seqlock {
+            std::atomic<std::uint64_t> seq{0};
+
+        public:
+            // wait until no write is in progress and return the counter to validate against
+            std::uint64_t read_begin() const noexcept {
+                std::uint64_t s = seq.load(std::memory_order_acquire);
+                while (s & 1) {
+#if defined(__x86_64__) || defined(__i386__)
+                    __builtin_ia32_pause();
+#endif
+                    s = seq.load(std::memory_order_acquire);
+                }
+
+                return s;
+            }
+
+            // return true if nothing was written since read_begin returned s
+            bool read_validate(std::uint64_t s) const noexcept {
+                std::atomic_thread_fence(std::memory_order_acquire);
+                return seq.load(std::memory_order_relaxed) == s;
+            }
+
+            // the counter as it is now, with no ordering of its own
+            // a reader of several seqlocks runs read_begin on each, reads, issues one acquire fence and then compares
+            // this with what read_begin returned; the counters never decrease, so equal sums mean none of them moved
+            std::uint64_t read_current() const noexcept {
+                return seq.load(std::memory_order_relaxed);
+            }
+
+            void write_begin() noexcept {
+                seq.store(seq.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_release);
+            }
+
+            void write_end() noexcept {
+                seq.store(seq.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+            }
+        };
+    }
+
+}
+
+#endif // !ADSL_UTILITY_SEQLOCK_HPP
@@ -0,0 +1,48 @@
+#ifndef ADSL_UTILITY_SIMD_HPP
+#define ADSL_UTILITY_SIMD_HPP
+
+#include <cstddef>
+#include "../algebra/data_type.hpp"
+
+namespace adsl {
+
+    namespace impl {
+        // number of independent accumulators, enough to fill two 256-bit registers
+        template <typename T>
+        inline constexpr std::size_t simd_lanes = (sizeof(T) >= 64 ? 1 : 64 / sizeof(T));
+
+        // fold [first, last) with M::op
+        // the lanes have no dependency on each other, so compilers lower the loop to SSE/AVX/NEON instructions
+        template <VectorizableMonoid M>
+        constexpr typename M::value_type simd_fold(const typename M::value_type* first, const typename M::value_type* last) noexcept {
+            using value_type = M::value_type;
+            constexpr std::size_t lanes = simd_lanes<value_type>;
+
+            value_type acc[lanes];
+            for (std::size_t k = 0; k < lanes; ++k)
+                acc[k] = M::unit();
+
+            for (; last - first >= static_cast<std::ptrdiff_t>(lanes); first += lanes)
+                for (std::size_t k = 0; k < lanes; ++k)
+                    acc[k] = M::op(acc[k], first[k]);
+
+            value_type res = M::unit();
+            for (std::size_t k = 0; k < lanes; ++k)
+                res = M::op(res, acc[k]);
+            for (; first != last; ++first)
+                res = M::op(res, *first);
+
+            return res;
+        }
+
+        // dst[i] = M::op(src[2i], src[2i + 1]) for i <- [0, n)
+        template <VectorizableMonoid M>
+        constexpr void simd_fold_pairs(const typename M::value_type* src, typename M::value_type* dst, std::size_t n) noexcept {
+            for (std::size_t i = 0; i < n; ++i)
+                dst[i] = M::op(src[i << 1], src[(i << 1) + 1]);
+        }
+    }
+
+}
+
+#endif // !ADSL_UTILITY_SIMD_HPP
\ No newline at end of file
@@ -0,0 +1,107 @@
+#ifndef ADSL_UTILITY_STATS_HPP
+#define ADSL_UTILITY_STATS_HPP
+
+#include <cstdint>
+#include <concepts>
+#include <algorithm>
+
+namespace adsl {
+
+    // the counters kept by a statistics policy; each tree fills in the ones that apply to it
+    // building a tree is not counted, only the operations on it; a call rejected for an invalid index or range counts nothing
+    struct tree_stats {
+        std::uint64_t operations = 0;       // calls of the public operations that passed validation, one per valid element of a batch
+        std::uint64_t ops = 0;              // calls of the monoid op on values
+        std::uint64_t acts = 0;             // operators applied to a value
+        std::uint64_t compositions = 0;     // operators composed into a lazy tag
+        std::uint64_t node_reads = 0;
+        std::uint64_t node_writes = 0;
+        std::uint64_t propagations = 0;     // nodes whose tag was handed to their children
+        std::uint64_t max_propagations = 0; // the most propagations made by a single operation
+    };
+
+    enum class tree_stat {
+        op,
+        act,
+        composition,
+        node_read,
+        node_write,
+        propagation,
+    };
+
+    // a statistics policy is told when an operation begins and what it does, and reports the totals by snapshot()
+    // the trees call it from const member functions as well, so a policy that counts keeps its counters mutable
+    template <typename S>
+    concept StatsPolicy = std::default_initializable<S> && std::copyable<S> && requires(const S& stats, S& mut_stats, tree_stat kind, std::uint64_t n) {
+        stats.begin_operation();
+        stats.count(kind, n);
+        { stats.snapshot() } -> std::same_as<tree_stats>;
+        mut_stats.reset();
+    };
+
+    // the default policy: every call is empty and inlines away, and the trees store it in no space
+    struct null_stats {
+        void begin_operation() const noexcept {}
+        void count(tree_stat, std::uint64_t = 1) const noexcept {}
+
+        tree_stats snapshot() const noexcept {
+            return {};
+        }
+
+        void reset() noexcept {}
+    };
+
+    // plain counters; like the trees themselves, not safe to share between threads without a lock
+    class counting_stats {
+        mutable tree_stats counters;
+        mutable std::uint64_t propagations_at_begin = 0;
+
+        // close the running operation by taking its propagations into the maximum
+        void close_operation() const noexcept {
+            counters.max_propagations = std::max(counters.max_propagations, counters.propagations - propagations_at_begin);
+            propagations_at_begin = counters.propagations;
+        }
+
+    public:
+        void begin_operation() const noexcept {
+            close_operation();
+            ++counters.operations;
+        }
+
+        void count(tree_stat kind, std::uint64_t n = 1) const noexcept {
+            switch (kind) {
+                case tree_stat::op:
+                    counters.ops += n;
+                    break;
+                case tree_stat::act:
+                    counters.acts += n;
+                    break;
+                case tree_stat::composition:
+                    counters.compositions += n;
+                    break;
+                case tree_stat::node_read:
+                    counters.node_reads += n;
+                    break;
+                case tree_stat::node_write:
+                    counters.node_writes += n;
+                    break;
+                case tree_stat::propagation:
+                    counters.propagations += n;
+                    break;
+            }
+        }
+
+        tree_stats snapshot() const noexcept {
+            close_operation();
+            return counters;
+        }
+
+        void reset() noexcept {
+            counters = {};
+            propagations_at_begin = 0;
+        }
+    };
+
+}
+
+#endif // !ADSL_UTILITY_STATS_HPP
@@ -34,6 +34,6 @@ int main() {
             seg.append(s, t, x);
         }
         else
-            std::cout << *seg.accumulate(s, t) << std::endl;
+            std::cout << *seg.accumulate(s, t) << "\n";
     }
 }
\ No newline at end of file
@@ -0,0 +1,148 @@
+// checks atomic_fenwick_tree against a plain array for N = 0..100 on one thread, with one copy and with four,
+// then joins writer threads appending known amounts, while a reader checks that its prefix sums never go back,
+// and compares the totals with the fold of what they appended, over addition and over xor
+
+#include <iostream>
+#include <vector>
+#include <optional>
+#include <utility>
+#include <random>
+#include <thread>
+#include <atomic>
+#include <type_traits>
+
+#include "adsl/segtree/atomic_fenwick_tree.hpp"
+#include "../common.hpp"
+
+using namespace adsl_test;
+
+constexpr std::size_t max_n = 100;
+constexpr std::size_t queries_per_n = 400;
+
+constexpr std::size_t writer_count = 4;
+constexpr std::size_t appends_per_writer = 20000;
+
+using sum_group = adsl::default_group<i64>;
+
+// not additive, so append_at goes through the compare-exchange loop
+using xor_monoid = adsl::make_monoid<u64, u64{0}, [](u64 x, u64 y) { return x ^ y; }, true>;
+
+template <typename M, std::size_t Stripes, typename Random>
+void check(const char* name, std::mt19937_64& rng, Random random_value) {
+    using value_type = M::value_type;
+
+    for (std::size_t n = 0; n <= max_n; ++n) {
+        std::vector<value_type> model(n);
+        for (auto&& e : model)
+            e = random_value(rng);
+
+        adsl::atomic_fenwick_tree<M, Stripes> fw = (n % 2 == 0 ? adsl::atomic_fenwick_tree<M, Stripes>(model) : adsl::atomic_fenwick_tree<M, Stripes>(n));
+        if (n % 2 != 0) {
+            for (std::size_t i = 0; i < n; ++i)
+                fw.append_at(i, model[i]);
+        }
+        ADSL_CHECK(fw.size() == n);
+
+        for (std::size_t q = 0; q < queries_per_n; ++q) {
+            std::size_t l = rng() % (n + 1), r = rng() % (n + 1);
+            if (rng() % 8 != 0 && l > r)
+                std::swap(l, r);
+
+            const value_type v = random_value(rng);
+
+            switch (rng() % 3) {
+                case 0:
+                    fw.append_at(l, v);
+                    if (l < n)
+                        model[l] = M::op(model[l], v);
+                    break;
+                case 1:
+                    ADSL_CHECK(fw.accumulate(l) == (l < n ? std::optional(fold<M>(model, 0, l + 1)) : std::nullopt));
+                    break;
+                default:
+                    if constexpr (adsl::CommutativeGroup<M>)
+                        ADSL_CHECK(fw.accumulate(l, r) == (l < r ? std::optional(fold<M>(model, l, r)) : std::nullopt));
+                    break;
+            }
+        }
+    }
+
+    std::cout << name << " Stripes = " << Stripes << ": ok\n";
+}
+
+// the value appended by a writer; kept below 100 so that sums do not go back
+template <typename M>
+typename M::value_type thread_value(std::mt19937_64& rng) {
+    return static_cast<M::value_type>(rng() % 100);
+}
+
+template <typename M, std::size_t Stripes>
+void check_threads(const char* name, std::size_t n) {
+    using value_type = M::value_type;
+
+    adsl::atomic_fenwick_tree<M, Stripes> fw(n);
+    std::atomic<bool> done = false;
+
+    // for addition, appends are nonnegative and each read of a node sees no older value than the last read of it,
+    // so the prefix sums read by one thread never decrease
+    std::thread reader([&]() {
+        value_type last = M::unit();
+        while (!done.load(std::memory_order_acquire)) {
+            const value_type cur = *fw.accumulate(n - 1);
+            if constexpr (std::is_same_v<M, sum_group>)
+                ADSL_CHECK(cur >= last);
+            last = cur;
+        }
+    });
+
+    std::vector<std::thread> writers;
+    for (std::size_t t = 0; t < writer_count; ++t) {
+        writers.emplace_back([&fw, n, t]() {
+            std::mt19937_64 rng(t);
+            for (std::size_t k = 0; k < appends_per_writer; ++k) {
+                const std::size_t i = rng() % n;
+                fw.append_at(i, thread_value<M>(rng));
+            }
+        });
+    }
+
+    for (auto&& th : writers)
+        th.join();
+
+    done.store(true, std::memory_order_release);
+    reader.join();
+
+    // replay the same streams on one thread
+    std::vector<value_type> model(n);
+    for (std::size_t t = 0; t < writer_count; ++t) {
+        std::mt19937_64 rng(t);
+        for (std::size_t k = 0; k < appends_per_writer; ++k) {
+            const std::size_t i = rng() % n;
+            model[i] = M::op(model[i], thread_value<M>(rng));
+        }
+    }
+
+    for (std::size_t i = 0; i < n; ++i)
+        ADSL_CHECK(fw.accumulate(i) == fold<M>(model, 0, i + 1));
+
+    std::cout << name << " threads Stripes = " << Stripes << " N = " << n << ": ok\n";
+}
+
+int main() {
+    std::mt19937_64 rng(0);
+
+    auto random_i64 = [](std::mt19937_64& r) { return static_cast<i64>(r() % 2001) - 1000; };
+    auto random_u64 = [](std::mt19937_64& r) { return static_cast<u64>(r()); };
+
+    check<sum_group, 1>("sum_i64", rng, random_i64);
+    check<sum_group, 4>("sum_i64", rng, random_i64);
+    check<xor_monoid, 1>("xor_u64", rng, random_u64);
+    check<xor_monoid, 4>("xor_u64", rng, random_u64);
+
+    for (std::size_t n : { 1, 7, 1000 }) {
+        check_threads<sum_group, 1>("sum_i64", n);
+        check_threads<sum_group, 4>("sum_i64", n);
+        check_threads<xor_monoid, 1>("xor_u64", n);
+        check_threads<xor_monoid, 4>("xor_u64", n);
+    }
+}
@@ -0,0 +1,131 @@
+// checks fenwick_tree::append_at_batch and segtree::update_batch against a plain array for N = 0..100,
+// with batches of one update, a few, either side of the size at which append_at_batch switches to its dense pass,
+// and more than N, each holding out-of-range and repeated indices
+
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <limits>
+#include <optional>
+#include <utility>
+#include <random>
+#include <bit>
+
+#include "adsl/segtree/fenwick_tree.hpp"
+#include "adsl/segtree/segtree.hpp"
+#include "adsl/segtree/layout.hpp"
+#include "../common.hpp"
+
+using namespace adsl_test;
+
+constexpr std::size_t max_n = 100;
+constexpr std::size_t batches_per_size = 4;
+
+using sum_group = adsl::default_group<i64>;
+using max_monoid = adsl::make_monoid<i64, std::numeric_limits<i64>::min(), [](i64 x, i64 y) { return std::max(x, y); }, true>;
+
+// batch sizes for a tree over n values; len is the number of fenwick nodes, the dense pass starts at K bit_width(len) >= len
+std::vector<std::size_t> batch_sizes(std::size_t n) {
+    const std::size_t len = std::bit_ceil(std::max<std::size_t>(n, 1));
+    const std::size_t dense = (len + std::bit_width(len) - 1) / std::bit_width(len);
+
+    std::vector<std::size_t> sizes = { 1, 2, 5, dense + 1, 2 * n + 3 };
+    if (dense > 1)
+        sizes.push_back(dense - 1);
+    sizes.push_back(dense);
+
+    return sizes;
+}
+
+// indices mostly below n, a few at or past it, and often repeated
+template <typename T, typename Random>
+std::vector<std::pair<std::size_t, T>> random_batch(std::mt19937_64& rng, std::size_t n, std::size_t k, Random random_value) {
+    std::vector<std::pair<std::size_t, T>> batch(k);
+    for (std::size_t m = 0; m < k; ++m) {
+        std::size_t idx = rng() % (n + 2);
+        if (m > 0 && rng() % 4 == 0)
+            idx = batch[rng() % m].first;
+        if (rng() % 16 == 0)
+            idx = std::numeric_limits<std::size_t>::max() - rng() % 2;
+
+        batch[m] = { idx, random_value(rng) };
+    }
+
+    return batch;
+}
+
+template <typename M, typename Random>
+void check_fenwick_tree(const char* name, std::mt19937_64& rng, Random random_value) {
+    using value_type = M::value_type;
+
+    for (std::size_t n = 0; n <= max_n; ++n) {
+        std::vector<value_type> model(n);
+        for (auto&& e : model)
+            e = random_value(rng);
+
+        adsl::fenwick_tree<M> fw(model);
+
+        for (std::size_t k : batch_sizes(n)) {
+            for (std::size_t b = 0; b < batches_per_size; ++b) {
+                const auto batch = random_batch<value_type>(rng, n, k, random_value);
+
+                fw.append_at_batch(batch);
+                for (const auto& [idx, inc] : batch) {
+                    if (idx < n)
+                        model[idx] = M::op(model[idx], inc);
+                }
+
+                for (std::size_t i = 0; i < n; ++i)
+                    ADSL_CHECK(fw.accumulate(i) == fold<M>(model, 0, i + 1));
+            }
+        }
+    }
+
+    std::cout << "fenwick_tree " << name << ": ok\n";
+}
+
+template <typename Layout>
+void check_segtree(const char* name, std::mt19937_64& rng) {
+    using tree = adsl::segtree<affine_monoid, std::vector<affine>, Layout>;
+
+    for (std::size_t n = 0; n <= max_n; ++n) {
+        std::vector<affine> model(n);
+        for (auto&& e : model)
+            e = random_affine(rng);
+
+        tree seg(model);
+
+        for (std::size_t k : batch_sizes(n)) {
+            for (std::size_t b = 0; b < batches_per_size; ++b) {
+                const auto batch = random_batch<affine>(rng, n, k, random_affine);
+
+                // not commutative, so the updates of a repeated index must run in the order given
+                seg.update_batch(batch, [](const affine& x, const affine& f) { return affine_monoid::op(x, f); });
+                for (const auto& [idx, f] : batch) {
+                    if (idx < n)
+                        model[idx] = affine_monoid::op(model[idx], f);
+                }
+
+                ADSL_CHECK(std::ranges::equal(seg.leaves(), model));
+                for (std::size_t q = 0; q < 2 * n; ++q) {
+                    const auto [l, r] = random_range(rng, n);
+                    ADSL_CHECK(seg.accumulate(l, r) == fold(model, l, r));
+                }
+            }
+        }
+    }
+
+    std::cout << "segtree " << name << ": ok\n";
+}
+
+int main() {
+    std::mt19937_64 rng(0);
+
+    check_fenwick_tree<sum_group>("sum_i64", rng, [](std::mt19937_64& r) { return static_cast<i64>(r() % 2001) - 1000; });
+    check_fenwick_tree<max_monoid>("max_i64", rng, [](std::mt19937_64& r) { return static_cast<i64>(r() % 2001) - 1000; });
+
+    check_segtree<adsl::binary_heap_layout>("binary_heap_layout", rng);
+    check_segtree<adsl::truncated_heap_layout>("truncated_heap_layout", rng);
+    check_segtree<adsl::compact_heap_layout>("compact_heap_layout", rng);
+    check_segtree<adsl::blocked_heap_layout<3>>("blocked_heap_layout<3>", rng);
+}
@@ -0,0 +1,87 @@
+// checks beats_segtree against a plain array for N = 0..100, on values drawn from a narrow range
+// so that the largest and smallest values of a node often repeat and clamps often meet the runner-ups
+
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <optional>
+#include <utility>
+#include <random>
+
+#include "adsl/segtree/beats_segtree.hpp"
+#include "../common.hpp"
+
+using namespace adsl_test;
+
+constexpr std::size_t max_n = 100;
+constexpr std::size_t queries_per_n = 500;
+
+template <typename T>
+void check(const char* name, std::mt19937_64& rng) {
+    auto random_value = [&rng]() { return static_cast<T>(static_cast<i64>(rng() % 41) - 20); };
+
+    for (std::size_t n = 0; n <= max_n; ++n) {
+        std::vector<T> model(n);
+        for (auto&& e : model)
+            e = random_value();
+
+        adsl::beats_segtree<T> seg(model);
+        ADSL_CHECK(seg.size() == n);
+
+        for (std::size_t q = 0; q < queries_per_n; ++q) {
+            std::size_t l = rng() % (n + 1), r = rng() % (n + 1);
+            if (rng() % 8 != 0 && l > r)
+                std::swap(l, r);
+
+            const bool valid = l < r;
+            const T x = random_value();
+
+            switch (rng() % 7) {
+                case 0:
+                    seg.chmin(l, r, x);
+                    for (std::size_t i = l; i < r; ++i)
+                        model[i] = std::min(model[i], x);
+                    break;
+                case 1:
+                    seg.chmax(l, r, x);
+                    for (std::size_t i = l; i < r; ++i)
+                        model[i] = std::max(model[i], x);
+                    break;
+                case 2:
+                    seg.add(l, r, x);
+                    for (std::size_t i = l; i < r; ++i)
+                        model[i] += x;
+                    break;
+                case 3: {
+                    T expected = 0;
+                    for (std::size_t i = l; i < r; ++i)
+                        expected += model[i];
+
+                    ADSL_CHECK(seg.sum(l, r) == (valid ? std::optional(expected) : std::nullopt));
+                    break;
+                }
+                case 4:
+                    ADSL_CHECK(seg.max(l, r) == (valid ? std::optional(*std::max_element(model.begin() + l, model.begin() + r)) : std::nullopt));
+                    break;
+                case 5:
+                    ADSL_CHECK(seg.min(l, r) == (valid ? std::optional(*std::min_element(model.begin() + l, model.begin() + r)) : std::nullopt));
+                    break;
+                default:
+                    ADSL_CHECK(seg.calc(l) == (l < n ? std::optional(model[l]) : std::nullopt));
+                    break;
+            }
+        }
+
+        for (std::size_t i = 0; i < n; ++i)
+            ADSL_CHECK(seg.calc(i) == model[i]);
+    }
+
+    std::cout << name << ": ok\n";
+}
+
+int main() {
+    std::mt19937_64 rng(0);
+
+    check<i64>("i64", rng);
+    check<i32>("i32", rng);
+}
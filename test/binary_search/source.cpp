@@ -0,0 +1,292 @@
+// checks max_right / min_left of segtree and lazy_segtree on the perfect layouts, and fenwick_tree::lower_bound,
+// against a linear search over a plain array for N = 1..80
+// the segtree monoid keeps the best subarray sum, which is not commutative; lazy_segtree is run with range assignment,
+// both on that monoid and on max, where the action does not keep the unit
+
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <limits>
+#include <random>
+#include <iterator>
+
+#include "adsl/segtree/segtree.hpp"
+#include "adsl/segtree/lazy_segtree.hpp"
+#include "adsl/segtree/fenwick_tree.hpp"
+#include "adsl/segtree/layout.hpp"
+#include "../common.hpp"
+
+using namespace adsl_test;
+
+constexpr std::size_t max_n = 80;
+constexpr std::size_t queries_per_n = 300;
+constexpr i64 neg_inf = std::numeric_limits<i64>::min() / 4;
+
+// the sum, best prefix, best suffix and best subarray sum of a range, none of which is empty
+struct segment {
+    i64 sum = 0, pre = neg_inf, suf = neg_inf, best = neg_inf;
+    i64 len = 0;
+
+    static segment of(i64 x) {
+        return { x, x, x, x, 1 };
+    }
+
+    friend bool operator==(const segment&, const segment&) = default;
+};
+
+struct segment_monoid {
+    using value_type = segment;
+
+    static value_type unit() noexcept {
+        return {};
+    }
+
+    static value_type op(const value_type& x, const value_type& y) noexcept {
+        if (x.len == 0)
+            return y;
+        if (y.len == 0)
+            return x;
+
+        return {
+            x.sum + y.sum,
+            std::max(x.pre, x.sum + y.pre),
+            std::max(y.suf, x.suf + y.sum),
+            std::max({ x.best, y.best, x.suf + y.pre }),
+            x.len + y.len
+        };
+    }
+};
+
+struct max_monoid : adsl::commutative_tag {
+    using value_type = i64;
+
+    static value_type unit() noexcept {
+        return neg_inf;
+    }
+
+    static value_type op(const value_type& x, const value_type& y) noexcept {
+        return std::max(x, y);
+    }
+};
+
+// assign v if set; the newer tag wins, and lazy_segtree composes a node's tag with a newer one in that order
+struct assign {
+    bool set = false;
+    i64 v = 0;
+
+    friend bool operator==(const assign&, const assign&) = default;
+};
+
+struct assign_monoid : adsl::commutative_tag {
+    using value_type = assign;
+
+    static value_type unit() noexcept {
+        return {};
+    }
+
+    static value_type op(const value_type& older, const value_type& newer) noexcept {
+        return (newer.set ? newer : older);
+    }
+};
+
+struct assign_segment_action {
+    using domain = assign_monoid;
+    using space = segment_monoid;
+
+    static auto act(const assign& f) noexcept {
+        return [f](const segment& s) noexcept { return act(f, s); };
+    }
+    static segment act(const assign& f, const segment& s) noexcept {
+        if (!f.set || s.len == 0)
+            return s;
+
+        const i64 top = (f.v > 0 ? f.v * s.len : f.v);
+        return { f.v * s.len, top, top, top, s.len };
+    }
+};
+
+// does not keep the unit, unlike assign_segment_action, which leaves an empty range empty
+struct assign_max_action {
+    using domain = assign_monoid;
+    using space = max_monoid;
+
+    static auto act(const assign& f) noexcept {
+        return [f](i64 x) noexcept { return act(f, x); };
+    }
+    static i64 act(const assign& f, i64 x) noexcept {
+        return (f.set ? f.v : x);
+    }
+};
+
+i64 random_value(std::mt19937_64& rng) {
+    return static_cast<i64>(rng() % 21) - 10;
+}
+
+// the largest r with pred(fold of [l, r)), and the smallest l with pred(fold of [l, r)), by a linear search
+template <typename M, typename Pred>
+std::size_t brute_max_right(const std::vector<typename M::value_type>& v, std::size_t l, Pred pred) {
+    typename M::value_type acc = M::unit();
+    for (std::size_t r = l; r < v.size(); ++r) {
+        acc = M::op(acc, v[r]);
+        if (!pred(acc))
+            return r;
+    }
+
+    return v.size();
+}
+
+template <typename M, typename Pred>
+std::size_t brute_min_left(const std::vector<typename M::value_type>& v, std::size_t r, Pred pred) {
+    typename M::value_type acc = M::unit();
+    for (std::size_t l = r; l > 0; --l) {
+        acc = M::op(v[l - 1], acc);
+        if (!pred(acc))
+            return l;
+    }
+
+    return 0;
+}
+
+template <typename Layout>
+void check_segtree(std::mt19937_64& rng) {
+    for (std::size_t n = 1; n <= max_n; ++n) {
+        std::vector<segment> model(n);
+        for (auto&& e : model)
+            e = segment::of(random_value(rng));
+
+        adsl::segtree<segment_monoid, std::vector<segment>, Layout> seg(model);
+
+        for (std::size_t q = 0; q < queries_per_n; ++q) {
+            const i64 bound = static_cast<i64>(rng() % 60) - 10;
+            auto pred = [bound](const segment& s) { return s.best < bound; };
+
+            switch (rng() % 3) {
+                case 0: {
+                    const std::size_t i = rng() % n;
+                    model[i] = segment::of(random_value(rng));
+                    seg.set(i, model[i]);
+                    break;
+                }
+                case 1: {
+                    const std::size_t l = rng() % (n + 1);
+                    ADSL_CHECK(seg.max_right(l, pred) == brute_max_right<segment_monoid>(model, l, pred));
+                    ADSL_CHECK(!seg.max_right(n + 1, pred));
+                    break;
+                }
+                default: {
+                    const std::size_t r = rng() % (n + 1);
+                    ADSL_CHECK(seg.min_left(r, pred) == brute_min_left<segment_monoid>(model, r, pred));
+                    ADSL_CHECK(!seg.min_left(n + 1, pred));
+                    break;
+                }
+            }
+        }
+    }
+}
+
+template <typename Act, typename Layout, typename Leaf, typename MakePred>
+void check_lazy_segtree(std::mt19937_64& rng, Leaf leaf, MakePred make_pred) {
+    using space = Act::space;
+    using value_type = space::value_type;
+
+    for (std::size_t n = 1; n <= max_n; ++n) {
+        std::vector<value_type> model(n);
+        for (auto&& e : model)
+            e = leaf(random_value(rng));
+
+        adsl::lazy_segtree<Act, std::vector, Layout> seg(model);
+
+        for (std::size_t q = 0; q < queries_per_n; ++q) {
+            auto pred = make_pred(static_cast<i64>(rng() % 60) - 10);
+
+            switch (rng() % 3) {
+                case 0: {
+                    std::size_t l = rng() % n, r = rng() % n;
+                    if (l > r)
+                        std::swap(l, r);
+                    ++r;
+
+                    const assign f{ true, random_value(rng) };
+                    seg.append(l, r, f);
+                    for (std::size_t i = l; i < r; ++i)
+                        model[i] = Act::act(f, model[i]);
+                    break;
+                }
+                case 1: {
+                    const std::size_t l = rng() % (n + 1);
+                    ADSL_CHECK(seg.max_right(l, pred) == brute_max_right<space>(model, l, pred));
+                    break;
+                }
+                default: {
+                    const std::size_t r = rng() % (n + 1);
+                    ADSL_CHECK(seg.min_left(r, pred) == brute_min_left<space>(model, r, pred));
+                    break;
+                }
+            }
+        }
+
+        std::vector<value_type> values;
+        seg.materialize(std::back_inserter(values));
+        ADSL_CHECK(values == model);
+    }
+}
+
+template <typename Layout>
+void check_layout(const char* name, std::mt19937_64& rng) {
+    check_segtree<Layout>(rng);
+
+    check_lazy_segtree<assign_segment_action, Layout>(rng, segment::of, [](i64 bound) {
+        return [bound](const segment& s) { return s.best < bound; };
+    });
+    check_lazy_segtree<assign_max_action, Layout>(rng, [](i64 x) { return x; }, [](i64 bound) {
+        return [bound](i64 x) { return x < bound; };
+    });
+
+    std::cout << name << ": ok\n";
+}
+
+void check_fenwick_tree(std::mt19937_64& rng) {
+    for (std::size_t n = 1; n <= max_n; ++n) {
+        std::vector<i64> model(n);
+        for (auto&& e : model)
+            e = static_cast<i64>(rng() % 4);
+
+        adsl::fenwick_tree<adsl::default_group<i64>> fw(model);
+
+        for (std::size_t q = 0; q < queries_per_n; ++q) {
+            if (rng() % 2 == 0) {
+                const std::size_t i = rng() % n;
+                const i64 inc = static_cast<i64>(rng() % 4);
+                fw.append_at(i, inc);
+                model[i] += inc;
+                continue;
+            }
+
+            // the smallest idx whose prefix sum [0, idx] is not less than value
+            const i64 value = static_cast<i64>(rng() % (4 * n + 2));
+            std::size_t expected = n;
+            i64 prefix = 0;
+            for (std::size_t i = 0; i < n; ++i) {
+                prefix += model[i];
+                if (!(prefix < value)) {
+                    expected = i;
+                    break;
+                }
+            }
+
+            ADSL_CHECK(fw.lower_bound(value) == expected);
+        }
+    }
+
+    std::cout << "fenwick_tree: ok\n";
+}
+
+int main() {
+    std::mt19937_64 rng(0);
+
+    check_layout<adsl::binary_heap_layout>("binary_heap_layout", rng);
+    check_layout<adsl::truncated_heap_layout>("truncated_heap_layout", rng);
+    check_layout<adsl::blocked_heap_layout<3>>("blocked_heap_layout<3>", rng);
+
+    check_fenwick_tree(rng);
+}
@@ -0,0 +1,93 @@
+// checks blocked_segtree against a plain array for N = 0..150 and several block sizes,
+// covering the patching update of an integral group, the rescanning update with a SIMD scan of min,
+// and the plain scan of a monoid that is not commutative
+
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <limits>
+#include <optional>
+#include <utility>
+#include <random>
+#include <iterator>
+
+#include "adsl/segtree/blocked_segtree.hpp"
+#include "../common.hpp"
+
+using namespace adsl_test;
+
+constexpr std::size_t max_n = 150;
+constexpr std::size_t queries_per_n = 200;
+
+// opts in to the SIMD scan
+struct min_monoid : adsl::make_monoid<i32, std::numeric_limits<i32>::max(), [](i32 x, i32 y) { return std::min(x, y); }, true>, adsl::vectorizable_tag {};
+
+template <typename M, std::size_t B, typename Random>
+void check(const char* name, std::mt19937_64& rng, Random random_value) {
+    using value_type = M::value_type;
+    using tree = adsl::blocked_segtree<M, B>;
+
+    for (std::size_t n = 0; n <= max_n; ++n) {
+        std::vector<value_type> model(n);
+        for (auto&& e : model)
+            e = random_value(rng);
+
+        tree seg = (n % 2 == 0 ? tree(model) : tree(n));
+        if (n % 2 != 0) {
+            for (std::size_t i = 0; i < n; ++i)
+                seg.set(i, model[i]);
+        }
+
+        for (std::size_t q = 0; q < queries_per_n; ++q) {
+            std::size_t l = rng() % (n + 1), r = rng() % (n + 1);
+            if (rng() % 8 != 0 && l > r)
+                std::swap(l, r);
+
+            const value_type v = random_value(rng);
+
+            switch (rng() % 4) {
+                case 0:
+                    seg.set(l, v);
+                    if (l < n)
+                        model[l] = v;
+                    break;
+                case 1:
+                    seg.update(l, [&v](const value_type& x) { return M::op(x, v); });
+                    if (l < n)
+                        model[l] = M::op(model[l], v);
+                    break;
+                case 2:
+                    ADSL_CHECK(seg.calc(l) == (l < n ? std::optional(model[l]) : std::nullopt));
+                    break;
+                default:
+                    ADSL_CHECK(seg.accumulate(l, r) == (l < r ? std::optional(fold<M>(model, l, r)) : std::nullopt));
+                    break;
+            }
+        }
+
+        ADSL_CHECK(seg.accumulate_all() == (n > 0 ? std::optional(fold<M>(model, 0, n)) : std::nullopt));
+        ADSL_CHECK(std::ranges::equal(seg.leaves(), model));
+
+        std::vector<value_type> values;
+        seg.materialize(std::back_inserter(values));
+        ADSL_CHECK(values == model);
+    }
+
+    std::cout << name << " B = " << B << ": ok\n";
+}
+
+template <std::size_t B>
+void check_block_size(std::mt19937_64& rng) {
+    check<adsl::default_group<i64>, B>("sum_i64", rng, [](std::mt19937_64& r) { return static_cast<i64>(r() % 2001) - 1000; });
+    check<min_monoid, B>("min_i32", rng, [](std::mt19937_64& r) { return static_cast<i32>(r() % 1000000); });
+    check<affine_monoid, B>("affine", rng, [](std::mt19937_64& r) { return affine{ r() % mod, r() % mod }; });
+}
+
+int main() {
+    std::mt19937_64 rng(0);
+
+    check_block_size<1>(rng);
+    check_block_size<3>(rng);
+    check_block_size<16>(rng);
+    check_block_size<64>(rng);
+}
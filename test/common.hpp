@@ -0,0 +1,101 @@
+#ifndef ADSL_TEST_COMMON_HPP
+#define ADSL_TEST_COMMON_HPP
+
+#include <iostream>
+#include <vector>
+#include <utility>
+#include <random>
+#include <cstdint>
+#include <cstdlib>
+#include "adsl/algebra/data_type.hpp"
+
+// the checks stay on in release builds, unlike assert
+#define ADSL_CHECK(...) ((__VA_ARGS__) ? void() : ::adsl_test::fail(#__VA_ARGS__, __FILE__, __LINE__))
+
+// the monoids and helpers shared by the tests, each of which compares a tree against a brute-force model
+namespace adsl_test {
+
+    using i32 = std::int32_t;
+    using i64 = std::int64_t;
+    using u32 = std::uint32_t;
+    using u64 = std::uint64_t;
+
+    [[noreturn]] inline void fail(const char* expr, const char* file, int line) {
+        std::cerr << file << ":" << line << ": check failed: " << expr << std::endl;
+        std::exit(EXIT_FAILURE);
+    }
+
+    inline constexpr u64 mod = 998244353;
+
+    // x -> a x + b over Z/mod, composed so that op(f, g) applies f first, then g
+    // it is not commutative, so a tree that swaps two operands gets a different result
+    struct affine {
+        u64 a = 1, b = 0;
+
+        friend bool operator==(const affine&, const affine&) = default;
+    };
+
+    struct affine_monoid {
+        using value_type = affine;
+
+        static constexpr value_type unit() noexcept {
+            return {};
+        }
+
+        static constexpr value_type op(const value_type& f, const value_type& g) noexcept {
+            return { f.a * g.a % mod, (g.a * f.b + g.b) % mod };
+        }
+    };
+
+    // the nonzero residues under multiplication
+    struct scale_monoid : adsl::commutative_tag {
+        using value_type = u64;
+
+        static constexpr value_type unit() noexcept {
+            return 1;
+        }
+
+        static constexpr value_type op(const value_type& x, const value_type& y) noexcept {
+            return x * y % mod;
+        }
+    };
+
+    // conjugate an affine map by x -> s x, which maps (a, b) to (a, s b) and keeps the order of compositions
+    struct scale_affine_action {
+        using domain = scale_monoid;
+        using space = affine_monoid;
+
+        static constexpr auto act(const domain::value_type& s) noexcept {
+            return [s](const space::value_type& f) noexcept { return act(s, f); };
+        }
+        static constexpr space::value_type act(const domain::value_type& s, const space::value_type& f) noexcept {
+            return { f.a, s * f.b % mod };
+        }
+    };
+
+    inline affine random_affine(std::mt19937_64& rng) {
+        return { rng() % mod, rng() % mod };
+    }
+
+    // a random [l, r) with l < r <= n
+    inline std::pair<std::size_t, std::size_t> random_range(std::mt19937_64& rng, std::size_t n) {
+        std::size_t l = rng() % n, r = rng() % n;
+        if (l > r)
+            std::swap(l, r);
+
+        return { l, r + 1 };
+    }
+
+    // fold [l, r) of v from left to right
+    template <typename M = affine_monoid>
+    M::value_type fold(const std::vector<typename M::value_type>& v, std::size_t l, std::size_t r) {
+        typename M::value_type res = M::unit();
+        for (std::size_t i = l; i < r; ++i)
+            res = M::op(res, v[i]);
+
+        return res;
+    }
+
+}
+
+#endif // !ADSL_TEST_COMMON_HPP
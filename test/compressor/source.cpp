@@ -0,0 +1,209 @@
+// checks compressor against std::lower_bound / std::upper_bound over the sorted distinct keys, including the threaded
+// sort and a reversed order, and keyed_tree over each of the four trees against a std::map of the keys
+
+#include <iostream>
+#include <vector>
+#include <map>
+#include <algorithm>
+#include <functional>
+#include <optional>
+#include <utility>
+#include <random>
+
+#include "adsl/utility/compressor.hpp"
+#include "adsl/segtree/keyed_tree.hpp"
+#include "adsl/segtree/segtree.hpp"
+#include "adsl/segtree/fenwick_tree.hpp"
+#include "adsl/segtree/lazy_segtree.hpp"
+#include "adsl/segtree/dual_segtree.hpp"
+#include "../common.hpp"
+
+using namespace adsl_test;
+
+constexpr u64 key_range = 1000;
+constexpr std::size_t queries_per_tree = 3000;
+
+template <typename Compare>
+void check_compressor(const std::vector<u64>& keys, std::size_t thread_count, Compare comp, std::mt19937_64& rng) {
+    const adsl::compressor<u64, Compare> cmp(keys, thread_count, comp);
+
+    std::vector<u64> sorted = keys;
+    std::ranges::sort(sorted, comp);
+    sorted.erase(std::unique(sorted.begin(), sorted.end(), [&](u64 x, u64 y) { return !comp(x, y) && !comp(y, x); }), sorted.end());
+
+    ADSL_CHECK(cmp.size() == sorted.size());
+    ADSL_CHECK(std::ranges::equal(cmp.keys(), sorted));
+
+    for (std::size_t q = 0; q < 2000; ++q) {
+        const u64 key = (q % 2 == 0 && !keys.empty() ? keys[rng() % keys.size()] : rng() % (key_range + 2));
+
+        const auto lo = static_cast<std::size_t>(std::ranges::lower_bound(sorted, key, comp) - sorted.begin());
+        const auto hi = static_cast<std::size_t>(std::ranges::upper_bound(sorted, key, comp) - sorted.begin());
+
+        ADSL_CHECK(cmp.lower_bound(key) == lo);
+        ADSL_CHECK(cmp.upper_bound(key) == hi);
+        ADSL_CHECK(cmp.index(key) == (lo < hi ? std::optional(lo) : std::nullopt));
+    }
+}
+
+std::vector<u64> random_keys(std::size_t n, u64 range, std::mt19937_64& rng) {
+    std::vector<u64> keys(n);
+    for (auto&& k : keys)
+        k = rng() % range;
+
+    return keys;
+}
+
+// the model maps every known key to its value; a range op covers the known keys in [l, r)
+template <typename F>
+void for_each_in(std::map<u64, i64>& model, u64 l, u64 r, F f) {
+    for (auto it = model.lower_bound(l); it != model.end() && it->first < r; ++it)
+        f(it->second);
+}
+
+// a range fold of the known keys in [l, r), or std::nullopt if none of them lies in it
+std::optional<i64> sum_in(std::map<u64, i64>& model, u64 l, u64 r) {
+    std::optional<i64> res;
+    for_each_in(model, l, r, [&](i64 v) { res = res.value_or(0) + v; });
+    return res;
+}
+
+void check_keyed_trees(std::mt19937_64& rng) {
+    for (std::size_t n : { 0, 1, 2, 7, 64, 300 }) {
+        const std::vector<u64> keys = random_keys(n, key_range, rng);
+        const adsl::compressor cmp(keys);
+
+        std::map<u64, i64> base;
+        for (u64 k : keys)
+            base[k] = 0;
+
+        auto random_key = [&]() {
+            return (rng() % 2 == 0 && n > 0 ? keys[rng() % n] : rng() % (key_range + 2));
+        };
+        auto random_range = [&]() {
+            u64 l = random_key(), r = random_key();
+            return std::pair(std::min(l, r), std::max(l, r) + rng() % 2);
+        };
+
+        // segtree: update, set and range sums
+        {
+            adsl::keyed_tree<adsl::segtree<adsl::default_monoid<i64>>, u64> kt(cmp);
+            std::map<u64, i64> model = base;
+
+            for (std::size_t q = 0; q < queries_per_tree; ++q) {
+                const u64 key = random_key();
+                const i64 v = static_cast<i64>(rng() % 100);
+
+                if (q % 3 == 0) {
+                    kt.update(key, [v](i64 x) { return x + v; });
+                    if (model.contains(key))
+                        model[key] += v;
+                }
+                else if (q % 3 == 1) {
+                    kt.set(key, v);
+                    if (model.contains(key))
+                        model[key] = v;
+                }
+                else {
+                    const auto [l, r] = random_range();
+                    ADSL_CHECK(kt.accumulate(l, r) == sum_in(model, l, r));
+                }
+            }
+        }
+
+        // fenwick_tree: append_at, prefix sums of the keys not greater than key, and range sums
+        {
+            adsl::keyed_tree<adsl::fenwick_tree<adsl::default_group<i64>>, u64> kt(cmp);
+            std::map<u64, i64> model = base;
+
+            for (std::size_t q = 0; q < queries_per_tree; ++q) {
+                const u64 key = random_key();
+
+                if (q % 3 == 0) {
+                    const i64 v = static_cast<i64>(rng() % 100);
+                    kt.append_at(key, v);
+                    if (model.contains(key))
+                        model[key] += v;
+                }
+                else if (q % 3 == 1)
+                    ADSL_CHECK(kt.accumulate(key) == sum_in(model, 0, key + 1));
+                else {
+                    const auto [l, r] = random_range();
+                    ADSL_CHECK(kt.accumulate(l, r) == sum_in(model, l, r));
+                }
+            }
+        }
+
+        // lazy_segtree: range scaling of affine maps and their fold in key order
+        {
+            adsl::keyed_tree<adsl::lazy_segtree<scale_affine_action>, u64> kt(cmp);
+            std::map<u64, affine> model;
+            for (u64 k : keys)
+                model[k] = affine{};
+
+            for (std::size_t q = 0; q < queries_per_tree; ++q) {
+                const auto [l, r] = random_range();
+
+                if (q % 3 == 0) {
+                    const affine f = { rng() % mod, rng() % mod };
+                    const u64 key = random_key();
+                    kt.set(key, f);
+                    if (model.contains(key))
+                        model[key] = f;
+                }
+                else if (q % 3 == 1) {
+                    const u64 s = rng() % (mod - 1) + 1;
+                    kt.append(l, r, s);
+                    for (auto it = model.lower_bound(l); it != model.end() && it->first < r; ++it)
+                        it->second = scale_affine_action::act(s, it->second);
+                }
+                else {
+                    std::optional<affine> expected;
+                    for (auto it = model.lower_bound(l); it != model.end() && it->first < r; ++it)
+                        expected = affine_monoid::op(expected.value_or(affine{}), it->second);
+
+                    ADSL_CHECK(kt.accumulate(l, r) == expected);
+                }
+            }
+        }
+
+        // dual_segtree: range add and point reads
+        {
+            adsl::keyed_tree<adsl::dual_segtree<adsl::default_monoid<i64>>, u64> kt(cmp);
+            std::map<u64, i64> model = base;
+
+            for (std::size_t q = 0; q < queries_per_tree; ++q) {
+                if (q % 2 == 0) {
+                    const auto [l, r] = random_range();
+                    const i64 v = static_cast<i64>(rng() % 100);
+                    kt.append(l, r, v);
+                    for_each_in(model, l, r, [v](i64& x) { x += v; });
+                }
+                else {
+                    const u64 key = random_key();
+                    ADSL_CHECK(kt.calc(key) == (model.contains(key) ? std::optional(model[key]) : std::nullopt));
+                }
+            }
+        }
+    }
+}
+
+int main() {
+    std::mt19937_64 rng(0);
+
+    for (std::size_t n : { 0, 1, 2, 3, 10, 100, 1000 }) {
+        check_compressor(random_keys(n, key_range, rng), 1, std::less<>(), rng);
+        check_compressor(random_keys(n, key_range, rng), 1, std::greater<>(), rng);
+    }
+
+    // past parallel_threshold, so the chunks are sorted on separate threads and merged
+    const std::size_t large = adsl::compressor<u64>::parallel_threshold * 3 + 17;
+    check_compressor(random_keys(large, key_range * 100, rng), 4, std::less<>(), rng);
+    check_compressor(random_keys(large, key_range * 100, rng), 3, std::greater<>(), rng);
+
+    std::cout << "compressor: ok\n";
+
+    check_keyed_trees(rng);
+
+    std::cout << "keyed_tree: ok\n";
+}
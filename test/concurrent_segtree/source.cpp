@@ -0,0 +1,168 @@
+// checks concurrent_segtree against a plain array for N = 0..100 on one thread and several shard counts,
+// then under concurrent writers and readers:
+//   - each leaf holds {x, 3x}, so a sum with y != 3x means a reader saw a half-written value
+//   - leaves only grow, so repeated queries of one range must never decrease
+//   - one writer bumps a leaf of the first, a middle and the last shard in that order, so a query over all of them
+//     that counts a later bump without an earlier one did not read the shards at a single moment
+
+#include <iostream>
+#include <vector>
+#include <optional>
+#include <utility>
+#include <random>
+#include <thread>
+#include <atomic>
+
+#include "adsl/segtree/concurrent_segtree.hpp"
+#include "../common.hpp"
+
+using namespace adsl_test;
+
+constexpr std::size_t max_n = 100;
+constexpr std::size_t queries_per_n = 300;
+
+void check_model(std::mt19937_64& rng) {
+    for (std::size_t shard_count : { 1, 2, 4, 8 }) {
+        for (std::size_t n = 0; n <= max_n; ++n) {
+            std::vector<affine> model(n);
+            for (auto&& e : model)
+                e = random_affine(rng);
+
+            adsl::concurrent_segtree<affine_monoid> seg = (n % 2 == 0 ? adsl::concurrent_segtree<affine_monoid>(model, shard_count) : adsl::concurrent_segtree<affine_monoid>(n, shard_count));
+            if (n % 2 != 0) {
+                for (std::size_t i = 0; i < n; ++i)
+                    seg.set(i, model[i]);
+            }
+            ADSL_CHECK(seg.size() == n);
+
+            for (std::size_t q = 0; q < queries_per_n; ++q) {
+                std::size_t l = rng() % (n + 1), r = rng() % (n + 1);
+                if (rng() % 8 != 0 && l > r)
+                    std::swap(l, r);
+
+                const affine f = random_affine(rng);
+
+                switch (rng() % 3) {
+                    case 0:
+                        seg.set(l, f);
+                        if (l < n)
+                            model[l] = f;
+                        break;
+                    case 1:
+                        seg.update(l, [&f](const affine& x) { return affine_monoid::op(x, f); });
+                        if (l < n)
+                            model[l] = affine_monoid::op(model[l], f);
+                        break;
+                    default:
+                        ADSL_CHECK(seg.accumulate(l, r) == (l < r ? std::optional(fold(model, l, r)) : std::nullopt));
+                        break;
+                }
+            }
+        }
+    }
+
+    std::cout << "model: ok\n";
+}
+
+struct pair_sum {
+    u64 x, y;
+};
+
+using pair_monoid = adsl::make_monoid<pair_sum, pair_sum{0, 0}, [](pair_sum a, pair_sum b) { return pair_sum{a.x + b.x, a.y + b.y}; }, true>;
+
+void check_torn() {
+    constexpr std::size_t n = 1 << 12, writers = 4, readers = 2, updates = 20000;
+
+    adsl::concurrent_segtree<pair_monoid> seg(n, writers);
+    std::atomic<bool> done = false;
+
+    std::vector<std::jthread> threads;
+    for (std::size_t w = 0; w < writers; ++w) {
+        threads.emplace_back([&seg, w] {
+            std::mt19937_64 rng(w);
+            for (std::size_t k = 0; k < updates; ++k) {
+                const std::size_t idx = w + writers * (rng() % (n / writers));
+                seg.update(idx, [](pair_sum v) { return pair_sum{v.x + 1, v.y + 3}; });
+            }
+        });
+    }
+    for (std::size_t t = 0; t < readers; ++t) {
+        threads.emplace_back([&seg, &done, t] {
+            std::mt19937_64 rng(1000 + t);
+
+            while (!done.load(std::memory_order_relaxed)) {
+                std::size_t l = rng() % n, r = rng() % n;
+                if (l > r)
+                    std::swap(l, r);
+
+                u64 prev = 0;
+                for (int rep = 0; rep < 4; ++rep) {
+                    const pair_sum s = *seg.accumulate(l, r + 1);
+                    ADSL_CHECK(s.y == 3 * s.x);
+                    ADSL_CHECK(s.x >= prev);
+                    prev = s.x;
+                }
+            }
+        });
+    }
+
+    for (std::size_t w = 0; w < writers; ++w)
+        threads[w].join();
+    done = true;
+    threads.clear();
+
+    const pair_sum total = *seg.accumulate(0, n);
+    ADSL_CHECK(total.x == writers * updates && total.y == 3 * writers * updates);
+
+    std::cout << "torn: ok\n";
+}
+
+struct counters {
+    u64 first, middle, last;
+};
+
+using counters_monoid = adsl::make_monoid<counters, counters{0, 0, 0},
+    [](counters a, counters b) { return counters{a.first + b.first, a.middle + b.middle, a.last + b.last}; }, true>;
+
+void check_snapshot() {
+    constexpr std::size_t n = 1 << 10, shard_count = 8, rounds = 20000, readers = 2;
+
+    adsl::concurrent_segtree<counters_monoid> seg(n, shard_count);
+    ADSL_CHECK(seg.shard_count() == shard_count);
+    std::atomic<bool> done = false;
+
+    std::vector<std::jthread> threads;
+    threads.emplace_back([&seg] {
+        for (std::size_t k = 0; k < rounds; ++k) {
+            seg.update(0, [](counters v) { return counters{v.first + 1, v.middle, v.last}; });
+            seg.update(n / 2, [](counters v) { return counters{v.first, v.middle + 1, v.last}; });
+            seg.update(n - 1, [](counters v) { return counters{v.first, v.middle, v.last + 1}; });
+        }
+    });
+    for (std::size_t t = 0; t < readers; ++t) {
+        threads.emplace_back([&seg, &done] {
+            while (!done.load(std::memory_order_relaxed)) {
+                // at any single moment, first >= middle >= last >= first - 1
+                const counters c = *seg.accumulate(0, n);
+                ADSL_CHECK(c.first >= c.middle && c.middle >= c.last && c.last + 1 >= c.first);
+            }
+        });
+    }
+
+    threads[0].join();
+    done = true;
+    threads.clear();
+
+    const counters total = *seg.accumulate(0, n);
+    ADSL_CHECK(total.first == rounds && total.middle == rounds && total.last == rounds);
+
+    std::cout << "snapshot: ok\n";
+}
+
+int main() {
+    std::mt19937_64 rng(0);
+
+    check_model(rng);
+    check_torn();
+    check_snapshot();
+}
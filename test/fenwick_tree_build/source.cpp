@@ -0,0 +1,75 @@
+// checks that the threaded build of fenwick_tree matches the serial one node for node, for N = 0..300 and a few
+// larger N, on 1, 2, 3, 4 and 8 threads, including N smaller than the thread count; the nodes are compared through
+// the files save_snapshot writes, which hold the node array as it is, and the prefix folds against a plain array
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <limits>
+#include <algorithm>
+#include <optional>
+#include <random>
+#include <fstream>
+#include <iterator>
+#include <filesystem>
+#include <unistd.h>
+
+#include "adsl/segtree/fenwick_tree.hpp"
+#include "adsl/segtree/snapshot.hpp"
+#include "../common.hpp"
+
+using namespace adsl_test;
+
+namespace fs = std::filesystem;
+
+constexpr std::size_t max_n = 300;
+
+using sum_group = adsl::default_group<i64>;
+using max_monoid = adsl::make_monoid<i64, std::numeric_limits<i64>::min(), [](i64 x, i64 y) { return std::max(x, y); }, true>;
+
+std::string read_file(const fs::path& path) {
+    std::ifstream in(path, std::ios::binary);
+    return { std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>() };
+}
+
+template <typename M>
+void check_size(const fs::path& dir, std::size_t n, std::mt19937_64& rng) {
+    std::vector<i64> model(n);
+    for (auto&& e : model)
+        e = static_cast<i64>(rng() % 2001) - 1000;
+
+    const fs::path serial_path = dir / "serial.snap", threaded_path = dir / "threaded.snap";
+    ADSL_CHECK(adsl::save_snapshot(adsl::fenwick_tree<M>(model), serial_path));
+    const std::string serial = read_file(serial_path);
+
+    for (std::size_t thread_count : { 1, 2, 3, 4, 8 }) {
+        const adsl::fenwick_tree<M> fw(model, thread_count);
+        ADSL_CHECK(fw.size() == n);
+
+        ADSL_CHECK(adsl::save_snapshot(fw, threaded_path));
+        ADSL_CHECK(read_file(threaded_path) == serial);
+
+        for (std::size_t i = 0; i < n; ++i)
+            ADSL_CHECK(fw.accumulate(i) == fold<M>(model, 0, i + 1));
+    }
+}
+
+int main() {
+    std::mt19937_64 rng(0);
+
+    const fs::path dir = fs::temp_directory_path() / ("adsl_test_fenwick_tree_build_" + std::to_string(::getpid()));
+    fs::create_directories(dir);
+
+    for (std::size_t n = 0; n <= max_n; ++n) {
+        check_size<sum_group>(dir, n, rng);
+        check_size<max_monoid>(dir, n, rng);
+    }
+    for (std::size_t n : { 1023, 1024, 1025, 4096 + 17 }) {
+        check_size<sum_group>(dir, n, rng);
+        check_size<max_monoid>(dir, n, rng);
+    }
+
+    std::cout << "fenwick_tree: ok\n";
+
+    fs::remove_all(dir);
+}
@@ -0,0 +1,86 @@
+// checks that every layout stores each node of the tree in its own slot within storage_size(), and that the
+// node storage stays within the bound the layout documents; then reports the footprint at N = 2^20 + 1,
+// the worst case of the perfect layouts, as bench/segtree_memory does for any N
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <bit>
+#include <cstddef>
+
+#include "adsl/segtree/layout.hpp"
+#include "../common.hpp"
+
+using namespace adsl_test;
+
+// whether heap index i is a node of the tree over n leaves, or the child of one, which a perfect layout must also hold
+template <typename Layout>
+bool is_stored(const Layout& layout, std::size_t n, std::size_t i) {
+    if constexpr (Layout::perfect) {
+        const std::size_t depth = static_cast<std::size_t>(std::bit_width(i)) - 1;
+        const std::size_t first_leaf = (i << (layout.height() - depth)) - layout.leaf_offset();
+        const std::size_t parent_first_leaf = ((i >> 1) << (layout.height() - depth + 1)) - layout.leaf_offset();
+
+        return first_leaf < n || (i > 1 && parent_first_leaf < n);
+    }
+    else
+        return i < 2 * n;
+}
+
+template <typename Layout>
+void check_slots(std::size_t n) {
+    const Layout layout(n);
+
+    std::vector<bool> used(layout.storage_size());
+    for (std::size_t i = 1; i < 2 * layout.leaf_offset(); ++i) {
+        if (!is_stored(layout, n, i))
+            continue;
+
+        const std::size_t p = layout.pos(i);
+        ADSL_CHECK(p < layout.storage_size());
+        ADSL_CHECK(!used[p]);
+        used[p] = true;
+    }
+
+    if constexpr (Layout::contiguous_leaves) {
+        for (std::size_t i = 1; i < n; ++i)
+            ADSL_CHECK(layout.pos(layout.leaf_offset() + i) == layout.pos(layout.leaf_offset()) + i);
+    }
+}
+
+template <typename Layout>
+double slots_per_value(std::size_t n) {
+    return static_cast<double>(Layout(n).storage_size()) / static_cast<double>(n);
+}
+
+template <typename Layout>
+void report(const char* name, std::size_t n) {
+    const std::size_t storage = Layout(n).storage_size();
+
+    std::cout << n << "\t" << name << "\tslots " << storage << "\tslots/N " << std::fixed << std::setprecision(3) << slots_per_value<Layout>(n)
+              << "\tsegtree of 8-byte values " << std::setprecision(1) << static_cast<double>(storage * 8) / (1 << 20) << "MiB\n";
+}
+
+int main() {
+    for (std::size_t n = 1; n <= 4096; ++n) {
+        check_slots<adsl::binary_heap_layout>(n);
+        check_slots<adsl::truncated_heap_layout>(n);
+        check_slots<adsl::compact_heap_layout>(n);
+        check_slots<adsl::blocked_heap_layout<3>>(n);
+
+        ADSL_CHECK(adsl::binary_heap_layout(n).storage_size() == 2 * std::bit_ceil(n));
+        ADSL_CHECK(adsl::truncated_heap_layout(n).storage_size() <= std::bit_ceil(n) + n + 1);
+        ADSL_CHECK(adsl::truncated_heap_layout(n).storage_size() <= 3 * n);
+        ADSL_CHECK(adsl::compact_heap_layout(n).storage_size() == 2 * n);
+    }
+
+    const std::size_t n = (std::size_t{1} << 20) + 1;
+    ADSL_CHECK(slots_per_value<adsl::binary_heap_layout>(n) > 3.99);
+    ADSL_CHECK(slots_per_value<adsl::truncated_heap_layout>(n) < 3.0);
+    ADSL_CHECK(slots_per_value<adsl::compact_heap_layout>(n) == 2.0);
+
+    report<adsl::binary_heap_layout>("binary_heap   ", n);
+    report<adsl::blocked_heap_layout<3>>("blocked<3>    ", n);
+    report<adsl::truncated_heap_layout>("truncated_heap", n);
+    report<adsl::compact_heap_layout>("compact_heap  ", n);
+}
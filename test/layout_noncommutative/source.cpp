@@ -0,0 +1,200 @@
+// checks segtree, lazy_segtree and dual_segtree on every layout against a plain array for N = 1..140,
+// with a monoid of affine maps that is not commutative, so an operand taken out of order changes the result
+
+#include <iostream>
+#include <vector>
+#include <tuple>
+#include <utility>
+#include <optional>
+#include <random>
+#include <iterator>
+
+#include "adsl/segtree/segtree.hpp"
+#include "adsl/segtree/lazy_segtree.hpp"
+#include "adsl/segtree/dual_segtree.hpp"
+#include "adsl/segtree/layout.hpp"
+#include "../common.hpp"
+
+using namespace adsl_test;
+
+constexpr std::size_t max_n = 140;
+constexpr std::size_t queries_per_n = 200;
+
+template <typename Layout>
+void check_segtree(std::mt19937_64& rng) {
+    using tree = adsl::segtree<affine_monoid, std::vector<affine>, Layout>;
+
+    for (std::size_t n = 1; n <= max_n; ++n) {
+        std::vector<affine> model(n);
+        for (auto&& e : model)
+            e = random_affine(rng);
+
+        tree seg(model);
+        ADSL_CHECK(std::ranges::equal(tree(model, 4).leaves(), model));
+
+        for (std::size_t q = 0; q < queries_per_n; ++q) {
+            switch (rng() % 4) {
+                case 0: {
+                    const std::size_t i = rng() % n;
+                    const affine f = random_affine(rng);
+                    seg.update(i, [&f](const affine& x) { return affine_monoid::op(x, f); });
+                    model[i] = affine_monoid::op(model[i], f);
+                    break;
+                }
+                case 1: {
+                    std::vector<std::pair<std::size_t, affine>> updates(rng() % 8 + 1);
+                    for (auto&& [i, f] : updates) {
+                        i = rng() % (n + 1);
+                        f = random_affine(rng);
+                    }
+
+                    seg.set_batch(updates);
+                    for (const auto& [i, f] : updates) {
+                        if (i < n)
+                            model[i] = f;
+                    }
+                    break;
+                }
+                case 2: {
+                    std::vector<std::pair<std::size_t, std::size_t>> queries(rng() % 8 + 1);
+                    for (auto&& e : queries)
+                        e = random_range(rng, n);
+
+                    std::vector<std::optional<affine>> res;
+                    seg.accumulate_batch(queries, std::back_inserter(res));
+                    for (std::size_t k = 0; k < queries.size(); ++k)
+                        ADSL_CHECK(res[k] == fold(model, queries[k].first, queries[k].second));
+                    break;
+                }
+                default: {
+                    const auto [l, r] = random_range(rng, n);
+                    ADSL_CHECK(seg.accumulate(l, r) == fold(model, l, r));
+                    ADSL_CHECK(!seg.accumulate(r, l));
+                    break;
+                }
+            }
+        }
+
+        ADSL_CHECK(std::ranges::equal(seg.leaves(), model));
+    }
+}
+
+template <typename Layout>
+void check_lazy_segtree(std::mt19937_64& rng) {
+    using tree = adsl::lazy_segtree<scale_affine_action, std::vector, Layout>;
+
+    for (std::size_t n = 1; n <= max_n; ++n) {
+        std::vector<affine> model(n);
+        for (auto&& e : model)
+            e = random_affine(rng);
+
+        tree seg(model);
+
+        auto apply = [&model](std::size_t l, std::size_t r, u64 s) {
+            for (std::size_t i = l; i < r; ++i)
+                model[i] = scale_affine_action::act(s, model[i]);
+        };
+
+        for (std::size_t q = 0; q < queries_per_n; ++q) {
+            switch (rng() % 4) {
+                case 0: {
+                    const auto [l, r] = random_range(rng, n);
+                    const u64 s = rng() % (mod - 1) + 1;
+                    seg.append(l, r, s);
+                    apply(l, r, s);
+                    break;
+                }
+                case 1: {
+                    std::vector<std::tuple<std::size_t, std::size_t, u64>> ranges(rng() % 8 + 1);
+                    for (auto&& [l, r, s] : ranges) {
+                        std::tie(l, r) = random_range(rng, n);
+                        s = rng() % (mod - 1) + 1;
+                    }
+
+                    seg.append_batch(ranges);
+                    for (const auto& [l, r, s] : ranges)
+                        apply(l, r, s);
+                    break;
+                }
+                case 2: {
+                    const std::size_t i = rng() % n;
+                    const affine f = random_affine(rng);
+                    seg.set(i, f);
+                    model[i] = f;
+                    break;
+                }
+                default: {
+                    const auto [l, r] = random_range(rng, n);
+                    ADSL_CHECK(seg.accumulate(l, r) == fold(model, l, r));
+                    break;
+                }
+            }
+        }
+
+        std::vector<affine> values;
+        seg.materialize(std::back_inserter(values));
+        ADSL_CHECK(values == model);
+    }
+}
+
+template <typename Layout>
+void check_dual_segtree(std::mt19937_64& rng) {
+    using tree = adsl::dual_segtree<affine_monoid, std::vector<affine>, Layout>;
+
+    for (std::size_t n = 1; n <= max_n; ++n) {
+        std::vector<affine> model(n);
+        tree seg(n);
+
+        for (std::size_t q = 0; q < queries_per_n; ++q) {
+            switch (rng() % 3) {
+                case 0: {
+                    const auto [l, r] = random_range(rng, n);
+                    const affine f = random_affine(rng);
+                    seg.append(l, r, f);
+                    for (std::size_t i = l; i < r; ++i)
+                        model[i] = affine_monoid::op(model[i], f);
+                    break;
+                }
+                case 1: {
+                    std::vector<std::size_t> indices(rng() % (2 * n) + 1);
+                    for (auto&& i : indices)
+                        i = rng() % (n + 1);
+
+                    const auto res = seg.calc_batch(indices);
+                    for (std::size_t k = 0; k < indices.size(); ++k)
+                        ADSL_CHECK(res[k] == (indices[k] < n ? std::optional(model[indices[k]]) : std::nullopt));
+                    break;
+                }
+                default: {
+                    const std::size_t i = rng() % n;
+                    ADSL_CHECK(seg.calc(i) == model[i]);
+                    break;
+                }
+            }
+        }
+
+        ADSL_CHECK(seg.calc_all() == model);
+
+        std::vector<affine> values;
+        seg.materialize(std::back_inserter(values));
+        ADSL_CHECK(values == model);
+    }
+}
+
+template <typename Layout>
+void check_layout(const char* name, std::mt19937_64& rng) {
+    check_segtree<Layout>(rng);
+    check_lazy_segtree<Layout>(rng);
+    check_dual_segtree<Layout>(rng);
+
+    std::cout << name << ": ok\n";
+}
+
+int main() {
+    std::mt19937_64 rng(0);
+
+    check_layout<adsl::binary_heap_layout>("binary_heap_layout", rng);
+    check_layout<adsl::truncated_heap_layout>("truncated_heap_layout", rng);
+    check_layout<adsl::compact_heap_layout>("compact_heap_layout", rng);
+    check_layout<adsl::blocked_heap_layout<3>>("blocked_heap_layout<3>", rng);
+}
@@ -0,0 +1,151 @@
+// checks the bulk builds of lazy_segtree against a plain array for N = 0..140: every leaf and every range fold
+// after building from an lvalue, from an rvalue that is moved from, from an input range that is not a forward range,
+// and on 1, 2, 3 and 8 threads, on a perfect layout and on one that is not
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <sstream>
+#include <ranges>
+#include <optional>
+#include <utility>
+#include <random>
+
+#include "adsl/segtree/lazy_segtree.hpp"
+#include "adsl/segtree/layout.hpp"
+#include "../common.hpp"
+
+using namespace adsl_test;
+
+constexpr std::size_t max_n = 140;
+
+namespace adsl_test {
+
+    std::istream& operator>>(std::istream& in, affine& f) {
+        return in >> f.a >> f.b;
+    }
+
+}
+
+// strings under concatenation, which the scale_monoid leaves alone; a moved-from std::string is left empty,
+// so the rvalue builds can be told from the copying ones
+struct concat_monoid {
+    using value_type = std::string;
+
+    static value_type unit() {
+        return {};
+    }
+
+    static value_type op(const value_type& x, const value_type& y) {
+        return x + y;
+    }
+};
+
+struct identity_action {
+    using domain = scale_monoid;
+    using space = concat_monoid;
+
+    static auto act(const domain::value_type&) noexcept {
+        return [](const space::value_type& x) { return x; };
+    }
+    static space::value_type act(const domain::value_type&, const space::value_type& x) {
+        return x;
+    }
+};
+
+template <typename Tree, typename M>
+void check_tree(Tree& seg, const std::vector<typename M::value_type>& model) {
+    const std::size_t n = model.size();
+    ADSL_CHECK(seg.size() == n);
+
+    for (std::size_t l = 0; l < n; ++l) {
+        typename M::value_type expected = M::unit();
+        for (std::size_t r = l + 1; r <= n; ++r) {
+            expected = M::op(expected, model[r - 1]);
+            ADSL_CHECK(seg.accumulate(l, r) == expected);
+        }
+    }
+}
+
+template <typename Layout>
+void check_affine(std::mt19937_64& rng) {
+    using tree = adsl::lazy_segtree<scale_affine_action, std::vector, Layout>;
+
+    for (std::size_t n = 0; n <= max_n; ++n) {
+        std::vector<affine> model(n);
+        for (auto&& e : model)
+            e = random_affine(rng);
+
+        tree from_lvalue(model);
+        check_tree<tree, affine_monoid>(from_lvalue, model);
+
+        tree from_rvalue{ std::vector<affine>(model) };
+        check_tree<tree, affine_monoid>(from_rvalue, model);
+
+        // a view is copied from, like an lvalue
+        tree from_view(std::views::all(model));
+        check_tree<tree, affine_monoid>(from_view, model);
+
+        std::stringstream text;
+        for (const affine& f : model)
+            text << f.a << ' ' << f.b << ' ';
+        tree from_input(std::views::istream<affine>(text));
+        check_tree<tree, affine_monoid>(from_input, model);
+
+        for (std::size_t thread_count : { 1, 2, 3, 8 }) {
+            tree threaded(model, thread_count);
+            check_tree<tree, affine_monoid>(threaded, model);
+
+            // the tags start out as units: a range append after the build must reach exactly its range
+            const u64 s = rng() % (mod - 1) + 1;
+            if (n > 0) {
+                const auto [l, r] = random_range(rng, n);
+                threaded.append(l, r, s);
+
+                for (std::size_t i = 0; i < n; ++i)
+                    ADSL_CHECK(threaded.accumulate(i, i + 1) == (l <= i && i < r ? scale_affine_action::act(s, model[i]) : model[i]));
+            }
+        }
+    }
+}
+
+template <typename Layout>
+void check_moves(std::mt19937_64& rng) {
+    using tree = adsl::lazy_segtree<identity_action, std::vector, Layout>;
+
+    for (std::size_t n = 0; n <= max_n; n += 7) {
+        std::vector<std::string> model(n);
+        for (auto&& e : model)
+            e = std::string(32, static_cast<char>('a' + rng() % 26));
+
+        std::vector<std::string> src = model;
+        tree copied(src);
+        ADSL_CHECK(src == model);
+        check_tree<tree, concat_monoid>(copied, model);
+
+        tree moved(std::move(src));
+        for (const std::string& s : src)
+            ADSL_CHECK(s.empty());
+        check_tree<tree, concat_monoid>(moved, model);
+
+        for (std::size_t thread_count : { 1, 2, 3, 8 }) {
+            src = model;
+            tree threaded(std::move(src), thread_count);
+            for (const std::string& s : src)
+                ADSL_CHECK(s.empty());
+            check_tree<tree, concat_monoid>(threaded, model);
+        }
+    }
+}
+
+int main() {
+    std::mt19937_64 rng(0);
+
+    check_affine<adsl::binary_heap_layout>(rng);
+    check_affine<adsl::truncated_heap_layout>(rng);
+    std::cout << "affine: ok\n";
+
+    check_moves<adsl::binary_heap_layout>(rng);
+    check_moves<adsl::truncated_heap_layout>(rng);
+    std::cout << "moves: ok\n";
+}
@@ -0,0 +1,103 @@
+// checks persistent_segtree against a copy of the array kept for every version, for N = 1..60,
+// releasing random versions along the way and finally all of them, after which no node may stay in use
+
+#include <iostream>
+#include <vector>
+#include <optional>
+#include <utility>
+#include <random>
+
+#include "adsl/segtree/persistent_segtree.hpp"
+#include "../common.hpp"
+
+using namespace adsl_test;
+
+constexpr std::size_t max_n = 60;
+constexpr std::size_t queries_per_n = 400;
+
+int main() {
+    std::mt19937_64 rng(0);
+
+    for (std::size_t n = 1; n <= max_n; ++n) {
+        std::vector<affine> initial(n);
+        for (auto&& e : initial)
+            e = random_affine(rng);
+
+        adsl::persistent_segtree<affine_monoid> seg(initial);
+
+        // std::nullopt once released
+        std::vector<std::optional<std::vector<affine>>> history = { initial };
+
+        for (std::size_t q = 0; q < queries_per_n; ++q) {
+            const std::size_t version = rng() % history.size();
+            ADSL_CHECK(seg.is_live(version) == history[version].has_value());
+
+            switch (rng() % 4) {
+                case 0: {
+                    const std::size_t i = rng() % (n + 1);
+                    const affine f = random_affine(rng);
+                    const auto next = seg.update(version, i, [&f](const affine& x) { return affine_monoid::op(x, f); });
+
+                    if (!history[version] || i >= n) {
+                        ADSL_CHECK(!next);
+                        break;
+                    }
+
+                    ADSL_CHECK(next == history.size());
+                    history.push_back(history[version]);
+                    (*history.back())[i] = affine_monoid::op((*history.back())[i], f);
+                    break;
+                }
+                case 1: {
+                    const std::size_t i = rng() % n;
+                    const affine f = random_affine(rng);
+                    const auto next = seg.set(version, i, f);
+
+                    if (!history[version]) {
+                        ADSL_CHECK(!next);
+                        break;
+                    }
+
+                    ADSL_CHECK(next == history.size());
+                    history.push_back(history[version]);
+                    (*history.back())[i] = f;
+                    break;
+                }
+                case 2: {
+                    seg.release(version);
+                    history[version] = std::nullopt;
+                    break;
+                }
+                default: {
+                    std::size_t l = rng() % n, r = rng() % n;
+                    if (l > r)
+                        std::swap(l, r);
+                    ++r;
+
+                    const auto res = seg.accumulate(version, l, r);
+                    if (history[version])
+                        ADSL_CHECK(res == fold(*history[version], l, r));
+                    else
+                        ADSL_CHECK(!res);
+                    break;
+                }
+            }
+        }
+
+        ADSL_CHECK(seg.version_count() == history.size());
+
+        for (std::size_t version = 0; version < history.size(); ++version) {
+            if (history[version])
+                ADSL_CHECK(seg.accumulate(version, 0, n) == fold(*history[version], 0, n));
+
+            seg.release(version);
+        }
+
+        ADSL_CHECK(seg.node_count() == 0);
+    }
+
+    adsl::persistent_segtree<affine_monoid> empty(0);
+    ADSL_CHECK(empty.is_live(0) && !empty.accumulate(0, 0, 1) && !empty.set(0, 0, affine{}));
+
+    std::cout << "persistent_segtree: ok\n";
+}
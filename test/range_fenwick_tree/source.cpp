@@ -0,0 +1,95 @@
+// checks range_fenwick_tree against a plain array for N = 0..100, over i64 addition and over addition modulo a prime,
+// whose scale is a custom multiplication rather than v * n
+
+#include <iostream>
+#include <vector>
+#include <optional>
+#include <utility>
+#include <random>
+
+#include "adsl/segtree/range_fenwick_tree.hpp"
+#include "../common.hpp"
+
+using namespace adsl_test;
+
+constexpr std::size_t max_n = 100;
+constexpr std::size_t queries_per_n = 400;
+
+struct mod_group : adsl::commutative_tag {
+    using value_type = u64;
+
+    static value_type unit() noexcept {
+        return 0;
+    }
+
+    static value_type op(const value_type& x, const value_type& y) noexcept {
+        return (x + y) % mod;
+    }
+
+    static value_type inv(const value_type& x) noexcept {
+        return (mod - x) % mod;
+    }
+
+    static value_type scale(const value_type& x, std::size_t n) noexcept {
+        return x * (n % mod) % mod;
+    }
+};
+
+template <typename G, typename Random>
+void check(const char* name, std::mt19937_64& rng, Random random_value) {
+    using value_type = G::value_type;
+
+    for (std::size_t n = 0; n <= max_n; ++n) {
+        std::vector<value_type> model(n);
+        for (auto&& e : model)
+            e = random_value(rng);
+
+        adsl::range_fenwick_tree<G> fw(model);
+        ADSL_CHECK(fw.size() == n);
+
+        for (std::size_t q = 0; q < queries_per_n; ++q) {
+            std::size_t l = rng() % (n + 1), r = rng() % (n + 1);
+            if (rng() % 8 != 0 && l > r)
+                std::swap(l, r);
+
+            const bool valid = l < r;
+            const value_type v = random_value(rng);
+
+            switch (rng() % 6) {
+                case 0:
+                    fw.append(l, r, v);
+                    for (std::size_t i = l; i < r; ++i)
+                        model[i] = G::op(model[i], v);
+                    break;
+                case 1:
+                    ADSL_CHECK(fw.accumulate(l, r) == (valid ? std::optional(fold<G>(model, l, r)) : std::nullopt));
+                    break;
+                case 2:
+                    ADSL_CHECK(fw.accumulate(l) == (l < n ? std::optional(fold<G>(model, 0, l + 1)) : std::nullopt));
+                    break;
+                case 3:
+                    ADSL_CHECK(fw.calc(l) == (l < n ? std::optional(model[l]) : std::nullopt));
+                    break;
+                case 4:
+                    fw.set(l, v);
+                    if (l < n)
+                        model[l] = v;
+                    break;
+                default:
+                    fw.update(l, [&v](const value_type& x) { return G::op(x, G::op(x, v)); });
+                    if (l < n)
+                        model[l] = G::op(model[l], G::op(model[l], v));
+                    break;
+            }
+        }
+    }
+
+    std::cout << name << ": ok\n";
+}
+
+int main() {
+    std::mt19937_64 rng(0);
+
+    check<adsl::default_group<i64>>("i64", rng, [](std::mt19937_64& r) { return static_cast<i64>(r() % 2001) - 1000; });
+    check<mod_group>("mod", rng, [](std::mt19937_64& r) { return r() % mod; });
+}
@@ -0,0 +1,362 @@
+// checks the replay library: a log survives save_replay_log and replay_log::open, files that are truncated or corrupted
+// are rejected, replaying a log on each tree leaves it as applying the operations directly does and skips exactly the
+// operations the tree cannot express, and latency_histogram reports the bound of the right bucket at every bucket edge
+// up to UINT64_MAX
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <limits>
+#include <algorithm>
+#include <optional>
+#include <utility>
+#include <random>
+#include <fstream>
+#include <iterator>
+#include <filesystem>
+#include <bit>
+#include <cstring>
+#include <unistd.h>
+
+#include "adsl/segtree/replay.hpp"
+#include "../common.hpp"
+
+using namespace adsl_test;
+
+namespace fs = std::filesystem;
+
+constexpr std::size_t replay_n = 37;
+constexpr std::size_t replay_q = 5000;
+
+constexpr i64 Inf = std::numeric_limits<i64>::max();
+
+using sum_monoid = adsl::default_monoid<i64>;
+using sum_group = adsl::default_group<i64>;
+using max_monoid = adsl::make_monoid<i64, std::numeric_limits<i64>::min(), [](i64 x, i64 y) { return std::max(x, y); }, true>;
+using min_monoid = adsl::make_monoid<i64, Inf, [](i64 x, i64 y) { return std::min(x, y); }, true>;
+using add_min_action = adsl::make_action<sum_monoid, min_monoid, [](i64 a, i64 x) { return (x == Inf ? x : x + a); }>;
+
+std::string read_file(const fs::path& path) {
+    std::ifstream in(path, std::ios::binary);
+    return { std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>() };
+}
+
+void write_file(const fs::path& path, const std::string& bytes) {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+}
+
+// random operations over n values, a few of them out of range, with ranges of one value often enough
+// for the trees that take only those
+std::vector<adsl::replay_op> random_ops(std::mt19937_64& rng, std::size_t n, std::size_t q) {
+    std::vector<adsl::replay_op> ops(q);
+    for (auto&& op : ops) {
+        op.kind = static_cast<adsl::replay_kind>(rng() % 4 + 1);
+        op.l = rng() % (n + 1);
+        op.r = rng() % (n + 1);
+        if (op.l > op.r)
+            std::swap(op.l, op.r);
+        if (rng() % 3 == 0 || op.l == op.r)
+            op.r = op.l + 1;
+        if (rng() % 4 == 0)
+            op.l = 0;
+        op.value = static_cast<i64>(rng() % 2001) - 1000;
+    }
+
+    return ops;
+}
+
+void check_log(const fs::path& dir, std::mt19937_64& rng) {
+    const fs::path good = dir / "good.log", bad = dir / "bad.log";
+
+    for (std::size_t q : { 0, 1, 100 }) {
+        const auto ops = random_ops(rng, replay_n, q);
+        ADSL_CHECK(adsl::save_replay_log(good, replay_n, ops));
+
+        const auto log = adsl::replay_log::open(good);
+        ADSL_CHECK(log.has_value() && log->size() == replay_n && log->ops().size() == q);
+        ADSL_CHECK(q == 0 || std::memcmp(log->ops().data(), ops.data(), q * sizeof(adsl::replay_op)) == 0);
+    }
+
+    const std::string bytes = read_file(good);
+    ADSL_CHECK(!adsl::replay_log::open(dir / "missing.log"));
+
+    for (std::size_t size : { std::size_t{0}, std::size_t{1}, sizeof(adsl::replay_header) - 1, sizeof(adsl::replay_header), bytes.size() - 1 }) {
+        write_file(bad, bytes.substr(0, size));
+        ADSL_CHECK(!adsl::replay_log::open(bad));
+    }
+
+    auto rejects = [&](auto f) {
+        std::string corrupted = bytes;
+        adsl::replay_header h;
+        std::memcpy(&h, corrupted.data(), sizeof(h));
+        f(h);
+        std::memcpy(corrupted.data(), &h, sizeof(h));
+        write_file(bad, corrupted);
+
+        return !adsl::replay_log::open(bad);
+    };
+
+    ADSL_CHECK(!rejects([](adsl::replay_header&) {}));
+    ADSL_CHECK(rejects([](adsl::replay_header& h) { h.magic[7] ^= 1; }));
+    ADSL_CHECK(rejects([](adsl::replay_header& h) { ++h.version; }));
+    ADSL_CHECK(rejects([](adsl::replay_header& h) { h.op_size = 16; }));
+    ADSL_CHECK(rejects([](adsl::replay_header& h) { ++h.op_count; }));
+    ADSL_CHECK(rejects([](adsl::replay_header& h) { h.op_count = ~std::uint64_t{0}; }));
+
+    std::cout << "log: ok\n";
+}
+
+// apply ops to tree through its own interface, as replay_traits documents, and count what replay should skip
+template <typename Tree>
+struct direct {};
+
+template <>
+struct direct<adsl::segtree<sum_monoid>> {
+    static bool run(adsl::segtree<sum_monoid>& tree, const adsl::replay_op& op, u64& checksum) {
+        switch (op.kind) {
+            case adsl::replay_kind::set:
+                tree.set(op.l, op.value);
+                return true;
+            case adsl::replay_kind::update:
+                tree.update(op.l, [&op](i64 x) { return x + op.value; });
+                return true;
+            case adsl::replay_kind::append:
+                if (op.r != op.l + 1)
+                    return false;
+                tree.update(op.l, [&op](i64 x) { return x + op.value; });
+                return true;
+            default:
+                adsl::impl::mix_replay_checksum(checksum, tree.accumulate(op.l, op.r));
+                return true;
+        }
+    }
+
+    static std::vector<std::optional<i64>> state(const adsl::segtree<sum_monoid>& tree) {
+        std::vector<std::optional<i64>> res;
+        for (std::size_t i = 0; i <= tree.size(); ++i)
+            res.push_back(tree.accumulate(i, i + 1));
+
+        return res;
+    }
+};
+
+template <>
+struct direct<adsl::dual_segtree<sum_monoid>> {
+    static bool run(adsl::dual_segtree<sum_monoid>& tree, const adsl::replay_op& op, u64& checksum) {
+        switch (op.kind) {
+            case adsl::replay_kind::set:
+                return false;
+            case adsl::replay_kind::update:
+                tree.append(op.l, op.l + 1, op.value);
+                return true;
+            case adsl::replay_kind::append:
+                tree.append(op.l, op.r, op.value);
+                return true;
+            default:
+                if (op.r != op.l + 1)
+                    return false;
+                adsl::impl::mix_replay_checksum(checksum, tree.calc(op.l));
+                return true;
+        }
+    }
+
+    static std::vector<std::optional<i64>> state(const adsl::dual_segtree<sum_monoid>& tree) {
+        std::vector<std::optional<i64>> res;
+        for (std::size_t i = 0; i <= tree.size(); ++i)
+            res.push_back(tree.calc(i));
+
+        return res;
+    }
+};
+
+template <>
+struct direct<adsl::lazy_segtree<add_min_action>> {
+    static bool run(adsl::lazy_segtree<add_min_action>& tree, const adsl::replay_op& op, u64& checksum) {
+        switch (op.kind) {
+            case adsl::replay_kind::set:
+                tree.set(op.l, op.value);
+                return true;
+            case adsl::replay_kind::update:
+                tree.update(op.l, [&op](i64 x) { return std::min(x, static_cast<i64>(op.value)); });
+                return true;
+            case adsl::replay_kind::append:
+                tree.append(op.l, op.r, op.value);
+                return true;
+            default:
+                adsl::impl::mix_replay_checksum(checksum, tree.accumulate(op.l, op.r));
+                return true;
+        }
+    }
+
+    static std::vector<std::optional<i64>> state(adsl::lazy_segtree<add_min_action>& tree) {
+        std::vector<std::optional<i64>> res;
+        for (std::size_t i = 0; i <= tree.size(); ++i)
+            res.push_back(tree.accumulate(i, i + 1));
+
+        return res;
+    }
+};
+
+template <typename M>
+struct direct<adsl::fenwick_tree<M>> {
+    static bool run(adsl::fenwick_tree<M>& tree, const adsl::replay_op& op, u64& checksum) {
+        switch (op.kind) {
+            case adsl::replay_kind::set:
+                if constexpr (adsl::CommutativeGroup<M>) {
+                    tree.set(op.l, op.value);
+                    return true;
+                }
+                else
+                    return false;
+            case adsl::replay_kind::update:
+                tree.append_at(op.l, op.value);
+                return true;
+            case adsl::replay_kind::append:
+                if (op.r != op.l + 1)
+                    return false;
+                tree.append_at(op.l, op.value);
+                return true;
+            default:
+                if constexpr (adsl::CommutativeGroup<M>)
+                    adsl::impl::mix_replay_checksum(checksum, tree.accumulate(op.l, op.r));
+                else {
+                    if (op.l != 0 || op.r == 0)
+                        return false;
+                    adsl::impl::mix_replay_checksum(checksum, tree.accumulate(op.r - 1));
+                }
+                return true;
+        }
+    }
+
+    static std::vector<std::optional<i64>> state(const adsl::fenwick_tree<M>& tree) {
+        std::vector<std::optional<i64>> res;
+        for (std::size_t i = 0; i <= tree.size(); ++i)
+            res.push_back(tree.accumulate(i));
+
+        return res;
+    }
+};
+
+template <typename Tree>
+void check_replay(const char* name, const adsl::replay_log& log) {
+    Tree replayed(replay_n), applied(replay_n);
+
+    adsl::latency_histogram latencies;
+    const adsl::replay_result res = adsl::replay(replayed, log, &latencies);
+
+    adsl::replay_result expected;
+    for (const adsl::replay_op& op : log.ops())
+        ++(direct<Tree>::run(applied, op, expected.checksum) ? expected.executed : expected.skipped);
+
+    ADSL_CHECK(res.executed == expected.executed && res.skipped == expected.skipped);
+    ADSL_CHECK(res.executed + res.skipped == log.ops().size());
+    ADSL_CHECK(res.checksum == expected.checksum);
+    ADSL_CHECK(direct<Tree>::state(replayed) == direct<Tree>::state(applied));
+    ADSL_CHECK(latencies.count() == res.executed);
+
+    // without a histogram, on a fresh tree, the outcome is the same
+    Tree again(replay_n);
+    const adsl::replay_result untimed = adsl::replay(again, log.ops());
+    ADSL_CHECK(untimed.executed == res.executed && untimed.skipped == res.skipped && untimed.checksum == res.checksum);
+
+    std::cout << name << ": " << res.executed << " executed, " << res.skipped << " skipped: ok\n";
+}
+
+// the bound the histogram should report for a value: the value itself below 32, otherwise the value with
+// everything below its top 5 bits set
+u64 expected_bound(u64 v) {
+    if (v < 32)
+        return v;
+
+    const int shift = std::bit_width(v) - 5;
+    return (v | ((u64{1} << shift) - 1));
+}
+
+void check_histogram() {
+    constexpr u64 max = std::numeric_limits<u64>::max();
+
+    std::vector<u64> values;
+    for (u64 v = 0; v < 64; ++v)
+        values.push_back(v);
+    for (int k = 6; k < 64; ++k) {
+        const u64 p = u64{1} << k;
+        for (u64 d : { p - 1, p, p + 1, p + p / 16 - 1, p + p / 16, p + p / 2 })
+            values.push_back(d);
+    }
+    for (u64 d : { max - 1, max, max - (u64{1} << 59), max - (u64{1} << 59) + 1, max / 2, max / 2 + 1 })
+        values.push_back(d);
+
+    for (u64 v : values) {
+        const u64 bound = expected_bound(v);
+        ADSL_CHECK(bound >= v && bound - v <= v / 16);
+
+        // with a larger value recorded as well, the median reports the bound of v's bucket, not capped by the maximum
+        adsl::latency_histogram h;
+        h.record(v);
+        h.record(max);
+        ADSL_CHECK(h.percentile(0.5) == bound);
+        ADSL_CHECK(h.percentile(1.0) == max);
+        ADSL_CHECK(h.max() == max);
+
+        // the value just past the bound falls in the next bucket
+        if (bound != max) {
+            adsl::latency_histogram next;
+            next.record(bound + 1);
+            next.record(max);
+            ADSL_CHECK(next.percentile(0.5) == expected_bound(bound + 1) && expected_bound(bound + 1) > bound);
+        }
+
+        // alone, it is capped by the largest value recorded
+        adsl::latency_histogram single;
+        single.record(v);
+        ADSL_CHECK(single.percentile(0.0) == v && single.percentile(0.99) == v && single.percentile(1.0) == v);
+    }
+
+    // percentiles over 1..100 pick the rank-th value's bucket
+    adsl::latency_histogram h;
+    ADSL_CHECK(h.count() == 0 && h.percentile(0.5) == 0 && h.mean() == 0.0);
+    for (u64 v = 1; v <= 100; ++v)
+        h.record(v);
+
+    ADSL_CHECK(h.count() == 100 && h.max() == 100 && h.mean() == 50.5);
+    ADSL_CHECK(h.percentile(0.0) == 1);
+    ADSL_CHECK(h.percentile(0.1) == 10);
+    ADSL_CHECK(h.percentile(0.31) == expected_bound(31));
+    ADSL_CHECK(h.percentile(0.5) == expected_bound(50));
+    ADSL_CHECK(h.percentile(0.99) == expected_bound(99));
+    ADSL_CHECK(h.percentile(1.0) == 100);
+    ADSL_CHECK(h.percentile(2.0) == 100 && h.percentile(-1.0) == 1);
+
+    adsl::latency_histogram merged, other;
+    merged.record(10);
+    other.record(1000);
+    merged.merge(other);
+    ADSL_CHECK(merged.count() == 2 && merged.max() == 1000 && merged.percentile(0.5) == 10 && merged.percentile(1.0) == 1000);
+
+    std::cout << "latency_histogram: ok\n";
+}
+
+int main() {
+    std::mt19937_64 rng(0);
+
+    const fs::path dir = fs::temp_directory_path() / ("adsl_test_replay_" + std::to_string(::getpid()));
+    fs::create_directories(dir);
+
+    check_log(dir, rng);
+
+    const fs::path path = dir / "replay.log";
+    ADSL_CHECK(adsl::save_replay_log(path, replay_n, random_ops(rng, replay_n, replay_q)));
+    const auto log = adsl::replay_log::open(path);
+    ADSL_CHECK(log.has_value());
+
+    check_replay<adsl::segtree<sum_monoid>>("segtree", *log);
+    check_replay<adsl::dual_segtree<sum_monoid>>("dual_segtree", *log);
+    check_replay<adsl::lazy_segtree<add_min_action>>("lazy_segtree", *log);
+    check_replay<adsl::fenwick_tree<sum_group>>("fenwick_tree", *log);
+    check_replay<adsl::fenwick_tree<max_monoid>>("fenwick_tree max", *log);
+
+    check_histogram();
+
+    fs::remove_all(dir);
+}
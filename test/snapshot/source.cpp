@@ -0,0 +1,294 @@
+// checks save_snapshot, open_snapshot and sync_snapshot: segtree, lazy_segtree with pending tags, dual_segtree and
+// fenwick_tree reopen with the values they were saved with, updates through a writable open reach the file once synced,
+// updates through a read-only open never do, and files that are truncated, corrupted or written for another monoid,
+// layout or tree are rejected
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <optional>
+#include <utility>
+#include <random>
+#include <fstream>
+#include <iterator>
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <unistd.h>
+
+#include "adsl/segtree/snapshot.hpp"
+#include "../common.hpp"
+
+using namespace adsl_test;
+
+namespace fs = std::filesystem;
+
+constexpr std::size_t queries_per_tree = 300;
+
+using sum_monoid = adsl::default_monoid<i64>;
+using sum_group = adsl::default_group<i64>;
+using max_monoid = adsl::make_monoid<i64, i64{0}, [](i64 x, i64 y) { return std::max(x, y); }, true>;
+
+template <typename M, typename Layout = adsl::binary_heap_layout>
+using mapped_segtree = adsl::segtree<M, adsl::mmap_container<typename M::value_type>, Layout>;
+
+std::string read_file(const fs::path& path) {
+    std::ifstream in(path, std::ios::binary);
+    return { std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>() };
+}
+
+void write_file(const fs::path& path, const std::string& bytes) {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+}
+
+// a copy of src at dst whose header was passed through f
+template <typename F>
+void corrupt_header(const fs::path& src, const fs::path& dst, F f) {
+    std::string bytes = read_file(src);
+    adsl::snapshot_header h;
+    std::memcpy(&h, bytes.data(), sizeof(h));
+    f(h);
+    std::memcpy(bytes.data(), &h, sizeof(h));
+    write_file(dst, bytes);
+}
+
+template <typename Layout>
+void check_segtree(const fs::path& dir, std::mt19937_64& rng) {
+    for (std::size_t n : { 1, 2, 7, 64, 100, 1000 }) {
+        std::vector<affine> model(n);
+        for (auto&& e : model)
+            e = random_affine(rng);
+
+        const fs::path path = dir / "segtree.snap";
+        ADSL_CHECK(adsl::save_snapshot(adsl::segtree<affine_monoid, std::vector<affine>, Layout>(model), path));
+
+        auto seg = adsl::open_snapshot<mapped_segtree<affine_monoid, Layout>>(path);
+        ADSL_CHECK(seg.has_value() && seg->size() == n);
+        ADSL_CHECK(std::ranges::equal(seg->leaves(), model));
+
+        for (std::size_t q = 0; q < queries_per_tree; ++q) {
+            if (q % 2 == 0) {
+                const std::size_t i = rng() % n;
+                model[i] = random_affine(rng);
+                seg->set(i, model[i]);
+            }
+            else {
+                const auto [l, r] = random_range(rng, n);
+                ADSL_CHECK(seg->accumulate(l, r) == fold(model, l, r));
+            }
+        }
+
+        // the writable open wrote through to the file
+        ADSL_CHECK(adsl::sync_snapshot(*seg));
+        const auto reopened = adsl::open_snapshot<mapped_segtree<affine_monoid, Layout>>(path, false);
+        ADSL_CHECK(reopened.has_value() && std::ranges::equal(reopened->leaves(), model));
+    }
+}
+
+void check_lazy_segtree(const fs::path& dir, std::mt19937_64& rng) {
+    using tree = adsl::lazy_segtree<scale_affine_action>;
+    using mapped = adsl::lazy_segtree<scale_affine_action, adsl::mmap_container>;
+
+    for (std::size_t n : { 1, 2, 7, 64, 100, 1000 }) {
+        std::vector<affine> model(n);
+        for (auto&& e : model)
+            e = random_affine(rng);
+
+        // range appends with no read afterwards leave their tags pending in the saved file
+        tree seg(model);
+        for (std::size_t k = 0; k < 20; ++k) {
+            const auto [l, r] = random_range(rng, n);
+            const u64 s = rng() % (mod - 1) + 1;
+            seg.append(l, r, s);
+            for (std::size_t i = l; i < r; ++i)
+                model[i] = scale_affine_action::act(s, model[i]);
+        }
+
+        const fs::path path = dir / "lazy_segtree.snap";
+        ADSL_CHECK(adsl::save_snapshot(seg, path));
+
+        auto opened = adsl::open_snapshot<mapped>(path);
+        ADSL_CHECK(opened.has_value() && opened->size() == n);
+
+        for (std::size_t q = 0; q < queries_per_tree; ++q) {
+            const auto [l, r] = random_range(rng, n);
+
+            if (q % 3 == 0) {
+                const u64 s = rng() % (mod - 1) + 1;
+                opened->append(l, r, s);
+                for (std::size_t i = l; i < r; ++i)
+                    model[i] = scale_affine_action::act(s, model[i]);
+            }
+            else
+                ADSL_CHECK(opened->accumulate(l, r) == fold(model, l, r));
+        }
+
+        ADSL_CHECK(adsl::sync_snapshot(*opened));
+        auto reopened = adsl::open_snapshot<mapped>(path, false);
+        ADSL_CHECK(reopened.has_value());
+        for (std::size_t i = 0; i < n; ++i)
+            ADSL_CHECK(reopened->accumulate(i, i + 1) == model[i]);
+    }
+}
+
+void check_dual_segtree(const fs::path& dir, std::mt19937_64& rng) {
+    using mapped = adsl::dual_segtree<affine_monoid, adsl::mmap_container<affine>>;
+
+    for (std::size_t n : { 1, 2, 7, 64, 100, 1000 }) {
+        std::vector<affine> model(n);
+        adsl::dual_segtree<affine_monoid> seg(n);
+        for (std::size_t k = 0; k < 20; ++k) {
+            const auto [l, r] = random_range(rng, n);
+            const affine f = random_affine(rng);
+            seg.append(l, r, f);
+            for (std::size_t i = l; i < r; ++i)
+                model[i] = affine_monoid::op(model[i], f);
+        }
+
+        const fs::path path = dir / "dual_segtree.snap";
+        ADSL_CHECK(adsl::save_snapshot(seg, path));
+
+        const auto opened = adsl::open_snapshot<mapped>(path, false);
+        ADSL_CHECK(opened.has_value() && opened->size() == n);
+        ADSL_CHECK(opened->calc_all() == model);
+    }
+}
+
+void check_fenwick_tree(const fs::path& dir, std::mt19937_64& rng) {
+    using mapped = adsl::fenwick_tree<sum_group, adsl::mmap_container<i64>>;
+
+    for (std::size_t n : { 1, 2, 7, 64, 100, 1000 }) {
+        std::vector<i64> model(n);
+        for (auto&& e : model)
+            e = static_cast<i64>(rng() % 2001) - 1000;
+
+        const fs::path path = dir / "fenwick_tree.snap";
+        ADSL_CHECK(adsl::save_snapshot(adsl::fenwick_tree<sum_group>(model), path));
+
+        auto opened = adsl::open_snapshot<mapped>(path);
+        ADSL_CHECK(opened.has_value() && opened->size() == n);
+
+        for (std::size_t q = 0; q < queries_per_tree; ++q) {
+            const auto [l, r] = random_range(rng, n);
+
+            if (q % 2 == 0) {
+                const i64 v = static_cast<i64>(rng() % 100);
+                opened->append_at(l, v);
+                model[l] += v;
+            }
+            else
+                ADSL_CHECK(opened->accumulate(l, r) == fold<sum_group>(model, l, r));
+        }
+
+        ADSL_CHECK(adsl::sync_snapshot(*opened));
+        const auto reopened = adsl::open_snapshot<mapped>(path, false);
+        ADSL_CHECK(reopened.has_value());
+        for (std::size_t i = 0; i < n; ++i)
+            ADSL_CHECK(reopened->accumulate(i) == fold<sum_group>(model, 0, i + 1));
+    }
+}
+
+void check_read_only(const fs::path& dir) {
+    const fs::path path = dir / "read_only.snap";
+    ADSL_CHECK(adsl::save_snapshot(adsl::segtree<sum_monoid>(std::vector<i64>{ 1, 2, 3, 4, 5 }), path));
+    const std::string before = read_file(path);
+
+    {
+        // copy-on-write: the tree sees its own update, the file does not
+        auto seg = adsl::open_snapshot<mapped_segtree<sum_monoid>>(path, false);
+        ADSL_CHECK(seg.has_value());
+        seg->set(2, 100);
+        ADSL_CHECK(seg->accumulate(0, 5) == 112);
+        ADSL_CHECK(adsl::sync_snapshot(*seg));
+    }
+
+    ADSL_CHECK(read_file(path) == before);
+
+    const auto seg = adsl::open_snapshot<mapped_segtree<sum_monoid>>(path, false);
+    ADSL_CHECK(seg.has_value() && seg->accumulate(0, 5) == 15);
+}
+
+void check_rejected(const fs::path& dir) {
+    const fs::path good = dir / "good.snap", bad = dir / "bad.snap";
+
+    std::vector<i64> values(100);
+    for (std::size_t i = 0; i < values.size(); ++i)
+        values[i] = static_cast<i64>(i);
+
+    ADSL_CHECK(adsl::save_snapshot(adsl::segtree<sum_monoid>(values), good));
+    ADSL_CHECK(adsl::open_snapshot<mapped_segtree<sum_monoid>>(good, false).has_value());
+
+    // written for another monoid of the same value type, another layout or another tree
+    ADSL_CHECK(!adsl::open_snapshot<mapped_segtree<max_monoid>>(good, false));
+    ADSL_CHECK(!adsl::open_snapshot<mapped_segtree<sum_monoid, adsl::compact_heap_layout>>(good, false));
+    ADSL_CHECK(!(adsl::open_snapshot<adsl::dual_segtree<sum_monoid, adsl::mmap_container<i64>>>(good, false)));
+
+    // missing, empty or truncated
+    ADSL_CHECK(!adsl::open_snapshot<mapped_segtree<sum_monoid>>(dir / "missing.snap", false));
+    const std::string bytes = read_file(good);
+    for (std::size_t size : { std::size_t{0}, std::size_t{1}, sizeof(adsl::snapshot_header) - 1, sizeof(adsl::snapshot_header), bytes.size() - 1 }) {
+        write_file(bad, bytes.substr(0, size));
+        ADSL_CHECK(!adsl::open_snapshot<mapped_segtree<sum_monoid>>(bad, false));
+    }
+
+    auto rejects = [&](auto f) {
+        corrupt_header(good, bad, f);
+        return !adsl::open_snapshot<mapped_segtree<sum_monoid>>(bad, false);
+    };
+
+    // the unchanged header is accepted, so each rejection below is due to its own field
+    ADSL_CHECK(!rejects([](adsl::snapshot_header&) {}));
+
+    ADSL_CHECK(rejects([](adsl::snapshot_header& h) { h.magic[0] ^= 1; }));
+    ADSL_CHECK(rejects([](adsl::snapshot_header& h) { ++h.version; }));
+    ADSL_CHECK(rejects([](adsl::snapshot_header& h) { h.kind = adsl::snapshot_kind::fenwick_tree; }));
+    ADSL_CHECK(rejects([](adsl::snapshot_header& h) { h.value_size = 4; }));
+
+    // extents and alignment
+    ADSL_CHECK(rejects([](adsl::snapshot_header& h) { h.size *= 2; }));
+    ADSL_CHECK(rejects([](adsl::snapshot_header& h) { h.size = ~std::uint64_t{0}; }));
+    ADSL_CHECK(rejects([](adsl::snapshot_header& h) { ++h.node_count; }));
+    ADSL_CHECK(rejects([](adsl::snapshot_header& h) { h.node_offset += 1; }));
+    ADSL_CHECK(rejects([](adsl::snapshot_header& h) { h.node_offset = ~std::uint64_t{0} - 7; }));
+    ADSL_CHECK(rejects([](adsl::snapshot_header& h) { h.node_offset += adsl::impl::snapshot_alignment; }));
+    ADSL_CHECK(rejects([](adsl::snapshot_header& h) { ++h.height; }));
+
+    // the lazy array of a lazy_segtree is checked the same way
+    using lazy = adsl::lazy_segtree<scale_affine_action, adsl::mmap_container>;
+    std::vector<affine> affines(100);
+    ADSL_CHECK(adsl::save_snapshot(adsl::lazy_segtree<scale_affine_action>(affines), good));
+    ADSL_CHECK(adsl::open_snapshot<lazy>(good, false).has_value());
+
+    auto rejects_lazy = [&](auto f) {
+        corrupt_header(good, bad, f);
+        return !adsl::open_snapshot<lazy>(bad, false);
+    };
+
+    ADSL_CHECK(rejects_lazy([](adsl::snapshot_header& h) { ++h.lazy_count; }));
+    ADSL_CHECK(rejects_lazy([](adsl::snapshot_header& h) { h.lazy_offset += 1; }));
+    ADSL_CHECK(rejects_lazy([](adsl::snapshot_header& h) { h.lazy_offset = ~std::uint64_t{0} - 7; }));
+    ADSL_CHECK(rejects_lazy([](adsl::snapshot_header& h) { h.operator_size = 4; }));
+}
+
+int main() {
+    std::mt19937_64 rng(0);
+
+    const fs::path dir = fs::temp_directory_path() / ("adsl_test_snapshot_" + std::to_string(::getpid()));
+    fs::create_directories(dir);
+
+    check_segtree<adsl::binary_heap_layout>(dir, rng);
+    check_segtree<adsl::compact_heap_layout>(dir, rng);
+    check_lazy_segtree(dir, rng);
+    check_dual_segtree(dir, rng);
+    check_fenwick_tree(dir, rng);
+    std::cout << "round trip: ok\n";
+
+    check_read_only(dir);
+    std::cout << "read-only: ok\n";
+
+    check_rejected(dir);
+    std::cout << "rejected: ok\n";
+
+    fs::remove_all(dir);
+}
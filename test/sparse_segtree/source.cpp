@@ -0,0 +1,102 @@
+// checks sparse_segtree against a std::map of the written keys, on key spaces from a single key to every 64-bit key
+// but the largest, writing the edge keys 0 and size - 1 as well as random ones
+
+#include <iostream>
+#include <map>
+#include <vector>
+#include <limits>
+#include <algorithm>
+#include <utility>
+#include <random>
+
+#include "adsl/segtree/sparse_segtree.hpp"
+#include "../common.hpp"
+
+using namespace adsl_test;
+
+constexpr std::size_t queries_per_size = 2000;
+
+affine fold(const std::map<u64, affine>& model, u64 l, u64 r) {
+    affine res = affine_monoid::unit();
+    for (auto it = model.lower_bound(l); it != model.end() && it->first < r; ++it)
+        res = affine_monoid::op(res, it->second);
+
+    return res;
+}
+
+void check(u64 size, std::mt19937_64& rng) {
+    adsl::sparse_segtree<affine_monoid> seg(size);
+    std::map<u64, affine> model;
+
+    // a few keys near the edges and near each other, so that ranges often hold several of them
+    std::vector<u64> keys = { 0, size - 1, size / 2 };
+    for (std::size_t k = 0; k < 16; ++k)
+        keys.push_back(rng() % size);
+    for (std::size_t k = 0; k < 16; ++k)
+        keys.push_back(std::min(size - 1, keys[rng() % keys.size()] + rng() % 4));
+
+    auto random_key = [&]() {
+        return (rng() % 4 == 0 ? rng() % size : keys[rng() % keys.size()]);
+    };
+
+    for (std::size_t q = 0; q < queries_per_size; ++q) {
+        switch (rng() % 3) {
+            case 0: {
+                const u64 key = random_key();
+                const affine f = random_affine(rng);
+                seg.update(key, [&f](const affine& x) { return affine_monoid::op(x, f); });
+
+                auto [it, inserted] = model.try_emplace(key);
+                it->second = affine_monoid::op(it->second, f);
+                break;
+            }
+            case 1: {
+                const u64 key = random_key();
+                const affine f = random_affine(rng);
+                seg.set(key, f);
+                model[key] = f;
+                break;
+            }
+            default: {
+                u64 l = random_key(), r = random_key();
+                if (l > r)
+                    std::swap(l, r);
+
+                if (l == r || rng() % 2 == 0)
+                    ++r;
+
+                ADSL_CHECK(seg.accumulate(l, r) == fold(model, l, r));
+                break;
+            }
+        }
+    }
+
+    ADSL_CHECK(seg.accumulate(0, size) == fold(model, 0, size));
+    ADSL_CHECK(!seg.accumulate(size, size));
+    ADSL_CHECK(!seg.accumulate(0, 0));
+
+    // writes out of range are ignored
+    if (size != std::numeric_limits<u64>::max()) {
+        const std::size_t nodes = seg.node_count();
+        seg.set(size, affine{ 2, 3 });
+        ADSL_CHECK(seg.node_count() == nodes);
+    }
+}
+
+int main() {
+    std::mt19937_64 rng(0);
+
+    for (u64 size = 1; size <= 64; ++size)
+        check(size, rng);
+
+    for (unsigned bits = 7; bits < 64; bits += 7)
+        check((u64{1} << bits) + rng() % 1000, rng);
+
+    check(std::numeric_limits<u64>::max() / 3, rng);
+    check(std::numeric_limits<u64>::max(), rng);
+
+    adsl::sparse_segtree<affine_monoid> empty(0);
+    ADSL_CHECK(empty.is_empty() && !empty.accumulate(0, 1));
+
+    std::cout << "sparse_segtree: ok\n";
+}
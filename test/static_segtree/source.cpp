@@ -0,0 +1,133 @@
+// checks static_segtree at compile time, building, updating and querying trees in constant expressions,
+// and at run time against a plain array for sizes that are and are not powers of two, through both the checked
+// operations and the *_unchecked ones, with a monoid that is not commutative
+
+#include <iostream>
+#include <vector>
+#include <array>
+#include <algorithm>
+#include <optional>
+#include <utility>
+#include <random>
+
+#include "adsl/segtree/static_segtree.hpp"
+#include "../common.hpp"
+
+using namespace adsl_test;
+
+constexpr std::size_t queries_per_size = 2000;
+
+using int_monoid = adsl::default_monoid<int>;
+
+// the squares 1, 4, 9, ..., N^2
+template <std::size_t N>
+constexpr std::array<int, N> squares() {
+    std::array<int, N> res{};
+    for (std::size_t i = 0; i < N; ++i)
+        res[i] = static_cast<int>((i + 1) * (i + 1));
+
+    return res;
+}
+
+constexpr adsl::static_segtree<int_monoid, 7> squares_7(squares<7>());
+
+static_assert(squares_7.accumulate_all() == 140);
+static_assert(squares_7.accumulate(0, 7) == 140);
+static_assert(squares_7.accumulate(2, 5) == 9 + 16 + 25);
+static_assert(squares_7.accumulate_unchecked(6, 7) == 49);
+static_assert(squares_7.leaves()[3] == 16);
+static_assert(!squares_7.accumulate(3, 3));
+static_assert(!squares_7.accumulate(0, 8));
+static_assert(!squares_7.accumulate(7, 8));
+
+// a tree changed and queried within one constant expression
+constexpr int updated_sum() {
+    adsl::static_segtree<int_monoid, 7> seg(squares<7>());
+    seg.set(0, 100);
+    seg.update(6, [](int x) { return x * 2; });
+    seg.set_unchecked(3, 0);
+    seg.update_unchecked(1, [](int x) { return x - 4; });
+
+    // ignored
+    seg.set(7, 1000);
+    seg.update(100, [](int) { return 1000; });
+
+    return *seg.accumulate(0, 7) * 1000 + seg.accumulate_unchecked(3, 7);
+}
+
+static_assert(updated_sum() == (100 + 0 + 9 + 0 + 25 + 36 + 98) * 1000 + (0 + 25 + 36 + 98));
+
+// a one-value tree has no inner level to unroll
+constexpr adsl::static_segtree<int_monoid, 1> single(std::array<int, 1>{ 42 });
+
+static_assert(single.accumulate_all() == 42 && single.accumulate(0, 1) == 42 && !single.accumulate(0, 2));
+
+// a default-built tree holds units
+static_assert(adsl::static_segtree<int_monoid, 5>().accumulate_all() == 0);
+
+template <std::size_t N>
+void check(std::mt19937_64& rng) {
+    std::array<affine, N> initial;
+    for (auto&& e : initial)
+        e = random_affine(rng);
+
+    adsl::static_segtree<affine_monoid, N> seg(initial);
+    std::vector<affine> model(initial.begin(), initial.end());
+
+    for (std::size_t q = 0; q < queries_per_size; ++q) {
+        std::size_t l = rng() % (N + 1), r = rng() % (N + 1);
+        if (rng() % 8 != 0 && l > r)
+            std::swap(l, r);
+
+        const affine f = random_affine(rng);
+        const bool valid = l < r;
+
+        switch (rng() % 6) {
+            case 0:
+                seg.set(l, f);
+                if (l < N)
+                    model[l] = f;
+                break;
+            case 1:
+                seg.update(l, [&f](const affine& x) { return affine_monoid::op(x, f); });
+                if (l < N)
+                    model[l] = affine_monoid::op(model[l], f);
+                break;
+            case 2:
+                if (l < N) {
+                    seg.set_unchecked(l, f);
+                    model[l] = f;
+                }
+                break;
+            case 3:
+                if (l < N) {
+                    seg.update_unchecked(l, [&f](const affine& x) { return affine_monoid::op(f, x); });
+                    model[l] = affine_monoid::op(f, model[l]);
+                }
+                break;
+            case 4:
+                ADSL_CHECK(seg.accumulate(l, r) == (valid ? std::optional(fold(model, l, r)) : std::nullopt));
+                break;
+            default:
+                if (valid)
+                    ADSL_CHECK(seg.accumulate_unchecked(l, r) == fold(model, l, r));
+                break;
+        }
+    }
+
+    ADSL_CHECK(seg.accumulate_all() == fold(model, 0, N));
+    ADSL_CHECK(std::ranges::equal(seg.leaves(), model));
+
+    std::cout << "N = " << N << ": ok\n";
+}
+
+int main() {
+    std::mt19937_64 rng(0);
+
+    check<1>(rng);
+    check<2>(rng);
+    check<7>(rng);
+    check<64>(rng);
+    check<100>(rng);
+    check<129>(rng);
+}
@@ -0,0 +1,172 @@
+// checks counting_stats against counts worked out by hand for a few operations on small lazy_segtree, dual_segtree
+// and fenwick_tree: every counter after each operation, max_propagations taken per operation rather than summed,
+// rejected calls counting nothing and reset_stats clearing it all; and that null_stats takes no space in the trees
+
+#include <iostream>
+#include <vector>
+#include <cstddef>
+#include <optional>
+#include <utility>
+
+#include "adsl/segtree/lazy_segtree.hpp"
+#include "adsl/segtree/dual_segtree.hpp"
+#include "adsl/segtree/fenwick_tree.hpp"
+#include "adsl/segtree/layout.hpp"
+#include "adsl/utility/stats.hpp"
+#include "../common.hpp"
+
+using namespace adsl_test;
+
+using sum_group = adsl::default_group<i64>;
+
+using counted_lazy_segtree = adsl::lazy_segtree<scale_affine_action, std::vector, adsl::binary_heap_layout, adsl::counting_stats>;
+using counted_dual_segtree = adsl::dual_segtree<affine_monoid, std::vector<affine>, adsl::binary_heap_layout, adsl::counting_stats>;
+using counted_commutative_dual_segtree = adsl::dual_segtree<sum_group, std::vector<i64>, adsl::binary_heap_layout, adsl::counting_stats>;
+using counted_fenwick_tree = adsl::fenwick_tree<sum_group, std::vector<i64>, adsl::counting_stats>;
+
+// the members of each tree but its statistics
+struct lazy_segtree_members {
+    std::vector<u64> lazy;
+    std::vector<affine> node;
+    adsl::binary_heap_layout layout;
+    std::size_t actual_size;
+};
+
+struct dual_segtree_members {
+    std::vector<affine> node;
+    adsl::binary_heap_layout layout;
+    std::size_t actual_size;
+};
+
+struct fenwick_tree_members {
+    std::vector<i64> node;
+    std::size_t actual_size;
+};
+
+static_assert(sizeof(adsl::lazy_segtree<scale_affine_action>) == sizeof(lazy_segtree_members));
+static_assert(sizeof(adsl::dual_segtree<affine_monoid>) == sizeof(dual_segtree_members));
+static_assert(sizeof(adsl::fenwick_tree<sum_group>) == sizeof(fenwick_tree_members));
+
+static_assert(sizeof(counted_lazy_segtree) > sizeof(adsl::lazy_segtree<scale_affine_action>));
+static_assert(sizeof(counted_fenwick_tree) > sizeof(adsl::fenwick_tree<sum_group>));
+
+bool operator==(const adsl::tree_stats& x, const adsl::tree_stats& y) {
+    return x.operations == y.operations && x.ops == y.ops && x.acts == y.acts && x.compositions == y.compositions &&
+        x.node_reads == y.node_reads && x.node_writes == y.node_writes &&
+        x.propagations == y.propagations && x.max_propagations == y.max_propagations;
+}
+
+// the counts below are for 4 leaves at heap indices 4..7 under the inner nodes 1..3
+void check_lazy_segtree() {
+    const std::vector<affine> model = { { 1, 2 }, { 3, 4 }, { 5, 6 }, { 7, 8 } };
+    counted_lazy_segtree seg(model);
+    ADSL_CHECK(seg.stats() == adsl::tree_stats{});
+
+    // the tags on both paths are units and push nothing; the root takes the tag, and nodes 2, 1, 3, 1 are pulled
+    seg.append(0, 4, 3);
+    ADSL_CHECK(seg.stats() == adsl::tree_stats{ .operations = 1, .ops = 4, .acts = 5, .compositions = 1, .node_reads = 9, .node_writes = 5 });
+
+    // node 1 hands its tag to 2 and 3, node 2 hands it to the leaves 4 and 5, then leaf 5 is read
+    ADSL_CHECK(seg.accumulate(1, 2) == scale_affine_action::act(3, model[1]));
+    ADSL_CHECK(seg.stats() == adsl::tree_stats{ .operations = 2, .ops = 6, .acts = 9, .compositions = 3, .node_reads = 14, .node_writes = 9,
+        .propagations = 2, .max_propagations = 2 });
+
+    // node 3 hands its tag to the leaves 6 and 7, leaf 7 is written, and nodes 3 and 1 are pulled
+    seg.set(3, { 9, 10 });
+    ADSL_CHECK(seg.stats() == adsl::tree_stats{ .operations = 3, .ops = 8, .acts = 11, .compositions = 3, .node_reads = 21, .node_writes = 14,
+        .propagations = 3, .max_propagations = 2 });
+
+    // rejected calls count nothing
+    seg.append(2, 2, 5);
+    seg.set(4, { 1, 1 });
+    ADSL_CHECK(!seg.accumulate(1, 5));
+    ADSL_CHECK(seg.stats().operations == 3);
+
+    seg.reset_stats();
+    ADSL_CHECK(seg.stats() == adsl::tree_stats{});
+
+    // no tag is left, so only the root is read
+    ADSL_CHECK(seg.accumulate(0, 4) == affine_monoid::op(affine_monoid::op(scale_affine_action::act(3, model[0]), scale_affine_action::act(3, model[1])),
+        affine_monoid::op(scale_affine_action::act(3, model[2]), affine{ 9, 10 })));
+    ADSL_CHECK(seg.stats() == adsl::tree_stats{ .operations = 1, .ops = 2, .node_reads = 1 });
+
+    std::cout << "lazy_segtree: ok\n";
+}
+
+void check_dual_segtree() {
+    counted_dual_segtree seg(4);
+    const affine f = { 2, 3 };
+
+    // not commutative: nodes 1, 2, 1, 3 hand their tags down, whether units or not, before the root takes f
+    seg.append(0, 4, f);
+    ADSL_CHECK(seg.stats() == adsl::tree_stats{ .operations = 1, .ops = 9, .node_reads = 13, .node_writes = 13,
+        .propagations = 4, .max_propagations = 4 });
+
+    // leaf 5 folded with nodes 2 and 1
+    ADSL_CHECK(seg.calc(1) == f);
+    ADSL_CHECK(seg.stats() == adsl::tree_stats{ .operations = 2, .ops = 11, .node_reads = 16, .node_writes = 13,
+        .propagations = 4, .max_propagations = 4 });
+
+    // the 3 inner nodes folded top-down, then the 4 leaves
+    ADSL_CHECK(seg.calc_all() == std::vector<affine>(4, f));
+    ADSL_CHECK(seg.stats() == adsl::tree_stats{ .operations = 3, .ops = 18, .node_reads = 23, .node_writes = 13,
+        .propagations = 4, .max_propagations = 4 });
+
+    // a single leaf has nodes 1 and 3 handed down once for each end, then is written
+    seg.reset_stats();
+    seg.append(2, 3, f);
+    ADSL_CHECK(seg.stats() == adsl::tree_stats{ .operations = 1, .ops = 9, .node_reads = 13, .node_writes = 13,
+        .propagations = 4, .max_propagations = 4 });
+
+    seg.append(3, 3, f);
+    ADSL_CHECK(!seg.calc(4));
+    ADSL_CHECK(seg.stats().operations == 1);
+
+    // commutative: nothing is handed down
+    counted_commutative_dual_segtree sum(4);
+    sum.append(0, 4, 5);
+    ADSL_CHECK(sum.stats() == adsl::tree_stats{ .operations = 1, .ops = 1, .node_reads = 1, .node_writes = 1 });
+
+    std::cout << "dual_segtree: ok\n";
+}
+
+// the counts below are for 5 values, so 8 nodes
+void check_fenwick_tree() {
+    counted_fenwick_tree fw(5);
+
+    // nodes 3, 4, 8
+    fw.append_at(2, 7);
+    ADSL_CHECK(fw.stats() == adsl::tree_stats{ .operations = 1, .ops = 3, .node_reads = 3, .node_writes = 3 });
+
+    // nodes 5, 4
+    ADSL_CHECK(fw.accumulate(4) == 7);
+    ADSL_CHECK(fw.stats() == adsl::tree_stats{ .operations = 2, .ops = 5, .node_reads = 5, .node_writes = 3 });
+
+    // node 4 less node 1
+    ADSL_CHECK(fw.accumulate(1, 4) == 7);
+    ADSL_CHECK(fw.stats() == adsl::tree_stats{ .operations = 3, .ops = 8, .node_reads = 7, .node_writes = 3 });
+
+    // the value is read as the prefixes over nodes 5, 4 and node 4, then nodes 5, 6, 8 take the difference
+    fw.set(4, 10);
+    ADSL_CHECK(fw.stats() == adsl::tree_stats{ .operations = 4, .ops = 16, .node_reads = 13, .node_writes = 6 });
+
+    fw.append_at(5, 1);
+    ADSL_CHECK(!fw.accumulate(5));
+    ADSL_CHECK(!fw.accumulate(3, 3));
+    ADSL_CHECK(fw.stats().operations == 4);
+
+    // 2 valid increments of 3 reach the dense pass, which writes all 8 nodes and carries 7 of them to their parents
+    fw.reset_stats();
+    const std::vector<std::pair<std::size_t, i64>> batch = { { 0, 1 }, { 9, 1 }, { 0, 2 } };
+    fw.append_at_batch(batch);
+    ADSL_CHECK(fw.stats() == adsl::tree_stats{ .operations = 2, .ops = 17, .node_reads = 8, .node_writes = 8 });
+    ADSL_CHECK(fw.accumulate(4) == 20);
+
+    std::cout << "fenwick_tree: ok\n";
+}
+
+int main() {
+    check_lazy_segtree();
+    check_dual_segtree();
+    check_fenwick_tree();
+}
@@ -0,0 +1,207 @@
+// checks segtree_2d, fenwick_tree_2d and offline_fenwick_tree_2d against a plain grid or point list,
+// on every shape up to 9 x 9 including the empty ones
+
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <limits>
+#include <optional>
+#include <utility>
+#include <random>
+
+#include "adsl/segtree/segtree_2d.hpp"
+#include "adsl/segtree/fenwick_tree_2d.hpp"
+#include "../common.hpp"
+
+using namespace adsl_test;
+
+constexpr std::size_t max_side = 9;
+constexpr std::size_t queries_per_shape = 300;
+
+using min_monoid = adsl::make_monoid<i64, std::numeric_limits<i64>::max(), [](i64 x, i64 y) { return std::min(x, y); }, true>;
+using sum_group = adsl::default_group<i64>;
+
+struct rectangle {
+    std::size_t r1, c1, r2, c2;
+};
+
+// a rectangle within rows x cols, empty or out of range one time in eight
+rectangle random_rectangle(std::mt19937_64& rng, std::size_t rows, std::size_t cols) {
+    std::size_t r1 = rng() % (rows + 1), r2 = rng() % (rows + 1);
+    std::size_t c1 = rng() % (cols + 1), c2 = rng() % (cols + 1);
+    if (rng() % 8 != 0) {
+        if (r1 > r2)
+            std::swap(r1, r2);
+        if (c1 > c2)
+            std::swap(c1, c2);
+    }
+
+    return { r1, c1, r2, c2 };
+}
+
+template <typename M>
+std::optional<i64> brute_fold(const std::vector<i64>& grid, std::size_t cols, const rectangle& q) {
+    if (q.r1 >= q.r2 || q.c1 >= q.c2)
+        return std::nullopt;
+
+    i64 res = M::unit();
+    for (std::size_t i = q.r1; i < q.r2; ++i)
+        for (std::size_t j = q.c1; j < q.c2; ++j)
+            res = M::op(res, grid[i * cols + j]);
+
+    return res;
+}
+
+void check_segtree_2d(std::mt19937_64& rng) {
+    for (std::size_t rows = 0; rows <= max_side; ++rows) {
+        for (std::size_t cols = 0; cols <= max_side; ++cols) {
+            std::vector<i64> grid(rows * cols);
+            for (auto&& e : grid)
+                e = static_cast<i64>(rng() % 1000);
+
+            adsl::segtree_2d<min_monoid> seg(rows, cols, grid);
+            ADSL_CHECK(seg.is_empty() == grid.empty());
+
+            for (std::size_t q = 0; q < queries_per_shape; ++q) {
+                const std::size_t r = rng() % (rows + 1), c = rng() % (cols + 1);
+                const i64 v = static_cast<i64>(rng() % 1000);
+
+                switch (rng() % 3) {
+                    case 0:
+                        seg.set(r, c, v);
+                        if (r < rows && c < cols)
+                            grid[r * cols + c] = v;
+                        break;
+                    case 1:
+                        seg.update(r, c, [v](i64 x) { return x - v; });
+                        if (r < rows && c < cols)
+                            grid[r * cols + c] -= v;
+                        break;
+                    default: {
+                        const rectangle rect = random_rectangle(rng, rows, cols);
+                        ADSL_CHECK(seg.accumulate(rect.r1, rect.c1, rect.r2, rect.c2) == brute_fold<min_monoid>(grid, cols, rect));
+                        break;
+                    }
+                }
+            }
+        }
+    }
+
+    std::cout << "segtree_2d: ok\n";
+}
+
+void check_fenwick_tree_2d(std::mt19937_64& rng) {
+    for (std::size_t rows = 0; rows <= max_side; ++rows) {
+        for (std::size_t cols = 0; cols <= max_side; ++cols) {
+            std::vector<i64> grid(rows * cols);
+            for (auto&& e : grid)
+                e = static_cast<i64>(rng() % 1000);
+
+            adsl::fenwick_tree_2d<sum_group> fw(rows, cols, grid);
+            ADSL_CHECK(fw.is_empty() == grid.empty());
+
+            for (std::size_t q = 0; q < queries_per_shape; ++q) {
+                const std::size_t r = rng() % (rows + 1), c = rng() % (cols + 1);
+                const i64 v = static_cast<i64>(rng() % 1000);
+                const bool valid = r < rows && c < cols;
+
+                switch (rng() % 6) {
+                    case 0:
+                        fw.append_at(r, c, v);
+                        if (valid)
+                            grid[r * cols + c] += v;
+                        break;
+                    case 1:
+                        fw.set(r, c, v);
+                        if (valid)
+                            grid[r * cols + c] = v;
+                        break;
+                    case 2:
+                        fw.update(r, c, [v](i64 x) { return x * 2 - v; });
+                        if (valid)
+                            grid[r * cols + c] = grid[r * cols + c] * 2 - v;
+                        break;
+                    case 3:
+                        ADSL_CHECK(fw.calc(r, c) == (valid ? std::optional(grid[r * cols + c]) : std::nullopt));
+                        break;
+                    case 4:
+                        ADSL_CHECK(fw.accumulate(r, c) == (valid ? brute_fold<sum_group>(grid, cols, { 0, 0, r + 1, c + 1 }) : std::nullopt));
+                        break;
+                    default: {
+                        const rectangle rect = random_rectangle(rng, rows, cols);
+                        ADSL_CHECK(fw.accumulate(rect.r1, rect.c1, rect.r2, rect.c2) == brute_fold<sum_group>(grid, cols, rect));
+                        break;
+                    }
+                }
+            }
+        }
+    }
+
+    std::cout << "fenwick_tree_2d: ok\n";
+}
+
+void check_offline_fenwick_tree_2d(std::mt19937_64& rng) {
+    auto random_key = [&rng]() { return static_cast<i64>(rng() % 41) - 20; };
+
+    for (std::size_t p : { 0, 1, 2, 5, 30, 200 }) {
+        // duplicates are allowed, and each copy of a point adds to the same cell
+        std::vector<std::pair<i64, i64>> points(p);
+        for (auto&& [x, y] : points) {
+            x = random_key();
+            y = random_key();
+        }
+
+        adsl::offline_fenwick_tree_2d<sum_group> fw(points);
+        std::vector<i64> values(p);
+
+        auto brute = [&](i64 x1, i64 y1, i64 x2, i64 y2) {
+            i64 res = 0;
+            for (std::size_t k = 0; k < p; ++k) {
+                if (x1 <= points[k].first && points[k].first < x2 && y1 <= points[k].second && points[k].second < y2)
+                    res += values[k];
+            }
+
+            return res;
+        };
+
+        for (std::size_t q = 0; q < 20 * queries_per_shape; ++q) {
+            switch (rng() % 3) {
+                case 0: {
+                    if (p == 0)
+                        break;
+
+                    // every copy of the point holds the sum of the increments, so charge one copy only
+                    const std::size_t k = rng() % p;
+                    const i64 v = static_cast<i64>(rng() % 1000);
+                    fw.append_at(points[k].first, points[k].second, v);
+                    values[std::ranges::find(points, points[k]) - points.begin()] += v;
+                    break;
+                }
+                case 1: {
+                    const i64 x = random_key(), y = random_key();
+                    ADSL_CHECK(fw.accumulate(x, y) == brute(std::numeric_limits<i64>::min(), std::numeric_limits<i64>::min(), x, y));
+                    break;
+                }
+                default: {
+                    const i64 x1 = random_key(), y1 = random_key(), x2 = random_key(), y2 = random_key();
+                    const auto res = fw.accumulate(x1, y1, x2, y2);
+                    if (x1 < x2 && y1 < y2)
+                        ADSL_CHECK(res == brute(x1, y1, x2, y2));
+                    else
+                        ADSL_CHECK(!res);
+                    break;
+                }
+            }
+        }
+    }
+
+    std::cout << "offline_fenwick_tree_2d: ok\n";
+}
+
+int main() {
+    std::mt19937_64 rng(0);
+
+    check_segtree_2d(rng);
+    check_fenwick_tree_2d(rng);
+    check_offline_fenwick_tree_2d(rng);
+}